@@ -6,22 +6,75 @@ typedef struct {
     int x, y;
 } Position;
 
+typedef struct {
+    int t;
+    Position pos;
+} Keyframe;
+
 typedef struct {
     int t_start, t_end;
     Position pos0, pos1;
     int rows, cols;
-    char ***rotations;      // rotaciones[ángulo][fila][columna]
-    int num_rotations;      // ← AGREGAR ESTA LÍNEA
+    // Las rotaciones viven en el atlas de Scene (scene_figure_rotation)
+    Keyframe *path;         // trayectoria con varios keyframes (NULL = pos0 → pos1)
+    int num_keyframes;
+    int attr;               // color y estilo de sus celdas (ATTR_* en frame_encoder.h); 0 = sin color
 } Figure;
 
 typedef struct {
     int width, height;
 } Canvas;
 
+/*
+ * Cámara sobre el mundo: muestra el rectángulo width x height del mundo
+ * con esquina en el origen del tick (pan interpolado, o x, y fijos) en la
+ * región del canvas con esquina en (screen_x, screen_y).
+ */
+typedef struct {
+    int screen_x, screen_y;
+    int width, height;
+    int x, y;                       // origen sin "pan"
+    int pan_start, pan_count;       // keyframes en AnimationConfig.pan_keys, en orden de t
+} Viewport;
+
+// Partición del canvas en una rejilla de displays, cada uno en su proceso
+typedef struct {
+    int rows, cols;                 // 0 = sin displays (todo a stdout)
+    char sink[256];                 // destino de cada display; "%d" = número de display
+    int transport;                  // DisplayTransport: pipe o anillo en memoria compartida (display.h)
+    int present_sync;               // presentar todos el mismo frame (solo con el anillo)
+    int sync_timeout_ms;            // espera máxima por un display atrasado
+    int slow_id, slow_delay_ms;     // display lento simulado para pruebas (-1 = ninguno)
+} DisplayLayout;
+
+struct Trajectory;
+struct Scene;
+struct HotReload;
+
 typedef struct {
     int num_figures;
-    Canvas canvas;
+    Canvas canvas;                  // lo que se presenta (pantalla)
+    Canvas world;                   // espacio de las figuras; sin "world" es el canvas
+    Viewport *viewports;            // 0 = una sola cámara fija sobre todo el canvas (viewport.h)
+    int num_viewports;
+    Keyframe *pan_keys;
+    int num_pan_keys;
+    int fps;                        // frames por segundo (0 = sin límite)
+    int frame_policy;               // FramePolicy cuando se va atrasado (frame_clock.h)
+    int loops;                      // veces que se reproduce la animación
+    int workers;                    // animator_mt: hilos con reparto por costo (0 = uno por figura)
+    int collisions;                 // CollisionResponse: política de choques (collision.h); 0 = sin detección
+    long frame_cache_bytes;         // presupuesto del caché de frames (0 = sin caché, FRAME_CACHE_AUTO)
+    int frame_cache_compress;
+    unsigned long long hash;        // hash del archivo: clave del caché de frames
+    int sink_policy;                // SinkPolicy de las colas por destino (sink_queue.h)
+    int sink_capacity;              // frames por cola
+    DisplayLayout displays;
     Figure *figures;
+    struct Trajectory *trajectory;  // precalculada en load_config (trajectory.h)
+    struct Scene *scene;            // vista SoA + atlas de glifos (scene.h)
+    struct SceneFile *file;         // escena compilada mapeada (scene_file.h); NULL = leída del JSON
+    struct HotReload *reload;       // recarga en caliente (hot_reload.h); NULL = apagada
 } AnimationConfig;
 
 #endif // ANIM_CONFIG_H
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "frame_encoder.h"
+#include "recording.h"
+#include "render.h"
+
+/*
+ * Reproduce una animación grabada mapeándola en memoria.
+ * Uso: anim_play archivo.mdar [fps]   (fps 0 = lo más rápido posible)
+ *
+ * Con --seek=T reproduce una escena (config.json o .mdscene) desde el
+ * tick T sin pasar por los anteriores: el primer frame sale del buscador
+ * de frames (render.h) como repintada completa y los siguientes van como
+ * delta. --accumulate conserva lo pintado antes, como el motor mt.
+ * Uso: anim_play escena.json --seek=T [--accumulate] [fps]
+ */
+
+static void report(unsigned frames, long long written, double secs) {
+    fprintf(stderr, "\n[PLAY] %u frames, %lld bytes en %.3f s: %.0f frames/s, %.1f MB/s\n",
+            frames, written, secs, secs > 0 ? frames / secs : 0.0,
+            secs > 0 ? written / secs / (1024.0 * 1024.0) : 0.0);
+}
+
+static int play_scene(const char *path, int start, RenderMode mode, int fps) {
+    AnimationConfig *config = load_config(path);
+    if (!config) {
+        fprintf(stderr, "Error cargando la configuración\n");
+        return 1;
+    }
+    FrameSeeker seeker;
+    if (frame_seeker_init(&seeker, config, mode, 0) != 0) {
+        fprintf(stderr, "No se pudo preparar el acceso aleatorio a %s\n", path);
+        free_config(config);
+        return 1;
+    }
+
+    int width = config->canvas.width, height = config->canvas.height;
+    size_t cells = (size_t)width * height;
+    int colored = config->scene->colored;
+    char *prev = malloc(cells), *cur = malloc(cells);
+    unsigned char *prev_attrs = colored ? malloc(cells) : NULL;
+    unsigned char *cur_attrs = colored ? malloc(cells) : NULL;
+    ByteBuffer enc;
+    bytebuf_init(&enc);
+    int ok = prev && cur && (!colored || (prev_attrs && cur_attrs));
+
+    if (start < 0) start = 0;
+    if (start > seeker.max_time) start = seeker.max_time;
+    if (fps < 0) fps = config->fps > 0 ? config->fps : 0;
+    FrameClock clock;
+    frame_clock_init(&clock, fps, FRAME_POLICY_CATCH_UP);
+
+    long long begin = frame_clock_now_ns(), written = 0;
+    unsigned frames = 0;
+    for (int t = start; ok && t <= seeker.max_time; t++) {
+        if (t > start) frame_clock_wait_for(&clock, t - start);
+        bytebuf_reset(&enc);
+        if (t == start) {
+            frame_seeker_render(&seeker, t, cur, cur_attrs);
+            ok = encode_full_frame_attr(cur, cur_attrs, width, height, &enc) == 0;
+        } else {
+            // Después del salto se sigue en orden: acumular es pintar sobre el frame anterior
+            if (mode == RENDER_CLEAR) {
+                render_frame(config, t, cur, cur_attrs);
+            } else {
+                memcpy(cur, prev, cells);
+                if (cur_attrs) memcpy(cur_attrs, prev_attrs, cells);
+                render_paint(config, t, cur, cur_attrs);
+            }
+            ok = encode_delta_frame_attr(prev, prev_attrs, cur, cur_attrs, width, height, &enc) == 0;
+        }
+        ok = ok && fwrite(enc.data, 1, enc.len, stdout) == enc.len;
+        written += enc.len;
+        frames++;
+
+        char *tmp = prev;
+        prev = cur;
+        cur = tmp;
+        unsigned char *tmp_attrs = prev_attrs;
+        prev_attrs = cur_attrs;
+        cur_attrs = tmp_attrs;
+    }
+    ok = fflush(stdout) == 0 && ok;
+    if (ok) report(frames, written, (frame_clock_now_ns() - begin) / 1e9);
+    else fprintf(stderr, "Error reproduciendo %s\n", path);
+
+    free(prev);
+    free(cur);
+    free(prev_attrs);
+    free(cur_attrs);
+    bytebuf_free(&enc);
+    frame_seeker_free(&seeker);
+    free_config(config);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    int fps = -1, seek = -1;
+    RenderMode mode = RENDER_CLEAR;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seek=", 7) == 0) seek = atoi(argv[i] + 7);
+        else if (strcmp(argv[i], "--accumulate") == 0) mode = RENDER_ACCUMULATE;
+        else if (!path) path = argv[i];
+        else fps = atoi(argv[i]);
+    }
+    if (!path) {
+        fprintf(stderr, "Uso: %s archivo.mdar [fps]\n"
+                        "     %s escena.json --seek=T [--accumulate] [fps]\n", argv[0], argv[0]);
+        return 1;
+    }
+    if (seek >= 0) return play_scene(path, seek, mode, fps);
+
+    Recording rec;
+    if (recording_open(&rec, path) != 0) return 1;
+
+    long long start = frame_clock_now_ns();
+    long long written = recording_play(&rec, STDOUT_FILENO, fps);
+    double secs = (frame_clock_now_ns() - start) / 1e9;
+    if (written < 0) {
+        perror("write");
+        recording_close(&rec);
+        return 1;
+    }
+
+    report(rec.header->num_frames, written, secs);
+    recording_close(&rec);
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "config_parser.h"
+#include "recording.h"
+
+/*
+ * Convierte una configuración JSON en una animación grabada (.mdar).
+ * Uso: anim_record [config.json] [salida.mdar] [intervalo_keyframes]
+ */
+int main(int argc, char **argv) {
+    const char *input = argc > 1 ? argv[1] : "config.json";
+    const char *output = argc > 2 ? argv[2] : "animation.mdar";
+    int interval = argc > 3 ? atoi(argv[3]) : RECORDING_DEFAULT_KEYFRAME_INTERVAL;
+
+    AnimationConfig *config = load_config(input);
+    if (!config) {
+        fprintf(stderr, "Error cargando la configuración\n");
+        return 1;
+    }
+
+    RecordingHeader h;
+    if (recording_write(config, output, interval, &h) != 0) {
+        free_config(config);
+        return 1;
+    }
+    free_config(config);
+
+    printf("Grabación: %s\n", output);
+    printf("Frames: %u (%u x %u, keyframe cada %u)\n", h.num_frames, h.width, h.height, h.keyframe_interval);
+    printf("Repintada completa: %llu bytes\n", (unsigned long long)h.raw_bytes);
+    printf("Frames grabados: %llu bytes (compresión %.2fx)\n", (unsigned long long)h.data_bytes,
+           h.data_bytes ? (double)h.raw_bytes / h.data_bytes : 0.0);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include "anim_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frame_clock.h"
+
+int anim_stats_on = 0;
+
+typedef struct {
+    long long value[STATS_NUM_COUNTERS];
+    int touched;             // 1 si el frame se dibujó (los saltados no se vuelcan)
+} FrameRecord;
+
+static struct {
+    char dump_path[256];
+    FrameRecord *frames;
+    int capacity;
+    int current;             // frame en curso de los motores de un hilo
+
+    // Ventana del resumen móvil
+    long long window_start_ns;
+    long long window_sum[STATS_NUM_COUNTERS];
+    int window_frames;
+    int last_done;           // frame más alto terminado
+} stats = {.current = -1, .last_done = -1};
+
+static const char *counter_names[STATS_NUM_COUNTERS] = {
+    "interp_ns", "raster_ns", "encode_ns", "write_ns", "lock_wait_ns",
+    "cells_painted", "cells_changed", "bytes", "sgr_bytes", "active_figures"
+};
+
+const char *anim_stats_counter_name(StatsCounter c) {
+    return counter_names[c];
+}
+
+static int grow(int frames) {
+    if (frames <= stats.capacity) return 0;
+    int cap = stats.capacity > 0 ? stats.capacity : 1024;
+    while (cap < frames) cap *= 2;
+    FrameRecord *grown = realloc(stats.frames, sizeof(FrameRecord) * cap);
+    if (!grown) return -1;
+    memset(grown + stats.capacity, 0, sizeof(FrameRecord) * (cap - stats.capacity));
+    stats.frames = grown;
+    stats.capacity = cap;
+    return 0;
+}
+
+void anim_stats_reserve(int frames) {
+    if (anim_stats_on && grow(frames) != 0) {
+        fprintf(stderr, "[STATS] sin memoria para %d frames: contadores apagados\n", frames);
+        anim_stats_on = 0;
+    }
+}
+
+void anim_stats_begin_frame(int frame) {
+    if (!anim_stats_on) return;
+    anim_stats_reserve(frame + 1);
+    stats.current = frame;
+}
+
+void anim_stats_add_at(int frame, StatsCounter c, long long value) {
+    if (!anim_stats_on || frame < 0) return;
+    if (frame >= stats.capacity) {
+        anim_stats_reserve(frame + 1);
+        if (!anim_stats_on) return;
+    }
+    stats.frames[frame].value[c] += value;
+    stats.frames[frame].touched = 1;
+    stats.window_sum[c] += value;
+}
+
+void anim_stats_add(StatsCounter c, long long value) {
+    anim_stats_add_at(stats.current, c, value);
+}
+
+// Resumen de la ventana: promedios por frame de cada contador
+static void print_window(long long now) {
+    double seconds = (now - stats.window_start_ns) / 1e9;
+    double n = stats.window_frames > 0 ? stats.window_frames : 1;
+    const long long *s = stats.window_sum;
+    fprintf(stderr, "[STATS] %d frames (%.1f/s) | por frame: interp %.3f ms, raster %.3f ms, "
+            "encode %.3f ms, write %.3f ms, lock %.3f ms | celdas %.0f pintadas, %.0f cambiadas | "
+            "%.1f KB (%.1f KB de SGR) | %.1f figuras\n",
+            stats.window_frames, seconds > 0 ? stats.window_frames / seconds : 0.0,
+            s[STATS_INTERP_NS] / n / 1e6, s[STATS_RASTER_NS] / n / 1e6,
+            s[STATS_ENCODE_NS] / n / 1e6, s[STATS_WRITE_NS] / n / 1e6,
+            s[STATS_LOCK_WAIT_NS] / n / 1e6, s[STATS_CELLS_PAINTED] / n,
+            s[STATS_CELLS_CHANGED] / n, s[STATS_BYTES] / n / 1024.0, s[STATS_SGR_BYTES] / n / 1024.0,
+            s[STATS_ACTIVE_FIGURES] / n);
+}
+
+void anim_stats_frame_done(int frame) {
+    if (!anim_stats_on) return;
+    // Con mt varios hilos terminan el mismo tick: cuenta el primero
+    if (frame > stats.last_done) {
+        stats.last_done = frame;
+        stats.window_frames++;
+    }
+    long long now = frame_clock_now_ns();
+    if (now - stats.window_start_ns < ANIM_STATS_SUMMARY_MS * 1000000LL) return;
+
+    print_window(now);
+    memset(stats.window_sum, 0, sizeof(stats.window_sum));
+    stats.window_frames = 0;
+    stats.window_start_ns = now;
+}
+
+static int has_suffix(const char *s, const char *suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+static void dump_csv(FILE *out) {
+    fprintf(out, "frame");
+    for (int c = 0; c < STATS_NUM_COUNTERS; c++) fprintf(out, ",%s", counter_names[c]);
+    fputc('\n', out);
+    for (int f = 0; f < stats.capacity; f++) {
+        if (!stats.frames[f].touched) continue;
+        fprintf(out, "%d", f);
+        for (int c = 0; c < STATS_NUM_COUNTERS; c++) fprintf(out, ",%lld", stats.frames[f].value[c]);
+        fputc('\n', out);
+    }
+}
+
+static void dump_json(FILE *out, const long long *total, int frames) {
+    fprintf(out, "{\"frames\": [");
+    int first = 1;
+    for (int f = 0; f < stats.capacity; f++) {
+        if (!stats.frames[f].touched) continue;
+        fprintf(out, "%s\n  {\"frame\": %d", first ? "" : ",", f);
+        for (int c = 0; c < STATS_NUM_COUNTERS; c++) {
+            fprintf(out, ", \"%s\": %lld", counter_names[c], stats.frames[f].value[c]);
+        }
+        fputc('}', out);
+        first = 0;
+    }
+    fprintf(out, "\n],\n\"total\": {\"frames\": %d", frames);
+    for (int c = 0; c < STATS_NUM_COUNTERS; c++) {
+        fprintf(out, ", \"%s\": %lld", counter_names[c], total[c]);
+    }
+    fprintf(out, "}}\n");
+}
+
+// Al salir del proceso (también cuando mt termina con exit desde un hilo)
+static void finish(void) {
+    if (!anim_stats_on) return;
+    anim_stats_on = 0;
+
+    long long total[STATS_NUM_COUNTERS] = {0};
+    int frames = 0;
+    for (int f = 0; f < stats.capacity; f++) {
+        if (!stats.frames[f].touched) continue;
+        frames++;
+        for (int c = 0; c < STATS_NUM_COUNTERS; c++) total[c] += stats.frames[f].value[c];
+    }
+
+    FILE *out = fopen(stats.dump_path, "w");
+    if (!out) {
+        perror(stats.dump_path);
+    } else {
+        if (has_suffix(stats.dump_path, ".json")) dump_json(out, total, frames);
+        else dump_csv(out);
+        fclose(out);
+    }
+
+    double n = frames > 0 ? frames : 1;
+    fprintf(stderr, "[STATS] total %d frames | por frame: interp %.3f ms, raster %.3f ms, "
+            "encode %.3f ms, write %.3f ms, lock %.3f ms | %.1f KB (%.1f KB de SGR) | volcado en %s\n",
+            frames, total[STATS_INTERP_NS] / n / 1e6, total[STATS_RASTER_NS] / n / 1e6,
+            total[STATS_ENCODE_NS] / n / 1e6, total[STATS_WRITE_NS] / n / 1e6,
+            total[STATS_LOCK_WAIT_NS] / n / 1e6, total[STATS_BYTES] / n / 1024.0,
+            total[STATS_SGR_BYTES] / n / 1024.0,
+            stats.dump_path);
+    free(stats.frames);
+    stats.frames = NULL;
+    stats.capacity = 0;
+}
+
+void anim_stats_enable(const char *dump_path) {
+    snprintf(stats.dump_path, sizeof(stats.dump_path), "%s",
+             dump_path && *dump_path ? dump_path : ANIM_STATS_DEFAULT_DUMP);
+    stats.window_start_ns = frame_clock_now_ns();
+    if (!anim_stats_on) atexit(finish);
+    anim_stats_on = 1;
+}
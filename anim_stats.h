@@ -0,0 +1,61 @@
+#ifndef ANIM_STATS_H
+#define ANIM_STATS_H
+
+#include "frame_clock.h"
+
+// Cada cuánto se imprime el resumen móvil en stderr
+#define ANIM_STATS_SUMMARY_MS 1000
+
+// Volcado por defecto de --stats (".json" en el nombre = JSON, si no CSV)
+#define ANIM_STATS_DEFAULT_DUMP "anim_stats.csv"
+
+typedef enum {
+    STATS_INTERP_NS,         // trayectorias y rejilla
+    STATS_RASTER_NS,         // copiar glifos al canvas
+    STATS_ENCODE_NS,         // canvas → secuencias ANSI (o caché de frames)
+    STATS_WRITE_NS,          // write/fwrite hacia el destino
+    STATS_LOCK_WAIT_NS,      // espera por canvas_mutex (animator_mt)
+    STATS_CELLS_PAINTED,     // celdas no transparentes copiadas de glifos
+    STATS_CELLS_CHANGED,     // celdas distintas al frame anterior
+    STATS_BYTES,             // bytes emitidos
+    STATS_SGR_BYTES,         // de esos, secuencias de color/estilo (frame_encoder.h)
+    STATS_ACTIVE_FIGURES,    // figuras pintadas
+    STATS_NUM_COUNTERS
+} StatsCounter;
+
+/*
+ * Contadores por frame para --stats. Apagados, cada punto de medición es
+ * un if sobre anim_stats_on. Encendidos, cada frame suma en su registro
+ * (un arreglo indexado por número de frame), cada ANIM_STATS_SUMMARY_MS
+ * se imprime un resumen de la ventana en stderr y al salir se vuelcan
+ * todos los frames a un CSV o JSON.
+ *
+ * Los motores de un solo hilo (animator.c, animator_md.c) marcan el frame
+ * en curso con anim_stats_begin_frame y suman con anim_stats_add. Los
+ * hilos de animator_mt suman al frame de su tick con anim_stats_add_at,
+ * después de reservar todos los frames con anim_stats_reserve.
+ */
+extern int anim_stats_on;
+
+// Instante para medir una fase; sin --stats es 0 y no se lee el reloj
+static inline long long anim_stats_now(void) {
+    return anim_stats_on ? frame_clock_now_ns() : 0;
+}
+
+// Enciende los contadores; el volcado se escribe al salir del proceso
+void anim_stats_enable(const char *dump_path);
+
+// Reserva registros para frames [0, frames) (los hilos de mt no deben realocar)
+void anim_stats_reserve(int frames);
+
+void anim_stats_begin_frame(int frame);
+void anim_stats_add(StatsCounter c, long long value);
+void anim_stats_add_at(int frame, StatsCounter c, long long value);
+
+// El frame terminó; cada tanto imprime el resumen de la ventana
+void anim_stats_frame_done(int frame);
+
+// Nombre de columna del contador (CSV y JSON)
+const char *anim_stats_counter_name(StatsCounter c);
+
+#endif // ANIM_STATS_H
@@ -9,4 +9,17 @@ Position interpolate_position(Position p0, Position p1, int t, int t_start, int
     result.x = p0.x + (int)((p1.x - p0.x) * alpha);
     result.y = p0.y + (int)((p1.y - p0.y) * alpha);
     return result;
-}
\ No newline at end of file
+}
+
+unsigned long long hash_bytes(const void *data, size_t len) {
+    return hash_bytes_update(HASH_SEED, data, len);
+}
+
+unsigned long long hash_bytes_update(unsigned long long h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
@@ -1,9 +1,17 @@
 #ifndef ANIM_UTILS_H
 #define ANIM_UTILS_H
 
+#include <stddef.h>
 #include "anim_config.h"
 
 // Interpola la posición entre dos puntos dados un tiempo t
 Position interpolate_position(Position p0, Position p1, int t, int t_start, int t_end);
 
+// Hash FNV-1a de 64 bits sobre len bytes
+unsigned long long hash_bytes(const void *data, size_t len);
+
+// Versión incremental: h = hash_bytes_update(HASH_SEED, ...) por bloques
+#define HASH_SEED 14695981039346656037ULL
+unsigned long long hash_bytes_update(unsigned long long h, const void *data, size_t len);
+
 #endif
\ No newline at end of file
@@ -1,57 +1,177 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
 #include "animator.h"
-#include "anim_utils.h"
+#include "anim_stats.h"
+#include "collision.h"
+#include "frame_cache.h"
+#include "frame_clock.h"
+#include "frame_encoder.h"
+#include "hot_reload.h"
+#include "render.h"
+#include "scene.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+#include "viewport.h"
+
+// Celdas distintas entre el frame anterior y el actual; luego guarda el actual
+static long count_changed(char *prev, const char *cur, size_t size) {
+    long changed = 0;
+    for (size_t k = 0; k < size; k++) changed += prev[k] != cur[k];
+    memcpy(prev, cur, size);
+    return changed;
+}
 
 void simulate_animation(const AnimationConfig *config) {
-    int max_time = 0;
-    for (int i = 0; i < config->num_figures; i++) {
-        if (config->figures[i].t_end > max_time) {
-            max_time = config->figures[i].t_end;
-        }
+    const Scene *scene = config->scene;
+    int max_figures = scene->num_figures;
+    int max_time = render_max_time(config);
+
+    // Rejilla sobre el mundo: cada cámara descarta las figuras que no ve
+    SpatialGrid grid;
+    int *visible = malloc(sizeof(int) * (scene->num_figures > 0 ? scene->num_figures : 1));
+    if (!visible || grid_init(&grid, config->world.width, config->world.height,
+                              GRID_CELL_SIZE, scene->num_figures) != 0) {
+        fprintf(stderr, "Error reservando la rejilla espacial\n");
+        free(visible);
+        return;
     }
+    Rect view = {0, 0, config->canvas.width, config->canvas.height};
+
+    // Cursor de trayectorias: avanza todas las figuras un tick por frame
+    TrajectoryState traj;
+    if (trajectory_state_init(&traj, config->trajectory, 0) != 0) {
+        fprintf(stderr, "Error reservando el estado de trayectorias\n");
+        grid_free(&grid);
+        free(visible);
+        return;
+    }
+
+    // Choques entre figuras (NULL si la configuración no define "collisions")
+    CollisionSystem *collisions = collision_create(config);
 
-    for (int t = 0; t <= max_time; t++) {
-        printf("\033[2J\033[H");  // Limpiar pantalla
-        char canvas[config->canvas.height][config->canvas.width];
-        memset(canvas, ' ', sizeof(canvas));
-
-        for (int i = 0; i < config->num_figures; i++) {
-            Figure *f = &config->figures[i];
-            if (t < f->t_start || t > f->t_end) continue;
-
-            Position pos = interpolate_position(f->pos0, f->pos1, t, f->t_start, f->t_end);
-
-            // Seleccionar la rotación real (0, 90, 180, 270) según el tiempo
-            int angles[] = {0, 90, 180, 270};
-            int angle = angles[((t - f->t_start) / 2) % 4];
-            char **shape = f->rotations[angle];
-            if (!shape) continue; // puede que no exista esa rotación
-
-            for (int r = 0; r < f->rows; r++) {
-                for (int c = 0; c < f->cols; c++) {
-                    int y = pos.y + r;
-                    int x = pos.x + c;
-                    if (y >= 0 && y < config->canvas.height &&
-                        x >= 0 && x < config->canvas.width &&
-                        shape[r][c] != ' ') {
-                        canvas[y][x] = shape[r][c];
-                    }
+    // Caché de frames ya codificados: las repeticiones no vuelven a rasterizar
+    long budget = config->frame_cache_bytes;
+    if (budget == FRAME_CACHE_AUTO) budget = config->loops > 1 ? FRAME_CACHE_DEFAULT_BUDGET : 0;
+    int use_cache = budget > 0;
+    FrameCache cache;
+    if (use_cache && frame_cache_init(&cache, budget, config->frame_cache_compress) != 0) {
+        use_cache = 0;
+    }
+    ByteBuffer encoded;
+    bytebuf_init(&encoded);
+    size_t canvas_size = (size_t)config->canvas.width * config->canvas.height;
+    char *canvas = malloc(canvas_size);
+    unsigned char *attrs = malloc(canvas_size);  // plano de color, solo si la escena tiene color
+    char *prev = anim_stats_on ? malloc(canvas_size) : NULL;  // para contar celdas cambiadas
+    if (prev) memset(prev, ' ', canvas_size);
+    FrameBuffer fb = {canvas, config->canvas.width, config->canvas.height, config->canvas.width, NULL};
+
+    FrameClock clock;
+    frame_clock_init(&clock, config->fps, config->frame_policy);
+
+    // El reloj cuenta frames globales; t es el tick dentro de la vuelta actual
+    int frames_per_loop = max_time + 1;
+    int total_frames = frames_per_loop * config->loops;
+    int frame = 0;
+    while (canvas && attrs && frame < total_frames) {
+        // Recarga en caliente: la escena solo cambia entre frames
+        HotReloadChange change;
+        if (hot_reload_poll(config->reload, &change)) {
+            scene = config->scene;
+            if (scene->num_figures > max_figures) {
+                int *grown = realloc(visible, sizeof(int) * scene->num_figures);
+                if (grown) {
+                    visible = grown;
+                    max_figures = scene->num_figures;
                 }
             }
+            if (max_figures < scene->num_figures || grid_reserve(&grid, max_figures) != 0 ||
+                hot_reload_sync_trajectory(&change, &traj, config->trajectory) != 0 ||
+                collision_sync(collisions, config, &change, &traj) != 0) {
+                fprintf(stderr, "Error aplicando la recarga de la configuración\n");
+                break;
+            }
+            max_time = render_max_time(config);
+            frames_per_loop = max_time + 1;
+            total_frames = frames_per_loop * config->loops;
+            if (frame >= total_frames) frame = total_frames - 1;
         }
 
-        for (int i = 0; i < config->canvas.height; i++) {
-            for (int j = 0; j < config->canvas.width; j++) {
-                putchar(canvas[i][j]);
+        int t = frame % frames_per_loop;
+        bytebuf_reset(&encoded);
+        anim_stats_begin_frame(frame);
+
+        long long t0 = anim_stats_now();
+        if (!use_cache || !frame_cache_get(&cache, config->hash, t, &encoded)) {
+            if (traj.t != t) {
+                collision_seek(collisions, config, &grid, &traj, t);  // frames saltados o vuelta nueva
             }
-            putchar('\n');
+
+            // Los choques necesitan a todas las figuras; si no, solo las que alguna cámara ve
+            if (collisions) grid_build(&grid, config, &traj);
+            else viewport_grid_build(config, &grid, &traj);
+            collision_detect(collisions, config, &grid, &traj);
+            long long t1 = anim_stats_now();
+
+            memset(canvas, ' ', (size_t)fb.width * fb.height);
+            fb.attrs = scene->colored ? attrs : NULL;  // puede cambiar con una recarga
+            if (fb.attrs) memset(attrs, 0, canvas_size);
+            long painted = 0;
+            int num_visible = viewport_paint(config, &grid, &traj, view, &fb, visible, max_figures,
+                                             anim_stats_on ? &painted : NULL);
+            long long t2 = anim_stats_now();
+
+            trajectory_step(&traj);
+            collision_apply(collisions, &traj);
+            long long t3 = anim_stats_now();
+
+            unsigned long long sgr = frame_encoder_sgr_bytes;
+            encode_full_frame_attr(canvas, fb.attrs, fb.width, fb.height, &encoded);
+            if (use_cache) frame_cache_put(&cache, config->hash, t, encoded.data, encoded.len);
+
+            if (anim_stats_on) {
+                anim_stats_add(STATS_INTERP_NS, (t1 - t0) + (t3 - t2));
+                anim_stats_add(STATS_RASTER_NS, t2 - t1);
+                anim_stats_add(STATS_ENCODE_NS, anim_stats_now() - t3);
+                anim_stats_add(STATS_SGR_BYTES, (long long)(frame_encoder_sgr_bytes - sgr));
+                anim_stats_add(STATS_CELLS_PAINTED, painted);
+                anim_stats_add(STATS_ACTIVE_FIGURES, num_visible);
+                if (prev) anim_stats_add(STATS_CELLS_CHANGED, count_changed(prev, canvas, canvas_size));
+            }
+        } else if (anim_stats_on) {
+            anim_stats_add(STATS_ENCODE_NS, anim_stats_now() - t0);  // frame sacado del caché
+        }
+
+        long long w0 = anim_stats_now();
+        fwrite(encoded.data, 1, encoded.len, stdout);
+        if (anim_stats_on) {
+            anim_stats_add(STATS_WRITE_NS, anim_stats_now() - w0);
+            anim_stats_add(STATS_BYTES, (long long)encoded.len);
+            anim_stats_frame_done(frame);
         }
 
-        usleep(100000); // 100 ms
+        // Esperar el deadline absoluto del siguiente frame
+        if (frame == total_frames - 1) break;
+        frame = frame_clock_next(&clock);
+        if (frame >= total_frames) frame = total_frames - 1;  // no saltarse el estado final
     }
 
+    free(canvas);
+    free(attrs);
+    free(prev);
+    bytebuf_free(&encoded);
+    trajectory_state_free(&traj);
+    grid_free(&grid);
+    free(visible);
+
     printf("\n[FIN DE LA ANIMACIÓN]\n");
+    fflush(stdout);
+    frame_clock_report(&clock, stderr);
+    collision_report(collisions, stderr);
+    collision_free(collisions);
+    if (use_cache) {
+        frame_cache_report(&cache, stderr);
+        frame_cache_free(&cache);
+    }
 }
\ No newline at end of file
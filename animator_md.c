@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "animator_md.h"
+#include "anim_stats.h"
+#include "collision.h"
+#include "display.h"
+#include "frame_clock.h"
+#include "hot_reload.h"
+#include "render.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+#include "viewport.h"
+
+void simulate_animation_multidisplay(const AnimationConfig *config) {
+    int max_time = render_max_time(config);
+
+    // La rejilla (sobre el mundo) asigna figuras a displays: cada región solo consulta sus casillas
+    SpatialGrid grid;
+    if (grid_init(&grid, config->world.width, config->world.height,
+                  GRID_CELL_SIZE, config->num_figures) != 0) {
+        fprintf(stderr, "Error reservando la rejilla espacial\n");
+        return;
+    }
+    TrajectoryState traj;
+    if (trajectory_state_init(&traj, config->trajectory, 0) != 0) {
+        fprintf(stderr, "Error reservando el estado de trayectorias\n");
+        grid_free(&grid);
+        return;
+    }
+    DisplaySet displays;
+    if (display_set_open(&displays, config) != 0) {
+        fprintf(stderr, "Error lanzando los procesos de display\n");
+        display_set_close(&displays, 0);
+        trajectory_state_free(&traj);
+        grid_free(&grid);
+        return;
+    }
+
+    CollisionSystem *collisions = collision_create(config);  // NULL sin "collisions"
+
+    FrameClock clock;
+    frame_clock_init(&clock, config->fps, config->frame_policy);
+    long long start = frame_clock_now_ns();
+
+    int frames_per_loop = max_time + 1;
+    int total_frames = frames_per_loop * config->loops;
+    int frame = 0;
+    while (frame < total_frames) {
+        // Recarga en caliente: la escena solo cambia entre frames
+        HotReloadChange change;
+        if (hot_reload_poll(config->reload, &change)) {
+            int n = config->num_figures;
+            if (grid_reserve(&grid, n) != 0 || display_set_reserve(&displays, n) != 0 ||
+                hot_reload_sync_trajectory(&change, &traj, config->trajectory) != 0 ||
+                collision_sync(collisions, config, &change, &traj) != 0) {
+                fprintf(stderr, "Error aplicando la recarga de la configuración\n");
+                break;
+            }
+            max_time = render_max_time(config);
+            frames_per_loop = max_time + 1;
+            total_frames = frames_per_loop * config->loops;
+            if (frame >= total_frames) frame = total_frames - 1;
+        }
+
+        int t = frame % frames_per_loop;
+        anim_stats_begin_frame(frame);
+        long long t0 = anim_stats_now();
+        if (traj.t != t) collision_seek(collisions, config, &grid, &traj, t);
+
+        // Los choques necesitan a todas las figuras; si no, solo las que alguna cámara ve
+        if (collisions) grid_build(&grid, config, &traj);
+        else viewport_grid_build(config, &grid, &traj);
+        collision_detect(collisions, config, &grid, &traj);
+        long long t1 = anim_stats_now();
+        display_set_send(&displays, config, &grid, &traj, t);  // suma raster, encode y write
+        long long t2 = anim_stats_now();
+        trajectory_step(&traj);
+        collision_apply(collisions, &traj);
+        if (anim_stats_on) {
+            anim_stats_add(STATS_INTERP_NS, (t1 - t0) + (anim_stats_now() - t2));
+            anim_stats_add(STATS_ACTIVE_FIGURES, grid.num_inserted);
+            anim_stats_frame_done(frame);
+        }
+
+        if (frame == total_frames - 1) break;
+        frame = frame_clock_next(&clock);
+        if (frame >= total_frames) frame = total_frames - 1;  // no saltarse el estado final
+    }
+
+    double seconds = (frame_clock_now_ns() - start) / 1e9;
+    display_set_close(&displays, seconds);
+    trajectory_state_free(&traj);
+    grid_free(&grid);
+
+    frame_clock_report(&clock, stderr);
+    collision_report(collisions, stderr);
+    collision_free(collisions);
+}
@@ -0,0 +1,9 @@
+#ifndef ANIMATOR_MD_H
+#define ANIMATOR_MD_H
+
+#include "anim_config.h"
+
+// Animación repartida en una rejilla de displays, cada uno en su proceso
+void simulate_animation_multidisplay(const AnimationConfig *config);
+
+#endif // ANIMATOR_MD_H
@@ -6,93 +6,308 @@
 #include <unistd.h>
 #include "lib/mypthread.h"
 #include "anim_config.h"
-#include "anim_utils.h"
+#include "anim_stats.h"
+#include "balancer.h"
+#include "frame_clock.h"
+#include "render.h"
+#include "scene.h"
+#include "sink_queue.h"
+#include "trajectory.h"
 
-#define MAX_HEIGHT 100
-#define MAX_WIDTH  100
-
-// Canvas global compartido
-static char canvas[MAX_HEIGHT][MAX_WIDTH];
+// Canvas global compartido y su plano de atributos (solo si la escena tiene color),
+// del tamaño de config->canvas y con paso = ancho
+static char *canvas;
+static unsigned char *canvas_attr;
 static my_mutex_t canvas_mutex;
 
+// Cola de frames hacia stdout: una terminal lenta no frena a las figuras
+static SinkQueue stdout_sink;
+static my_mutex_t sink_mutex;
+
+/*
+ * Un solo reloj marca el ritmo: los hilos juegan el tick tick_now y el
+ * último en terminarlo duerme hasta el deadline del siguiente (dormir
+ * dentro de un hilo mypthread bloquea todo el proceso, así que se hace
+ * una vez por tick). Los demás esperan con my_thread_yield.
+ */
+static long long anim_epoch;
+static FrameClock tick_clock;    // tiempo de frame = tick completo de todos los hilos
+static my_mutex_t tick_mutex;
+static int tick_now;             // tick que se está jugando
+static int tick_pending;         // hilos que todavía no terminaron tick_now
+static int tick_threads;         // hilos que siguen en la animación
+
+// Con tick_mutex tomado: todos terminaron tick_now, pasar al siguiente
+static void tick_advance(void) {
+    tick_pending = tick_threads;
+    if (tick_threads > 0) tick_now = frame_clock_next(&tick_clock);
+}
+
+// El hilo terminó el tick t; espera a los demás y retorna el tick que sigue
+static int tick_arrive(int t) {
+    my_mutex_lock(&tick_mutex);
+    if (--tick_pending == 0) tick_advance();
+    my_mutex_unlock(&tick_mutex);
+    while (tick_now == t) my_thread_yield();
+    return tick_now;
+}
+
+// El hilo ya no juega más ticks (incluido tick_now)
+static void tick_leave(void) {
+    my_mutex_lock(&tick_mutex);
+    tick_threads--;
+    if (--tick_pending == 0) tick_advance();
+    my_mutex_unlock(&tick_mutex);
+}
+
 typedef struct {
-    Figure *figure;
+    const Scene *scene;
+    const Trajectory *trajectory;
+    int index;              // índice de la figura en la escena
     int canvas_width;
     int canvas_height;
 } AnimatorArgs;
 
+// Modo workers: cada hilo pinta las figuras que el balanceador le asigna
+static Balancer balancer;
+static long long *worker_busy_ns;
+static long *worker_painted;
+
+typedef struct {
+    const AnimationConfig *config;
+    int worker;
+    int max_time;
+} WorkerArgs;
+
+// Contadores de la cola de stdout antes de un envío, para sumar la diferencia
+typedef struct {
+    long long encode_ns, write_ns, bytes;
+    unsigned long long sgr_bytes;
+} SinkMark;
+
+static SinkMark sink_mark(void) {
+    SinkMark m = {stdout_sink.encode_ns, stdout_sink.write_ns, stdout_sink.bytes,
+                  frame_encoder_sgr_bytes};
+    return m;
+}
+
+/*
+ * --stats: suma al tick t lo que hizo un hilo (una figura o un worker).
+ * Se llama con sink_mutex tomado, después de vaciar la cola.
+ */
+static void record_tick(int t, long long interp_ns, long long raster_ns, long long lock_ns,
+                        int figures, long painted, long changed, SinkMark before) {
+    anim_stats_add_at(t, STATS_INTERP_NS, interp_ns);
+    anim_stats_add_at(t, STATS_RASTER_NS, raster_ns);
+    anim_stats_add_at(t, STATS_LOCK_WAIT_NS, lock_ns);
+    anim_stats_add_at(t, STATS_ENCODE_NS, stdout_sink.encode_ns - before.encode_ns);
+    anim_stats_add_at(t, STATS_WRITE_NS, stdout_sink.write_ns - before.write_ns);
+    anim_stats_add_at(t, STATS_BYTES, stdout_sink.bytes - before.bytes);
+    anim_stats_add_at(t, STATS_SGR_BYTES, (long long)(frame_encoder_sgr_bytes - before.sgr_bytes));
+    anim_stats_add_at(t, STATS_CELLS_PAINTED, painted);
+    anim_stats_add_at(t, STATS_CELLS_CHANGED, changed);
+    anim_stats_add_at(t, STATS_ACTIVE_FIGURES, figures);
+}
+
 /**
  * Función que ejecuta cada hilo para animar su figura en el canvas.
  */
 void animator_thread_func(void) {
     AnimatorArgs *args = (AnimatorArgs *) current_thread->arg;
-    Figure *f = args->figure;
+    const Scene *scene = args->scene;
+    int i = args->index;
     int width = args->canvas_width;
     int height = args->canvas_height;
+    FrameBuffer fb = {canvas, width, height, width, canvas_attr};
 
-    for (int t = 0; t <= f->t_end; t++) {
-        if (t < f->t_start) {
-            usleep(100000);  // esperar su turno
-            my_thread_yield();
-            continue;
-        }
+    for (int t = tick_now; t <= scene->t_end[i]; t = tick_arrive(t)) {
+        if (t < scene->t_start[i]) continue;  // esperar su turno
 
-        Position pos = interpolate_position(f->pos0, f->pos1, t, f->t_start, f->t_end);
-        int angles[] = {0, 90, 180, 270};
-        int angle = angles[((t - f->t_start) / 2) % 4];
-        char **shape = f->rotations[angle];
-        if (!shape) continue;
+        if (!scene_glyph(scene, i, scene_rotation_at(scene, i, t))) continue;
+        long long t0 = anim_stats_now();
+        Position pos = trajectory_position_at(args->trajectory, i, t);
+        long long t1 = anim_stats_now();
 
         my_mutex_lock(&canvas_mutex);
+        long long t2 = anim_stats_now();
 
         // Pintar figura en canvas
-        for (int r = 0; r < f->rows; r++) {
-            for (int c = 0; c < f->cols; c++) {
-                int y = pos.y + r;
-                int x = pos.x + c;
-                if (y >= 0 && y < height && x >= 0 && x < width && shape[r][c] != ' ') {
-                    canvas[y][x] = shape[r][c];
-                }
-            }
+        int painted = 0, changed = 0;
+        if (anim_stats_on) painted = render_blit_counted(scene, i, t, pos, &fb, &changed);
+        else render_blit(scene, i, t, pos, &fb);
+        long long t3 = anim_stats_now();
+
+        // Encolar una copia y soltar el canvas antes de escribir
+        my_mutex_lock(&sink_mutex);
+        sink_queue_push(&stdout_sink, canvas, canvas_attr, width);
+        my_mutex_unlock(&canvas_mutex);
+
+        // Enviar lo que stdout acepte sin bloquear; el resto queda en la cola
+        SinkMark mark = sink_mark();
+        sink_queue_pump(&stdout_sink);
+        if (anim_stats_on) record_tick(t, t1 - t0, t3 - t2, t2 - t1, 1, painted, changed, mark);
+        my_mutex_unlock(&sink_mutex);
+        anim_stats_frame_done(t);
+    }
+
+    tick_leave();
+    my_thread_end();
+}
+
+/**
+ * Hilo worker: por cada frame pinta de una vez todas las figuras que le
+ * tocan en la época actual del balanceador y encola un solo frame.
+ */
+void worker_thread_func(void) {
+    WorkerArgs *args = (WorkerArgs *) current_thread->arg;
+    const AnimationConfig *config = args->config;
+    const Scene *scene = config->scene;
+    int w = args->worker;
+    FrameBuffer fb = {canvas, config->canvas.width, config->canvas.height, config->canvas.width,
+                      canvas_attr};
+
+    int epoch = 0;
+    for (int t = tick_now; t <= args->max_time; t = tick_arrive(t)) {
+        if (epoch + 1 < balancer.num_epochs && balancer.epoch_start[epoch + 1] <= t) {
+            epoch = balancer_epoch_at(&balancer, t);  // cambió el conjunto activo
         }
+        int count;
+        const int *units = balancer_units(&balancer, epoch, w, &count);
 
-        // Imprimir canvas (una sola figura puede hacerlo, por ahora)
-        printf("\033[2J\033[H");  // limpiar pantalla
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                putchar(canvas[i][j]);
+        long long wait = anim_stats_now();
+        my_mutex_lock(&canvas_mutex);
+        long long start = frame_clock_now_ns();
+        int painted = 0;
+        long cells = 0, changed = 0;
+        for (int k = 0; k < count; k++) {
+            int i = units[k];
+            if (t < scene->t_start[i] || t > scene->t_end[i]) continue;
+            if (!scene_glyph(scene, i, scene_rotation_at(scene, i, t))) continue;
+            Position pos = trajectory_position_at(config->trajectory, i, t);
+            if (anim_stats_on) {
+                int c;
+                cells += render_blit_counted(scene, i, t, pos, &fb, &c);
+                changed += c;
+            } else {
+                render_blit(scene, i, t, pos, &fb);
             }
-            putchar('\n');
+            painted++;
         }
+        long long busy = frame_clock_now_ns() - start;
+        worker_busy_ns[w] += busy;
+        worker_painted[w] += painted;
 
+        if (painted == 0) {
+            my_mutex_unlock(&canvas_mutex);
+            continue;
+        }
+        my_mutex_lock(&sink_mutex);
+        sink_queue_push(&stdout_sink, canvas, canvas_attr, config->canvas.width);
         my_mutex_unlock(&canvas_mutex);
-
-        usleep(100000);  // 100 ms
-        my_thread_yield();
+        SinkMark mark = sink_mark();
+        sink_queue_pump(&stdout_sink);
+        // Los workers interpolan dentro del bucle de pintado: todo cuenta como raster
+        if (anim_stats_on) record_tick(t, 0, busy, start - wait, painted, cells, changed, mark);
+        my_mutex_unlock(&sink_mutex);
+        anim_stats_frame_done(t);
     }
 
+    tick_leave();
     my_thread_end();
 }
 
+/**
+ * Reporte al salir: my_thread_end termina el proceso con exit(0).
+ */
+static void report_frame_stats(void) {
+    sink_queue_flush(&stdout_sink, SINK_FLUSH_TIMEOUT_MS);
+    sink_queue_report(&stdout_sink, "stdout", stderr);
+    sink_queue_free(&stdout_sink);
+    fflush(stdout);
+    frame_clock_report(&tick_clock, stderr);
+    if (worker_busy_ns) {
+        double seconds = (frame_clock_now_ns() - anim_epoch) / 1e9;
+        balancer_report(&balancer, worker_busy_ns, worker_painted, seconds, stderr);
+    }
+}
+
+/**
+ * Crea los hilos worker con el reparto del balanceador.
+ */
+static void create_workers(const AnimationConfig *config) {
+    int workers = config->workers;
+    if (balancer_build(&balancer, config, workers) != 0) {
+        fprintf(stderr, "Error repartiendo figuras entre workers\n");
+        exit(1);
+    }
+    worker_busy_ns = calloc(workers, sizeof(long long));
+    worker_painted = calloc(workers, sizeof(long));
+    if (!worker_busy_ns || !worker_painted) {
+        fprintf(stderr, "Error reservando estadísticas de workers\n");
+        exit(1);
+    }
+
+    int max_time = render_max_time(config);
+    for (int w = 0; w < workers; w++) {
+        WorkerArgs *args = malloc(sizeof(WorkerArgs));
+        args->config = config;
+        args->worker = w;
+        args->max_time = max_time;
+
+        my_thread_t *thread;
+        if (my_thread_create(&thread, worker_thread_func, SCHED_RR, 0) != 0) {
+            fprintf(stderr, "Error creando worker %d\n", w);
+            exit(1);
+        }
+        thread->arg = (void *)args;
+    }
+}
+
 /**
  * Lanza un hilo mypthread por cada figura y sincroniza su ejecución.
  */
 void simulate_animation_multithread(const AnimationConfig *config) {
     my_thread_t *threads[config->num_figures];
 
-    // Inicializar canvas a espacios
-    memset(canvas, ' ', sizeof(canvas));
+    // Canvas a espacios y plano de atributos en 0
+    size_t cells = (size_t)config->canvas.width * config->canvas.height;
+    canvas = malloc(cells > 0 ? cells : 1);
+    canvas_attr = config->scene->colored ? calloc(cells > 0 ? cells : 1, 1) : NULL;
+    if (!canvas || (config->scene->colored && !canvas_attr)) {
+        fprintf(stderr, "Sin memoria para el canvas\n");
+        free(canvas);
+        free(canvas_attr);
+        return;
+    }
+    memset(canvas, ' ', cells);
 
     // Inicializar mutex del canvas
-    if (my_mutex_init(&canvas_mutex) != 0) {
+    if (my_mutex_init(&canvas_mutex) != 0 || my_mutex_init(&sink_mutex) != 0 ||
+        my_mutex_init(&tick_mutex) != 0) {
         fprintf(stderr, "Error inicializando mutex del canvas\n");
         return;
     }
 
-    // Crear un hilo por figura
-    for (int i = 0; i < config->num_figures; i++) {
+    // Lo ya impreso con stdio sale antes que los frames de la cola
+    fflush(stdout);
+    if (sink_queue_init(&stdout_sink, STDOUT_FILENO, config->canvas.width, config->canvas.height,
+                        config->sink_capacity, config->sink_policy, sink_encode_full, 0) != 0) {
+        fprintf(stderr, "Error preparando la cola de stdout\n");
+        return;
+    }
+
+    // Reloj único de la animación; el tick 0 vence al arrancar
+    anim_epoch = frame_clock_now_ns();
+    frame_clock_init_at(&tick_clock, config->fps, config->frame_policy, anim_epoch);
+    anim_stats_reserve(render_max_time(config) + 1);  // los hilos no realocan los registros
+    atexit(report_frame_stats);
+
+    // Crear un hilo por figura, o los workers si la configuración los pide
+    for (int i = 0; i < config->num_figures && config->workers == 0; i++) {
         AnimatorArgs *args = malloc(sizeof(AnimatorArgs));
-        args->figure = &config->figures[i];
+        args->scene = config->scene;
+        args->trajectory = config->trajectory;
+        args->index = i;
         args->canvas_width = config->canvas.width;
         args->canvas_height = config->canvas.height;
 
@@ -103,17 +318,23 @@ void simulate_animation_multithread(const AnimationConfig *config) {
 
         threads[i]->arg = (void *)args;
     }
+    if (config->workers > 0) create_workers(config);
+    tick_now = 0;
+    tick_threads = tick_pending = config->workers > 0 ? config->workers : config->num_figures;
 
     // Iniciar temporizador de mypthreads (SIGALRM)
     init_timer();
 
-    // Activar el primer hilo listo: RR → Lottery → RT
+    // Activar el primer hilo listo: RR → Lottery → Stride → RT
     if (rr_head) {
         current_thread = rr_head;
         setcontext(&rr_head->context);
     } else if (lottery_head) {
         current_thread = lottery_head;
         setcontext(&lottery_head->context);
+    } else if (stride_head) {
+        current_thread = stride_pick_next();
+        setcontext(&current_thread->context);
     } else if (rt_head) {
         current_thread = rt_head;
         setcontext(&rt_head->context);
@@ -0,0 +1,360 @@
+#include "balancer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "scene.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+
+long long balancer_figure_cost(const AnimationConfig *config, int i, int t0, int t1) {
+    const Scene *scene = config->scene;
+    int lo = scene->t_start[i] > t0 ? scene->t_start[i] : t0;
+    int hi = scene->t_end[i] + 1 < t1 ? scene->t_end[i] + 1 : t1;
+    if (hi <= lo) return 0;
+
+    // Casillas que toca el bounding box al comienzo de la ventana, recortado al canvas
+    Position p = trajectory_position_at(config->trajectory, i, lo);
+    int x0 = p.x < 0 ? 0 : p.x, y0 = p.y < 0 ? 0 : p.y;
+    int x1 = p.x + scene->cols[i], y1 = p.y + scene->rows[i];
+    if (x1 > config->canvas.width) x1 = config->canvas.width;
+    if (y1 > config->canvas.height) y1 = config->canvas.height;
+    long long tiles = 0;
+    if (x1 > x0 && y1 > y0) {
+        tiles = (long long)((x1 - 1) / GRID_CELL_SIZE - x0 / GRID_CELL_SIZE + 1) *
+                ((y1 - 1) / GRID_CELL_SIZE - y0 / GRID_CELL_SIZE + 1);
+    }
+    long long per_frame = (long long)scene->rows[i] * scene->cols[i] +
+                          BALANCE_TILE_COST * tiles + BALANCE_FIGURE_OVERHEAD;
+    return per_frame * (hi - lo);
+}
+
+typedef struct {
+    int tick;
+    int figure;
+    int enter;                   // 1 = empieza, 0 = termina
+} Event;
+
+static int cmp_event(const void *a, const void *b) {
+    const Event *x = a, *y = b;
+    if (x->tick != y->tick) return x->tick < y->tick ? -1 : 1;
+    if (x->enter != y->enter) return x->enter - y->enter;  // primero las salidas
+    return x->figure - y->figure;
+}
+
+typedef struct {
+    long long load;
+    int worker;
+} HeapNode;
+
+static void heap_push(HeapNode *h, int *n, HeapNode v) {
+    int k = (*n)++;
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (h[parent].load < v.load ||
+            (h[parent].load == v.load && h[parent].worker < v.worker)) break;
+        h[k] = h[parent];
+        k = parent;
+    }
+    h[k] = v;
+}
+
+static HeapNode heap_pop(HeapNode *h, int *n) {
+    HeapNode top = h[0], last = h[--(*n)];
+    int k = 0;
+    for (;;) {
+        int c = 2 * k + 1;
+        if (c >= *n) break;
+        if (c + 1 < *n && (h[c + 1].load < h[c].load ||
+                           (h[c + 1].load == h[c].load && h[c + 1].worker < h[c].worker))) c++;
+        if (last.load < h[c].load || (last.load == h[c].load && last.worker < h[c].worker)) break;
+        h[k] = h[c];
+        k = c;
+    }
+    h[k] = last;
+    return top;
+}
+
+typedef struct {
+    long long cost;
+    int figure;
+} Unit;
+
+static int cmp_unit_desc(const void *a, const void *b) {
+    const Unit *x = a, *y = b;
+    if (x->cost != y->cost) return x->cost > y->cost ? -1 : 1;
+    return x->figure - y->figure;
+}
+
+// Estado del barrido por eventos mientras se construyen las épocas
+typedef struct {
+    const AnimationConfig *config;
+    Balancer *b;
+    int *active;                 // figuras activas (orden arbitrario)
+    int *active_pos;             // posición de cada figura en active (-1 = inactiva)
+    int num_active;
+    int *worker_of;
+    long long *charged;          // costo cargado a su worker
+    long long *load;
+    Unit *units;
+    HeapNode *heap;
+    int *epoch_entries;          // entradas de la época abierta, antes de ordenar
+    int *epoch_worker;
+    int epoch_count, epoch_cap;
+    int entries_cap, epochs_cap;
+} Sweep;
+
+static int push_entry(Sweep *s, int figure) {
+    if (s->epoch_count == s->epoch_cap) {
+        int cap = s->epoch_cap ? s->epoch_cap * 2 : 64;
+        int *e = realloc(s->epoch_entries, sizeof(int) * cap);
+        if (!e) return -1;
+        s->epoch_entries = e;
+        s->epoch_cap = cap;
+    }
+    s->epoch_entries[s->epoch_count++] = figure;
+    return 0;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Cierra la época abierta: ordena sus entradas por worker y figura
+static int close_epoch(Sweep *s) {
+    Balancer *b = s->b;
+    int W = b->num_workers, e = b->num_epochs - 1;
+    if (e < 0) return 0;
+
+    if (b->num_entries + s->epoch_count > s->entries_cap) {
+        int cap = s->entries_cap ? s->entries_cap : 256;
+        while (cap < b->num_entries + s->epoch_count) cap *= 2;
+        int *entries = realloc(b->entries, sizeof(int) * cap);
+        if (!entries) return -1;
+        b->entries = entries;
+        s->entries_cap = cap;
+    }
+    int *off = b->epoch_offset + (long)e * (W + 1);
+    int *count = calloc(W + 1, sizeof(int));
+    if (!count) return -1;
+    qsort(s->epoch_entries, s->epoch_count, sizeof(int), cmp_int);
+    for (int k = 0; k < s->epoch_count; k++) count[s->worker_of[s->epoch_entries[k]] + 1]++;
+    off[0] = b->num_entries;
+    for (int w = 0; w < W; w++) off[w + 1] = off[w] + count[w + 1];
+
+    // Reparto estable: dentro de cada worker queda el orden de índice
+    memset(count, 0, sizeof(int) * (W + 1));
+    for (int k = 0; k < s->epoch_count; k++) {
+        int f = s->epoch_entries[k], w = s->worker_of[f];
+        b->entries[off[w] + count[w]++] = f;
+    }
+    b->num_entries += s->epoch_count;
+    s->epoch_count = 0;
+    free(count);
+    return 0;
+}
+
+static int open_epoch(Sweep *s, int tick) {
+    Balancer *b = s->b;
+    if (close_epoch(s) != 0) return -1;
+    if (b->num_epochs == s->epochs_cap) {
+        int cap = s->epochs_cap ? s->epochs_cap * 2 : 16;
+        int *start = realloc(b->epoch_start, sizeof(int) * (cap + 1));
+        int *off = realloc(b->epoch_offset, sizeof(int) * cap * (b->num_workers + 1));
+        if (start) b->epoch_start = start;
+        if (off) b->epoch_offset = off;
+        if (!start || !off) return -1;
+        s->epochs_cap = cap;
+    }
+    b->epoch_start[b->num_epochs++] = tick;
+    return 0;
+}
+
+// LPT sobre todas las figuras activas para la ventana que empieza en tick
+static int rebalance(Sweep *s, int tick) {
+    Balancer *b = s->b;
+    int W = b->num_workers;
+    if (open_epoch(s, tick) != 0) return -1;
+
+    long long total = 0;
+    for (int k = 0; k < s->num_active; k++) {
+        int f = s->active[k];
+        s->units[k].figure = f;
+        s->units[k].cost = balancer_figure_cost(s->config, f, tick, tick + BALANCE_HORIZON);
+        total += s->units[k].cost;
+    }
+    qsort(s->units, s->num_active, sizeof(Unit), cmp_unit_desc);
+
+    int n = 0;
+    for (int w = 0; w < W; w++) {
+        s->load[w] = 0;
+        heap_push(s->heap, &n, (HeapNode){0, w});
+    }
+    for (int k = 0; k < s->num_active; k++) {
+        HeapNode node = heap_pop(s->heap, &n);
+        int f = s->units[k].figure;
+        s->worker_of[f] = node.worker;
+        s->charged[f] = s->units[k].cost;
+        node.load += s->units[k].cost;
+        s->load[node.worker] = node.load;
+        b->predicted[node.worker] += s->units[k].cost;
+        heap_push(s->heap, &n, node);
+    }
+
+    long long makespan = 0;
+    for (int w = 0; w < W; w++) {
+        if (s->load[w] > makespan) makespan = s->load[w];
+    }
+    if (total > 0) {
+        b->rebalances++;
+        b->imbalance_sum += (double)makespan * W / total;
+    }
+
+    for (int k = 0; k < s->num_active; k++) s->epoch_entries[k] = s->active[k];
+    s->epoch_count = s->num_active;
+    return 0;
+}
+
+static int least_loaded(const Sweep *s) {
+    int best = 0;
+    for (int w = 1; w < s->b->num_workers; w++) {
+        if (s->load[w] < s->load[best]) best = w;
+    }
+    return best;
+}
+
+// Barre los eventos de entrada y salida abriendo épocas donde el conjunto activo cambia mucho
+static int sweep(Sweep *s, const Event *events, int num_events) {
+    // Siempre hay una época desde el tick 0, aunque empiece vacía
+    if (rebalance(s, 0) != 0) return -1;
+    int base = 0, churn = 0;
+
+    for (int k = 0; k < num_events;) {
+        int tick = events[k].tick;
+        int first_enter = -1;
+        for (; k < num_events && events[k].tick == tick; k++) {
+            int f = events[k].figure;
+            if (events[k].enter) {
+                s->active_pos[f] = s->num_active;
+                s->active[s->num_active++] = f;
+                if (first_enter < 0) first_enter = k;
+            } else {
+                int pos = s->active_pos[f];
+                int last = s->active[--s->num_active];
+                s->active[pos] = last;
+                s->active_pos[last] = pos;
+                s->active_pos[f] = -1;
+                s->load[s->worker_of[f]] -= s->charged[f];
+            }
+            churn++;
+        }
+
+        if (churn * BALANCE_CHURN_DIVISOR > base) {
+            if (rebalance(s, tick) != 0) return -1;
+            base = s->num_active;
+            churn = 0;
+            continue;
+        }
+        // Cambio chico: las que entran van al worker menos cargado
+        for (int e = first_enter; e >= 0 && e < k; e++) {
+            if (!events[e].enter) continue;
+            int f = events[e].figure, w = least_loaded(s);
+            s->worker_of[f] = w;
+            s->charged[f] = balancer_figure_cost(s->config, f, tick, tick + BALANCE_HORIZON);
+            s->load[w] += s->charged[f];
+            s->b->predicted[w] += s->charged[f];
+            if (push_entry(s, f) != 0) return -1;
+        }
+    }
+    return close_epoch(s);
+}
+
+int balancer_build(Balancer *b, const AnimationConfig *config, int num_workers) {
+    memset(b, 0, sizeof(*b));
+    int n = config->num_figures;
+    const Scene *scene = config->scene;
+    if (num_workers < 1) num_workers = 1;
+    b->num_workers = num_workers;
+    b->predicted = calloc(num_workers, sizeof(long long));
+
+    Sweep s;
+    memset(&s, 0, sizeof(s));
+    s.config = config;
+    s.b = b;
+    int cap = n > 0 ? n : 1;
+    s.active = malloc(sizeof(int) * cap);
+    s.active_pos = malloc(sizeof(int) * cap);
+    s.worker_of = malloc(sizeof(int) * cap);
+    s.charged = malloc(sizeof(long long) * cap);
+    s.units = malloc(sizeof(Unit) * cap);
+    s.load = calloc(num_workers, sizeof(long long));
+    s.heap = malloc(sizeof(HeapNode) * num_workers);
+    s.epoch_entries = malloc(sizeof(int) * cap);
+    s.epoch_cap = cap;
+    Event *events = malloc(sizeof(Event) * 2 * cap);
+
+    int status = -1;
+    if (b->predicted && s.active && s.active_pos && s.worker_of && s.charged &&
+        s.units && s.load && s.heap && s.epoch_entries && events) {
+        int num_events = 0;
+        for (int i = 0; i < n; i++) {
+            s.active_pos[i] = -1;
+            if (scene->t_end[i] < scene->t_start[i]) continue;
+            events[num_events++] = (Event){scene->t_start[i], i, 1};
+            events[num_events++] = (Event){scene->t_end[i] + 1, i, 0};
+        }
+        qsort(events, num_events, sizeof(Event), cmp_event);
+        status = sweep(&s, events, num_events);
+    }
+
+    free(events);
+    free(s.active);
+    free(s.active_pos);
+    free(s.worker_of);
+    free(s.charged);
+    free(s.units);
+    free(s.load);
+    free(s.heap);
+    free(s.epoch_entries);
+    if (status != 0) balancer_free(b);
+    return status;
+}
+
+void balancer_free(Balancer *b) {
+    free(b->epoch_start);
+    free(b->epoch_offset);
+    free(b->entries);
+    free(b->predicted);
+    memset(b, 0, sizeof(*b));
+}
+
+int balancer_epoch_at(const Balancer *b, int t) {
+    int lo = 0, hi = b->num_epochs - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (b->epoch_start[mid] <= t) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+void balancer_report(const Balancer *b, const long long *busy_ns, const long *painted,
+                     double seconds, FILE *out) {
+    long long total = 0;
+    long long busy_total = 0;
+    for (int w = 0; w < b->num_workers; w++) {
+        total += b->predicted[w];
+        busy_total += busy_ns[w];
+    }
+    fprintf(out, "[BALANCER] %d workers | %d épocas | %d rebalanceos | makespan/ideal medio %.3f\n",
+            b->num_workers, b->num_epochs, b->rebalances,
+            b->rebalances ? b->imbalance_sum / b->rebalances : 1.0);
+    for (int w = 0; w < b->num_workers; w++) {
+        fprintf(out, "[WORKER %d] costo estimado %.1f%% | %ld figuras-frame | ocupado %.2f ms "
+                "(%.1f%% del trabajo, utilización %.1f%%)\n",
+                w, total ? 100.0 * b->predicted[w] / total : 0.0, painted[w], busy_ns[w] / 1e6,
+                busy_total ? 100.0 * busy_ns[w] / busy_total : 0.0,
+                seconds > 0 ? 100.0 * busy_ns[w] / 1e9 / seconds : 0.0);
+    }
+}
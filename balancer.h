@@ -0,0 +1,66 @@
+#ifndef BALANCER_H
+#define BALANCER_H
+
+#include <stdio.h>
+#include "anim_config.h"
+
+// Costo fijo por figura y frame (sincronización, rotación, posición)
+#define BALANCE_FIGURE_OVERHEAD 16
+// Costo por casilla de la rejilla que toca el bounding box
+#define BALANCE_TILE_COST 4
+// Ventana (en ticks) sobre la que se mide la vida restante de cada figura
+#define BALANCE_HORIZON 64
+// Se rebalancea cuando entran o salen más de 1/N de las figuras activas
+#define BALANCE_CHURN_DIVISOR 4
+
+/*
+ * Reparto de figuras entre workers que minimiza el makespan estimado.
+ * El costo de una figura en una ventana es
+ *     (área + BALANCE_TILE_COST * casillas + BALANCE_FIGURE_OVERHEAD)
+ *     * ticks de su vida dentro de la ventana
+ * y cada rebalanceo asigna con LPT (más costosa primero al worker menos
+ * cargado, con un min-heap). Entre rebalanceos, las figuras que entran
+ * van al worker menos cargado y las que salen descuentan su costo.
+ *
+ * El resultado son épocas [epoch_start[e], epoch_start[e + 1]): en cada
+ * una, las figuras del worker w son entries[offset(e, w) .. offset(e, w + 1)),
+ * en orden de índice. Una entrada puede estar fuera de su vida en algún
+ * tick de la época; quien pinta lo verifica.
+ */
+typedef struct {
+    int num_workers;
+    int num_epochs;
+    int *epoch_start;
+    int *epoch_offset;           // num_epochs * (num_workers + 1)
+    int *entries;
+    int num_entries;
+
+    long long *predicted;        // costo estimado total por worker
+    int rebalances;
+    double imbalance_sum;        // makespan / carga ideal en cada rebalanceo
+} Balancer;
+
+// Costo estimado de la figura i en los ticks [t0, t1)
+long long balancer_figure_cost(const AnimationConfig *config, int i, int t0, int t1);
+
+// Calcula todas las épocas de la animación. Retorna 0 o -1.
+int balancer_build(Balancer *b, const AnimationConfig *config, int num_workers);
+void balancer_free(Balancer *b);
+
+// Época que contiene el tick t
+int balancer_epoch_at(const Balancer *b, int t);
+
+static inline const int *balancer_units(const Balancer *b, int epoch, int worker, int *count) {
+    const int *off = b->epoch_offset + (long)epoch * (b->num_workers + 1);
+    *count = off[worker + 1] - off[worker];
+    return b->entries + off[worker];
+}
+
+/*
+ * Reporta por worker el costo estimado y el tiempo ocupado medido
+ * (busy_ns), con su utilización sobre seconds de animación.
+ */
+void balancer_report(const Balancer *b, const long long *busy_ns, const long *painted,
+                     double seconds, FILE *out);
+
+#endif // BALANCER_H
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "config_parser.h"
+#include "render.h"
+
+/*
+ * Corre cada motor sobre cada escena sin terminal (stdout a /dev/null) y
+ * anota frames/s, tiempo de frame p50/p99 y memoria pico en un archivo
+ * de resultados, una línea por escena y motor, para compararlo entre
+ * versiones con diff. Los tiempos salen del reporte del reloj de frames
+ * (frame_clock.h) que cada motor imprime en stderr; la memoria es el
+ * VmHWM que test_anim reporta al salir (ru_maxrss del hijo arrastra el
+ * pico del proceso antes del exec), sin los procesos de display.
+ * Uso: bench_anim [resultados.txt] escena.json... [--engines=seq,mt,md]
+ *                 [--anim=./test_anim]
+ * En los tres motores el tiempo de frame es el de un tick completo.
+ */
+
+#define MAX_ENGINES 8
+
+typedef struct {
+    int ok;
+    double p50_us, p99_us;
+    double seconds;              // del epoch al último frame
+    long peak_kb;                // -1 si el motor no la reportó
+} RunResult;
+
+// Busca la línea de tiempo de frame del reporte del reloj
+static int parse_report(const char *text, RunResult *r) {
+    const char *mem = strstr(text, "[MEM] memoria pico");
+    if (!mem || sscanf(mem, "[MEM] memoria pico %ld KB", &r->peak_kb) != 1) r->peak_kb = -1;
+
+    const char *line = strstr(text, "[FRAME CLOCK] tiempo de frame");
+    if (!line) return -1;
+    return sscanf(line, "[FRAME CLOCK] tiempo de frame p50 %lf us | p99 %lf us | %lf s",
+                  &r->p50_us, &r->p99_us, &r->seconds) == 3 ? 0 : -1;
+}
+
+static void run_engine(const char *anim, const char *scene, const char *engine, RunResult *out) {
+    memset(out, 0, sizeof(*out));
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    if (pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+        close(fds[0]);
+        char flag[64];
+        snprintf(flag, sizeof(flag), "--engine=%s", engine);
+        execl(anim, anim, scene, flag, (char *)NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+
+    // Todo stderr del motor: el reporte está al final
+    size_t len = 0, cap = 4096;
+    char *text = malloc(cap);
+    ssize_t n;
+    while (text && (n = read(fds[0], text + len, cap - len - 1)) > 0) {
+        len += n;
+        if (cap - len < 1024) {
+            char *grown = realloc(text, cap * 2);
+            if (!grown) break;
+            text = grown;
+            cap *= 2;
+        }
+    }
+    close(fds[0]);
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0) {
+        free(text);
+        return;
+    }
+    if (text) {
+        text[len] = '\0';
+        out->ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && parse_report(text, out) == 0;
+    }
+    free(text);
+}
+
+// Retorna 1 si path parece una escena (JSON o compilada) y no el archivo de resultados
+static int is_scene(const char *path) {
+    size_t n = strlen(path);
+    return (n > 5 && strcmp(path + n - 5, ".json") == 0) ||
+           (n > 8 && strcmp(path + n - 8, ".mdscene") == 0);
+}
+
+static const char *base_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static void print_row(FILE *out, const char *scene, const char *engine, int figures,
+                      long frames, const RunResult *r) {
+    if (!r->ok) {
+        fprintf(out, "%-20s %-4s %8d %8ld %10s\n", scene, engine, figures, frames, "ERROR");
+        return;
+    }
+    char peak[32] = "-";
+    if (r->peak_kb >= 0) snprintf(peak, sizeof(peak), "%ld", r->peak_kb);
+    fprintf(out, "%-20s %-4s %8d %8ld %10.1f %10.1f %10.1f %10s\n", scene, engine, figures,
+            frames, r->seconds > 0 ? frames / r->seconds : 0.0, r->p50_us, r->p99_us, peak);
+}
+
+int main(int argc, char **argv) {
+    const char *anim = "./test_anim";
+    const char *results = NULL;
+    char engines_arg[256] = "seq,mt,md";
+    const char *scenes[256];
+    int num_scenes = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--engines=", 10) == 0) {
+            snprintf(engines_arg, sizeof(engines_arg), "%s", argv[i] + 10);
+        } else if (strncmp(argv[i], "--anim=", 7) == 0) {
+            anim = argv[i] + 7;
+        } else if (!results && !is_scene(argv[i])) {
+            results = argv[i];
+        } else if (num_scenes < (int)(sizeof(scenes) / sizeof(scenes[0]))) {
+            scenes[num_scenes++] = argv[i];
+        }
+    }
+    if (num_scenes == 0) {
+        fprintf(stderr, "Uso: bench_anim [resultados.txt] escena.json... "
+                "[--engines=seq,mt,md] [--anim=./test_anim]\n");
+        return 1;
+    }
+
+    const char *engines[MAX_ENGINES];
+    int num_engines = 0;
+    for (char *e = strtok(engines_arg, ","); e && num_engines < MAX_ENGINES; e = strtok(NULL, ",")) {
+        engines[num_engines++] = e;
+    }
+
+    FILE *out = results ? fopen(results, "w") : NULL;
+    if (results && !out) {
+        perror(results);
+        return 1;
+    }
+    const char *header = "# escena              motor  figuras   frames   frames/s    p50(us)    p99(us)  RSS(KB)\n";
+    printf("%s", header);
+    if (out) fputs(header, out);
+
+    int failures = 0;
+    for (int s = 0; s < num_scenes; s++) {
+        // Frames que presenta cada motor: todos los ticks de todas las vueltas
+        AnimationConfig *config = load_config(scenes[s]);
+        if (!config) {
+            failures++;
+            continue;
+        }
+        int figures = config->num_figures;
+        long frames = (long)(render_max_time(config) + 1) * config->loops;
+        free_config(config);
+
+        for (int e = 0; e < num_engines; e++) {
+            RunResult r;
+            run_engine(anim, scenes[s], engines[e], &r);
+            failures += !r.ok;
+            print_row(stdout, base_name(scenes[s]), engines[e], figures, frames, &r);
+            if (out) print_row(out, base_name(scenes[s]), engines[e], figures, frames, &r);
+            fflush(stdout);
+        }
+    }
+    if (out) fclose(out);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "render.h"
+#include "trajectory.h"
+
+/*
+ * Mide solo el rasterizado: recorre los ticks de la escena y copia cada
+ * figura activa al canvas con render_blit, una vez con los kernels por
+ * ancho (render.c) y otra con el bucle genérico, sin rejilla ni salida.
+ * Reporta ns por figura de cada camino y comprueba que ambos dejen los
+ * mismos canvas (hash de celdas y atributos de todos los ticks).
+ * Uso: bench_blit [config.json] [repeticiones]
+ */
+
+typedef struct {
+    double seconds;              // mejor de las repeticiones
+    long long blits;             // figuras copiadas por pasada
+    long long painted;           // celdas pintadas por pasada
+    unsigned long long hash;
+} BlitResult;
+
+static unsigned long long hash_bytes(unsigned long long h, const unsigned char *p, size_t n) {
+    for (size_t k = 0; k < n; k++) h = (h ^ p[k]) * 1099511628211ULL;
+    return h;
+}
+
+static int run_pass(const AnimationConfig *config, int kernels, int reps, BlitResult *out) {
+    const Scene *scene = config->scene;
+    int width = config->canvas.width, height = config->canvas.height;
+    size_t cells = (size_t)width * height;
+    int max_time = render_max_time(config);
+
+    char *canvas = malloc(cells);
+    unsigned char *attrs = scene->colored ? malloc(cells) : NULL;
+    TrajectoryState st;
+    if (!canvas || (scene->colored && !attrs) || trajectory_state_init(&st, config->trajectory, 0) != 0) {
+        free(canvas);
+        free(attrs);
+        return -1;
+    }
+    FrameBuffer fb = {canvas, width, height, width, attrs};
+
+    render_blit_kernels = kernels;
+    memset(out, 0, sizeof(*out));
+    out->seconds = -1;
+    for (int r = 0; r < reps; r++) {
+        trajectory_seek(&st, 0);
+        long long blits = 0, painted = 0;
+        unsigned long long hash = 14695981039346656037ULL;
+        double seconds = 0;
+        for (int t = 0; t <= max_time; t++) {
+            memset(canvas, ' ', cells);
+            if (attrs) memset(attrs, 0, cells);
+
+            long long start = frame_clock_now_ns();
+            for (int i = 0; i < scene->num_figures; i++) {
+                if (t < scene->t_start[i] || t > scene->t_end[i]) continue;
+                painted += render_blit(scene, i, t, (Position){st.x[i], st.y[i]}, &fb);
+                blits++;
+            }
+            seconds += (frame_clock_now_ns() - start) / 1e9;
+
+            hash = hash_bytes(hash, (const unsigned char *)canvas, cells);
+            if (attrs) hash = hash_bytes(hash, attrs, cells);
+            if (t < max_time) trajectory_step(&st);
+        }
+        if (out->seconds < 0 || seconds < out->seconds) out->seconds = seconds;
+        out->blits = blits;
+        out->painted = painted;
+        out->hash = hash;
+    }
+    render_blit_kernels = 1;
+
+    trajectory_state_free(&st);
+    free(canvas);
+    free(attrs);
+    return 0;
+}
+
+static void report(const char *name, const BlitResult *r) {
+    double per_blit = r->blits > 0 ? r->seconds * 1e9 / r->blits : 0.0;
+    printf("%-8s %8.3f s | %8.1f ns/figura | %lld figuras, %lld celdas pintadas\n",
+           name, r->seconds, per_blit, r->blits, r->painted);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "config.json";
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+    if (reps <= 0) reps = 1;
+
+    AnimationConfig *config = load_config(path);
+    if (!config) {
+        fprintf(stderr, "No se pudo cargar %s\n", path);
+        return 1;
+    }
+    printf("%s: %d figuras, canvas %dx%d, %d ticks, mejor de %d\n", path, config->num_figures,
+           config->canvas.width, config->canvas.height, render_max_time(config) + 1, reps);
+
+    BlitResult kernel, generic;
+    if (run_pass(config, 1, reps, &kernel) != 0 || run_pass(config, 0, reps, &generic) != 0) {
+        fprintf(stderr, "Sin memoria para el canvas\n");
+        free_config(config);
+        return 1;
+    }
+    report("kernels", &kernel);
+    report("generico", &generic);
+
+    int same = kernel.hash == generic.hash && kernel.painted == generic.painted;
+    printf("Aceleración %.2fx | canvas %s\n",
+           kernel.seconds > 0 ? generic.seconds / kernel.seconds : 0.0,
+           same ? "idénticos" : "DISTINTOS");
+    free_config(config);
+    return same ? 0 : 1;
+}
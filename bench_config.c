@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "scene.h"
+
+/*
+ * Compara los dos lectores de configuración sobre el mismo archivo:
+ *   stream  → load_config, por eventos (json_stream.h), con el pool de carga
+ *   stream1 → load_config con un solo hilo
+ *   cjson   → load_config_cjson, archivo entero + árbol DOM
+ * Cada uno corre en su propio proceso para que la memoria pico (ru_maxrss)
+ * no se mezcle. Reporta MB/s, memoria pico y si los modelos coinciden.
+ * Uso: bench_config [config.json] [repeticiones] [hilos]
+ */
+
+typedef struct {
+    int ok;
+    double seconds;              // mejor de las repeticiones
+    long base_kb, peak_kb;       // RSS antes de cargar y pico del proceso
+    unsigned long long hash;
+    int num_figures, num_sprites, atlas_size;
+} LoadResult;
+
+typedef AnimationConfig *(*Loader)(const char *filename);
+
+static long max_rss_kb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+static void run_loader(Loader loader, const char *path, int reps, LoadResult *out) {
+    memset(out, 0, sizeof(*out));
+    out->base_kb = max_rss_kb();
+    out->seconds = -1;
+    for (int r = 0; r < reps; r++) {
+        long long start = frame_clock_now_ns();
+        AnimationConfig *config = loader(path);
+        double seconds = (frame_clock_now_ns() - start) / 1e9;
+        if (!config) return;
+        if (out->seconds < 0 || seconds < out->seconds) out->seconds = seconds;
+        out->hash = config->hash;
+        out->num_figures = config->num_figures;
+        out->num_sprites = config->scene->sprites.num_sprites;
+        out->atlas_size = config->scene->atlas_size;
+        free_config(config);
+    }
+    out->peak_kb = max_rss_kb();
+    out->ok = 1;
+}
+
+// Corre el lector en un hijo y recibe el resultado por un pipe
+static int measure(Loader loader, int threads, const char *path, int reps, LoadResult *out) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        LoadResult result;
+        config_set_load_threads(threads);
+        run_loader(loader, path, reps, &result);
+        ssize_t n = write(fds[1], &result, sizeof(result));
+        _exit(n == (ssize_t)sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t n = read(fds[0], out, sizeof(*out));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return n == (ssize_t)sizeof(*out) && out->ok ? 0 : -1;
+}
+
+static void report(const char *name, double mb, const LoadResult *r) {
+    printf("%-7s %8.1f MB/s | %8.3f s | RSS pico %ld KB (%+ld KB al cargar) | "
+           "%d figuras, %d sprites\n",
+           name, r->seconds > 0 ? mb / r->seconds : 0.0, r->seconds,
+           r->peak_kb, r->peak_kb - r->base_kb, r->num_figures, r->num_sprites);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "config.json";
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+    if (reps <= 0) reps = 1;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+    double mb = st.st_size / (1024.0 * 1024.0);
+    printf("%s: %.2f MB, mejor de %d\n", path, mb, reps);
+
+    static const char *names[] = {"stream", "stream1", "cjson"};
+    LoadResult results[3];
+    int ok = measure(load_config, threads, path, reps, &results[0]) == 0 &&
+             measure(load_config, 1, path, reps, &results[1]) == 0 &&
+             measure(load_config_cjson, 1, path, reps, &results[2]) == 0;
+    if (!ok) {
+        printf("Alguna carga falló\n");
+        return 1;
+    }
+    int same = 1;
+    for (int k = 0; k < 3; k++) {
+        report(names[k], mb, &results[k]);
+        same = same && results[k].hash == results[0].hash &&
+               results[k].num_figures == results[0].num_figures &&
+               results[k].num_sprites == results[0].num_sprites &&
+               results[k].atlas_size == results[0].atlas_size;
+    }
+    printf("Modelos %s\n", same ? "iguales" : "DISTINTOS");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "frame_encoder.h"
+#include "render.h"
+#include "shm_ring.h"
+
+/*
+ * Compara los dos caminos de un frame hacia otro proceso:
+ *   pipe → repintada completa por un pipe, como el stdout de animator_mt.c
+ *   shm  → canvas pintado directo en un slot del anillo compartido
+ * Reporta frames/s del productor y latencia publicación → lectura.
+ * Uso: bench_transport [config.json] [frames]
+ */
+
+typedef struct {
+    long frames;
+    double avg_us, p50_us, p99_us, max_us;
+} LatencyStats;
+
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void summarize(long long *lat, long n, LatencyStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->frames = n;
+    if (n == 0) return;
+    long long sum = 0;
+    for (long k = 0; k < n; k++) sum += lat[k];
+    qsort(lat, n, sizeof(long long), cmp_ll);
+    out->avg_us = sum / (double)n / 1e3;
+    out->p50_us = lat[n / 2] / 1e3;
+    out->p99_us = lat[n * 99 / 100] / 1e3;
+    out->max_us = lat[n - 1] / 1e3;
+}
+
+static int read_full(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n == 0) return 0;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 1;
+}
+
+static int write_full(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Cada mensaje del pipe: {bytes, instante de envío} y la repintada
+typedef struct {
+    long long len;
+    long long sent_ns;
+} PipeFrame;
+
+static void pipe_reader(int in, int result, long max_frames) {
+    long long *lat = malloc(sizeof(long long) * max_frames);
+    char *buf = NULL;
+    size_t cap = 0;
+    long n = 0;
+    PipeFrame msg;
+    while (n < max_frames && read_full(in, &msg, sizeof(msg)) == 1) {
+        if ((size_t)msg.len > cap) {
+            cap = msg.len;
+            buf = realloc(buf, cap);
+        }
+        if (read_full(in, buf, msg.len) != 1) break;
+        lat[n++] = frame_clock_now_ns() - msg.sent_ns;
+    }
+    LatencyStats stats;
+    summarize(lat, n, &stats);
+    write_full(result, &stats, sizeof(stats));
+    _exit(0);
+}
+
+static volatile unsigned checksum;  // evita que el compilador descarte la lectura del slot
+
+static void shm_reader(ShmRing *ring, int result, long max_frames) {
+    ring->owner = 0;
+    long long *lat = malloc(sizeof(long long) * max_frames);
+    int size = ring->header->width * ring->header->height;
+    unsigned sum = 0;
+    long n = 0;
+    uint64_t last = 0, seq;
+    while (n < max_frames && (seq = shm_ring_wait(ring, last, -1)) != 0) {
+        last = seq;
+        ShmRingSlot *slot = shm_ring_slot(ring, seq);
+        long long now = frame_clock_now_ns();
+        const char *cells = shm_ring_cells(slot);
+        for (int k = 0; k < size; k++) sum += (unsigned char)cells[k];  // leer el frame en el slot
+        if (shm_ring_still_valid(ring, seq)) lat[n++] = now - slot->publish_ns;
+        shm_ring_release(ring, 0, seq);
+    }
+    shm_ring_release(ring, 0, UINT64_MAX);
+    LatencyStats stats;
+    summarize(lat, n, &stats);
+    checksum = sum;
+    write_full(result, &stats, sizeof(stats));
+    _exit(0);
+}
+
+static double bench_pipe(const AnimationConfig *config, int max_time, long frames,
+                         LatencyStats *stats) {
+    int w = config->canvas.width, h = config->canvas.height;
+    int data[2], result[2];
+    if (pipe(data) != 0 || pipe(result) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(data[1]);
+        close(result[0]);
+        pipe_reader(data[0], result[1], frames);
+    }
+    close(data[0]);
+    close(result[1]);
+
+    char *cells = malloc((size_t)w * h);
+    ByteBuffer out;
+    bytebuf_init(&out);
+    long long start = frame_clock_now_ns();
+    for (long f = 0; f < frames; f++) {
+        render_frame(config, (int)(f % (max_time + 1)), cells, NULL);
+        bytebuf_reset(&out);
+        encode_full_frame(cells, w, h, &out);
+        PipeFrame msg = {(long long)out.len, frame_clock_now_ns()};
+        if (write_full(data[1], &msg, sizeof(msg)) != 0 ||
+            write_full(data[1], out.data, out.len) != 0) break;
+    }
+    close(data[1]);
+    read_full(result[0], stats, sizeof(*stats));
+    double seconds = (frame_clock_now_ns() - start) / 1e9;
+    close(result[0]);
+    waitpid(pid, NULL, 0);
+    bytebuf_free(&out);
+    free(cells);
+    return seconds;
+}
+
+static double bench_shm(const AnimationConfig *config, int max_time, long frames,
+                        LatencyStats *stats) {
+    int w = config->canvas.width, h = config->canvas.height;
+    char name[64];
+    snprintf(name, sizeof(name), "/mda_bench_%d", (int)getpid());
+    ShmRing ring;
+    if (shm_ring_create(&ring, name, w, h, SHM_RING_DEFAULT_SLOTS, 1) != 0) return -1;
+    int result[2];
+    if (pipe(result) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(result[0]);
+        shm_reader(&ring, result[1], frames);
+    }
+    close(result[1]);
+
+    long long start = frame_clock_now_ns();
+    for (long f = 0; f < frames; f++) {
+        int t = (int)(f % (max_time + 1));
+        render_frame(config, t, shm_ring_begin_write(&ring, t, 1000), NULL);
+        shm_ring_publish(&ring);
+    }
+    shm_ring_finish(&ring);
+    read_full(result[0], stats, sizeof(*stats));
+    double seconds = (frame_clock_now_ns() - start) / 1e9;
+    close(result[0]);
+    waitpid(pid, NULL, 0);
+    shm_ring_close(&ring);
+    return seconds;
+}
+
+static void report(const char *name, long frames, double seconds, const LatencyStats *s) {
+    printf("%-5s %8.0f frames/s | %ld/%ld frames leídos | latencia µs: media %.1f, "
+           "p50 %.1f, p99 %.1f, máx %.1f\n",
+           name, seconds > 0 ? frames / seconds : 0.0, s->frames, frames,
+           s->avg_us, s->p50_us, s->p99_us, s->max_us);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "config.json";
+    long frames = argc > 2 ? atol(argv[2]) : 20000;
+    if (frames <= 0) frames = 1;
+
+    AnimationConfig *config = load_config(path);
+    if (!config) {
+        fprintf(stderr, "Error cargando la configuración\n");
+        return 1;
+    }
+    int max_time = render_max_time(config);
+    printf("Canvas %d x %d, %ld frames\n", config->canvas.width, config->canvas.height, frames);
+
+    LatencyStats stats;
+    double seconds = bench_pipe(config, max_time, frames, &stats);
+    if (seconds >= 0) report("pipe", frames, seconds, &stats);
+    seconds = bench_shm(config, max_time, frames, &stats);
+    if (seconds >= 0) report("shm", frames, seconds, &stats);
+
+    free_config(config);
+    return 0;
+}
@@ -0,0 +1,881 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "anim_utils.h"
+#include "collision.h"
+#include "config_parser.h"
+#include "frame_encoder.h"
+#include "json_stream.h"
+#include "recording.h"
+#include "render.h"
+#include "scene.h"
+#include "scene_file.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+
+/*
+ * Pruebas de comportamiento de los módulos del animador sobre escenas
+ * generadas con scene_gen (make check las arma en check/). Cada prueba
+ * compara un camino rápido contra la versión directa y más lenta del
+ * mismo cálculo. Sale con 1 si alguna falla.
+ * Uso: check_anim [directorio]
+ */
+
+static int checks, failures;
+
+#define CHECK(cond, ...)                                              \
+    do {                                                              \
+        checks++;                                                     \
+        if (!(cond)) {                                                \
+            failures++;                                               \
+            fprintf(stderr, "FALLO %s:%d: ", __FILE__, __LINE__);     \
+            fprintf(stderr, __VA_ARGS__);                             \
+            fprintf(stderr, "\n");                                    \
+        }                                                             \
+    } while (0)
+
+static AnimationConfig *load_fixture(const char *dir, const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    AnimationConfig *config = load_config(path);
+    CHECK(config != NULL, "no se pudo cargar %s", path);
+    return config;
+}
+
+/*
+ * frame_seeker_render(t) contra la reproducción en orden, en ticks al
+ * azar: celdas y atributos, en los dos modos y con snapshots densos y
+ * espaciados.
+ */
+static void check_frame_seeker(const char *dir) {
+    AnimationConfig *config = load_fixture(dir, "seek.json");
+    if (!config) return;
+    size_t cells = (size_t)config->canvas.width * config->canvas.height;
+    int frames = render_max_time(config) + 1;
+    CHECK(config->scene->colored, "seek.json debería tener color");
+
+    // Todos los frames en orden, para cada modo
+    char *seq = malloc(cells * frames);
+    unsigned char *seq_attrs = malloc(cells * frames);
+    char *out = malloc(cells);
+    unsigned char *out_attrs = malloc(cells);
+    if (!seq || !seq_attrs || !out || !out_attrs) {
+        CHECK(0, "sin memoria");
+        frames = 0;
+    }
+
+    static const RenderMode modes[] = {RENDER_CLEAR, RENDER_ACCUMULATE, RENDER_ACCUMULATE};
+    long budgets[] = {0, 0, (long)(frames / 10 + 1) * 2 * (long)cells};
+    for (int m = 0; frames > 0 && m < 3; m++) {
+        memset(seq, ' ', cells);
+        memset(seq_attrs, 0, cells);
+        for (int t = 0; t < frames; t++) {
+            char *c = seq + (size_t)t * cells;
+            unsigned char *a = seq_attrs + (size_t)t * cells;
+            if (modes[m] == RENDER_CLEAR) {
+                render_frame(config, t, c, a);
+                continue;
+            }
+            if (t > 0) {
+                memcpy(c, c - cells, cells);
+                memcpy(a, a - cells, cells);
+            }
+            render_paint(config, t, c, a);
+        }
+
+        FrameSeeker seeker;
+        if (frame_seeker_init(&seeker, config, modes[m], budgets[m]) != 0) {
+            CHECK(0, "frame_seeker_init falló (modo %d)", m);
+            continue;
+        }
+        srand(1234 + m);
+        for (int k = 0; k < 64; k++) {
+            int t = k == 0 ? frames - 1 : rand() % frames;
+            frame_seeker_render(&seeker, t, out, out_attrs);
+            CHECK(memcmp(out, seq + (size_t)t * cells, cells) == 0,
+                  "celdas distintas en t=%d (modo %d, intervalo %d)", t, m, seeker.interval);
+            CHECK(memcmp(out_attrs, seq_attrs + (size_t)t * cells, cells) == 0,
+                  "atributos distintos en t=%d (modo %d, intervalo %d)", t, m, seeker.interval);
+        }
+        frame_seeker_free(&seeker);
+    }
+
+    free(seq);
+    free(seq_attrs);
+    free(out);
+    free(out_attrs);
+    free_config(config);
+}
+
+static int random_in(int lo, int hi) {
+    return lo + rand() % (hi - lo + 1);
+}
+
+/*
+ * grid_query contra la prueba de todos los pares con rect_intersects, en
+ * un mundo chico y en uno que obliga a agrandar la casilla. Con la
+ * consulta dentro del mundo el resultado es exacto; si se sale, queda
+ * entre lo que se ve dentro del mundo y lo que se vería sin recortar.
+ * Después, grid_build sobre world.json contra las figuras vivas del tick.
+ */
+static void check_spatial_grid(const char *dir) {
+    static const int sizes[][3] = {{50, 30, 8}, {200000, 90000, 8}};
+    enum { FIGURES = 400 };
+    Rect rects[FIGURES];
+    int active[FIGURES], out[FIGURES];
+    srand(26);
+    for (int s = 0; s < 2; s++) {
+        int width = sizes[s][0], height = sizes[s][1];
+        int big = width / 10 > 12 ? width / 10 : 12;
+        SpatialGrid g;
+        if (grid_init(&g, width, height, sizes[s][2], FIGURES / 2) != 0 || grid_reserve(&g, FIGURES) != 0) {
+            CHECK(0, "grid_init %dx%d falló", width, height);
+            continue;
+        }
+        CHECK((long long)g.cols * g.rows <= GRID_MAX_CELLS, "%dx%d: %d x %d casillas", width, height,
+              g.cols, g.rows);
+
+        for (int round = 0; round < 20; round++) {
+            grid_clear(&g);
+            Rect area = {0, 0, width, height};
+            for (int i = 0; i < FIGURES; i++) {
+                int w = random_in(1, round % 2 ? big : 6), h = random_in(1, round % 2 ? big : 6);
+                rects[i] = (Rect){random_in(-w - 2, width + 2), random_in(-h - 2, height + 2), w, h};
+                active[i] = rand() % 7 != 0;  // no todas las figuras están activas
+                if (active[i]) CHECK(grid_insert(&g, i, rects[i]) == 0, "grid_insert(%d) falló", i);
+            }
+
+            for (int q = 0; q < 50; q++) {
+                int w = random_in(1, big * 2), h = random_in(1, big * 2);
+                int inside = q % 2 == 0;
+                Rect r = inside ? (Rect){random_in(0, width - 1), random_in(0, height - 1), w, h}
+                                : (Rect){random_in(-w, width), random_in(-h, height), w, h};
+                if (inside) {
+                    if (r.x + r.w > width) r.w = width - r.x;
+                    if (r.y + r.h > height) r.h = height - r.y;
+                }
+                int n = grid_query(&g, r, out, FIGURES);
+                int ascending = 1;
+                for (int k = 1; k < n; k++) ascending = ascending && out[k - 1] < out[k];
+                CHECK(ascending, "grid_query no devolvió ids ascendentes sin repetir");
+
+                Rect seen = r;  // lo que la consulta ve dentro del mundo
+                if (seen.x < 0) { seen.w += seen.x; seen.x = 0; }
+                if (seen.y < 0) { seen.h += seen.y; seen.y = 0; }
+                if (seen.x + seen.w > width) seen.w = width - seen.x;
+                if (seen.y + seen.h > height) seen.h = height - seen.y;
+                int m = 0, missing = 0, extra = 0, k = 0;
+                for (int i = 0; i < FIGURES; i++) {
+                    if (!active[i] || !rect_intersects(rects[i], area)) continue;
+                    int in_world = seen.w > 0 && seen.h > 0 && rect_intersects(rects[i], seen);
+                    int found = k < n && out[k] == i;
+                    if (found) k++;
+                    m += in_world;
+                    missing += in_world && !found;
+                    extra += found && (inside ? !in_world : !rect_intersects(rects[i], r));
+                }
+                CHECK(k == n && missing == 0 && extra == 0,
+                      "%dx%d: consulta (%d,%d %dx%d): %d de %d, faltan %d, sobran %d", width, height,
+                      r.x, r.y, r.w, r.h, n, m, missing, extra);
+            }
+        }
+        grid_free(&g);
+    }
+
+    AnimationConfig *config = load_fixture(dir, "world.json");
+    if (!config) return;
+    const Scene *s = config->scene;
+    int width = config->world.width, height = config->world.height;
+    int nf = s->num_figures, max_time = render_max_time(config);
+    int *found = malloc(sizeof(int) * (nf > 0 ? nf : 1));
+    SpatialGrid g;
+    TrajectoryState st;
+    if (!found || grid_init(&g, width, height, GRID_CELL_SIZE, nf) != 0) {
+        CHECK(0, "sin memoria");
+        free(found);
+        free_config(config);
+        return;
+    }
+    if (trajectory_state_init(&st, config->trajectory, 0) != 0) {
+        CHECK(0, "sin memoria");
+    } else {
+        Rect area = {0, 0, width, height};
+        int mismatched = 0;
+        for (int t = 0; t <= max_time; t += 7) {
+            trajectory_seek(&st, t);
+            grid_build(&g, config, &st);
+            int n = grid_query(&g, area, found, nf), k = 0, m = 0;
+            for (int i = 0; i < nf; i++) {
+                Rect r = {st.x[i], st.y[i], s->cols[i], s->rows[i]};
+                if (t < s->t_start[i] || t > s->t_end[i] || !rect_intersects(r, area)) continue;
+                m++;
+                if (k < n && found[k] == i) k++;
+            }
+            mismatched += k != n || n != m;
+        }
+        CHECK(mismatched == 0, "world.json: grid_build difiere en %d ticks", mismatched);
+        trajectory_state_free(&st);
+    }
+    grid_free(&g);
+    free(found);
+    free_config(config);
+}
+
+/*
+ * El DDA de trajectory_step y trajectory_seek contra interpolate_position
+ * (alpha en float, truncado) en todos los ticks. far.json tiene recorridos
+ * y duraciones largos, donde el float se aparta más seguido del cociente
+ * exacto.
+ */
+static void check_trajectory(const char *dir) {
+    static const char *fixtures[] = {"seek.json", "paths.json", "far.json"};
+    for (size_t n = 0; n < sizeof(fixtures) / sizeof(fixtures[0]); n++) {
+        AnimationConfig *config = load_fixture(dir, fixtures[n]);
+        if (!config) continue;
+        const Trajectory *tr = config->trajectory;
+        int max_time = render_max_time(config);
+        TrajectoryState st;
+        if (trajectory_state_init(&st, tr, 0) != 0) {
+            CHECK(0, "sin memoria");
+            free_config(config);
+            continue;
+        }
+
+        long wrong = 0;
+        srand(99);
+        for (int t = 0; t <= max_time + 1; t++) {
+            for (int i = 0; i < config->num_figures; i++) {
+                const Figure *f = &config->figures[i];
+                Position p = trajectory_position_at(tr, i, t);
+                Position ref = f->path ? p : interpolate_position(f->pos0, f->pos1, t, f->t_start, f->t_end);
+                if (p.x != ref.x || p.y != ref.y || st.x[i] != p.x || st.y[i] != p.y) {
+                    if (wrong++ == 0) {
+                        CHECK(0, "%s: figura %d en t=%d: DDA (%d,%d), tabla (%d,%d), float (%d,%d)",
+                              fixtures[n], i, t, st.x[i], st.y[i], p.x, p.y, ref.x, ref.y);
+                    }
+                }
+            }
+            checks++;
+            if (rand() % 16 == 0) trajectory_seek(&st, t + 1);  // saltar también debe coincidir
+            else trajectory_step(&st);
+        }
+        CHECK(wrong == 0, "%s: %ld posiciones distintas", fixtures[n], wrong);
+        trajectory_state_free(&st);
+        free_config(config);
+    }
+}
+
+// Misma escena desde los dos lectores: figuras, glifos, trayectorias y cámaras
+static void check_same_scene(const char *name, const AnimationConfig *a, const AnimationConfig *b) {
+    const Scene *sa = a->scene, *sb = b->scene;
+    CHECK(sa->num_figures == sb->num_figures, "%s: %d figuras contra %d", name, sa->num_figures,
+          sb->num_figures);
+    CHECK(a->num_viewports == b->num_viewports && a->num_pan_keys == b->num_pan_keys,
+          "%s: viewports distintos", name);
+    for (int i = 0; i < sa->num_figures && i < sb->num_figures; i++) {
+        int same = sa->t_start[i] == sb->t_start[i] && sa->t_end[i] == sb->t_end[i] &&
+                   sa->rows[i] == sb->rows[i] && sa->cols[i] == sb->cols[i] &&
+                   sa->attr[i] == sb->attr[i];
+        for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+            const char *ga = scene_glyph(sa, i, k), *gb = scene_glyph(sb, i, k);
+            size_t size = (size_t)sa->rows[i] * (sa->cols[i] + 1);
+            same = same && (ga == NULL) == (gb == NULL) && (!ga || memcmp(ga, gb, size) == 0);
+        }
+        for (int t = sa->t_start[i]; same && t <= sa->t_end[i]; t++) {
+            Position pa = trajectory_position_at(a->trajectory, i, t);
+            Position pb = trajectory_position_at(b->trajectory, i, t);
+            same = pa.x == pb.x && pa.y == pb.y;
+        }
+        CHECK(same, "%s: la figura %d difiere entre los lectores", name, i);
+    }
+}
+
+static int write_text(const char *path, const char *text) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    int ok = fputs(text, f) >= 0;
+    return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+/*
+ * json_stream sobre JSON mal formado: el error lleva el byte donde empieza
+ * el token culpable. Cada caso se repite con espacios delante para que el
+ * token quede partido entre dos bloques del buffer.
+ */
+static void check_json_stream(const char *dir) {
+    static const struct {
+        const char *text;
+        long long offset;
+        const char *message;
+    } bad[] = {
+        {"{\"a\": 1,}", 8, "'}' inesperado"},
+        {"[1 2]", 3, "se esperaba ',' o ']'"},
+        {"{\"a\" 1}", 5, "se esperaba ':'"},
+        {"{\n  \"a\": 1\n  \"b\": 2\n}", 13, "se esperaba ',' o '}'"},
+        {"[1, tru]", 4, "se esperaba 'true'"},
+        {"\"abc", 0, "cadena sin cerrar"},
+        {"[\"a\\qb\"]", 4, "escape inválido"},
+        {"[\"\\u12G4\"]", 6, "escape \\u inválido"},
+        {"[1] 2", 4, "datos después del valor raíz"},
+        {"[1,", 3, "fin de archivo inesperado"},
+        {"[-]", 1, "número inválido"},
+        {"{\"a\":[1,2,@]}", 10, "carácter inesperado '@'"},
+        {"[1]]", 3, "datos después del valor raíz"},
+    };
+    static const long long pads[] = {0, JSON_STREAM_BUFFER - 3};
+    char path[512];
+    snprintf(path, sizeof(path), "%s/bad_stream.json", dir);
+
+    for (size_t p = 0; p < sizeof(pads) / sizeof(pads[0]); p++) {
+        for (size_t n = 0; n < sizeof(bad) / sizeof(bad[0]); n++) {
+            FILE *f = fopen(path, "w");
+            if (!f) {
+                CHECK(0, "no se pudo escribir %s", path);
+                return;
+            }
+            for (long long i = 0; i < pads[p]; i++) fputc(' ', f);
+            fputs(bad[n].text, f);
+            fclose(f);
+
+            JsonStream js;
+            if (json_stream_open(&js, path) != 0) {
+                CHECK(0, "%s", js.error);
+                continue;
+            }
+            JsonEvent ev;
+            while ((ev = json_next(&js)) != JSON_ERROR && ev != JSON_EOF) {
+            }
+            char expected[600];
+            snprintf(expected, sizeof(expected), "%s:%lld: ", path, pads[p] + bad[n].offset);
+            CHECK(ev == JSON_ERROR, "se aceptó %s", bad[n].text);
+            CHECK(ev != JSON_ERROR || (strncmp(js.error, expected, strlen(expected)) == 0 &&
+                                       strstr(js.error, bad[n].message)),
+                  "%s: se esperaba \"%s%s\" y vino \"%s\"", bad[n].text, expected, bad[n].message,
+                  js.error);
+            json_stream_close(&js);
+        }
+    }
+    remove(path);
+}
+
+/*
+ * load_config (por eventos) y load_config_cjson aceptan las mismas
+ * escenas con el mismo resultado, y rechazan las mismas figuras mal
+ * formadas en lugar de cargarlas a medias.
+ */
+static void check_config_loaders(const char *dir) {
+    static const char *fixtures[] = {"seek.json", "paths.json", "world.json"};
+    char path[512];
+    for (size_t n = 0; n < sizeof(fixtures) / sizeof(fixtures[0]); n++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, fixtures[n]);
+        AnimationConfig *a = load_config(path);
+        AnimationConfig *b = load_config_cjson(path);
+        CHECK(a && b, "%s: no cargó con los dos lectores", path);
+        if (a && b) check_same_scene(fixtures[n], a, b);
+        if (a) free_config(a);
+        if (b) free_config(b);
+    }
+
+    // Claves de la figura, o de la raíz (las que empiezan con '!')
+    static const char *bad[] = {
+        "\"rotations\": {\"0\": 5}",
+        "\"rotations\": {\"0\": [\"ab\", 3]}",
+        "\"rotations\": [\"ab\"]",
+        "\"path\": [{\"t\": 0, \"x\": 1, \"y\": 1}, {\"t\": 9, \"x\": 4}]",
+        "\"path\": {\"t\": 0}",
+        "!\"frame_cache\": {\"budget_bytes\": 1e300},",
+        "!\"frame_cache\": {\"budget_bytes\": -4096},",
+        "!\"frame_cache\": {\"budget_bytes\": 1024.5},",
+    };
+    snprintf(path, sizeof(path), "%s/bad.json", dir);
+    for (size_t n = 0; n < sizeof(bad) / sizeof(bad[0]); n++) {
+        char text[512];
+        int root = bad[n][0] == '!';
+        snprintf(text, sizeof(text),
+                 "{%s \"num_figures\": 1, \"canvas\": {\"width\": 10, \"height\": 5}, \"figures\": "
+                 "[{\"t_start\": 0, \"t_end\": 9, \"pos0\": {\"x\": 0, \"y\": 0}, "
+                 "\"pos1\": {\"x\": 5, \"y\": 2}, \"rows\": 1, \"cols\": 2%s%s}]}\n",
+                 root ? bad[n] + 1 : "", root ? "" : ", ", root ? "" : bad[n]);
+        if (write_text(path, text) != 0) {
+            CHECK(0, "no se pudo escribir %s", path);
+            return;
+        }
+        fprintf(stderr, "[check] se espera un error de cada lector:\n");
+        AnimationConfig *a = load_config(path);
+        AnimationConfig *b = load_config_cjson(path);
+        CHECK(!a, "el lector por eventos aceptó %s", bad[n]);
+        CHECK(!b, "load_config_cjson aceptó %s", bad[n]);
+        if (a) free_config(a);
+        if (b) free_config(b);
+    }
+    remove(path);
+}
+
+/*
+ * Terminal mínima para decodificar lo que escriben los codificadores:
+ * caracteres, '\n', "\033[2J", "\033[f;cH" y los SGR que emite
+ * append_sgr. Lo desconocido marca la terminal como inválida.
+ */
+typedef struct {
+    char *cells;
+    unsigned char *attrs;
+    int width, height;
+    int row, col;
+    unsigned char state;
+    int invalid;
+} Terminal;
+
+static void terminal_sgr(Terminal *term, int p) {
+    unsigned char s = term->state;
+    if (p == 0) s = 0;
+    else if (p == 1) s |= ATTR_BOLD;
+    else if (p == 22) s &= ~ATTR_BOLD;
+    else if (p == 4) s |= ATTR_UNDERLINE;
+    else if (p == 24) s &= ~ATTR_UNDERLINE;
+    else if (p == 39) s &= ~ATTR_COLOR_MASK;
+    else if (p >= 30 && p <= 37) s = (s & ~ATTR_COLOR_MASK) | (p - 29);
+    else if (p >= 90 && p <= 97) s = (s & ~ATTR_COLOR_MASK) | (p - 81);
+    else term->invalid = 1;
+    term->state = s;
+}
+
+static void terminal_feed(Terminal *term, const char *data, size_t len) {
+    for (size_t i = 0; i < len && !term->invalid; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            term->row++;
+            term->col = 0;
+        } else if (c == '\033') {
+            int params[8] = {0}, n = 0;
+            if (++i >= len || data[i] != '[') term->invalid = 1;
+            for (i++; i < len && !term->invalid; i++) {
+                if (data[i] >= '0' && data[i] <= '9') params[n] = params[n] * 10 + data[i] - '0';
+                else if (data[i] == ';' && n < 7) n++;
+                else break;
+            }
+            char cmd = i < len ? data[i] : 0;
+            if (cmd == 'm') {
+                for (int k = 0; k <= n; k++) terminal_sgr(term, params[k]);
+            } else if (cmd == 'H') {
+                term->row = n > 0 ? params[0] - 1 : 0;
+                term->col = n > 0 ? params[1] - 1 : 0;
+            } else if (cmd == 'J' && params[0] == 2) {
+                memset(term->cells, ' ', (size_t)term->width * term->height);
+                memset(term->attrs, 0, (size_t)term->width * term->height);
+            } else {
+                term->invalid = 1;
+            }
+        } else if (term->row < term->height && term->col < term->width) {
+            size_t at = (size_t)term->row * term->width + term->col++;
+            term->cells[at] = c;
+            term->attrs[at] = term->state;
+        } else {
+            term->invalid = 1;
+        }
+    }
+}
+
+// Atributo que se ve: un espacio sin subrayado se ve igual con cualquiera
+static unsigned char visible_attr(char c, unsigned char attr) {
+    return c == ' ' && !(attr & ATTR_UNDERLINE) ? 0 : attr;
+}
+
+// La terminal muestra cells/attrs, con los atributos en cero y el cursor debajo del canvas
+static int terminal_shows(const Terminal *term, const char *cells, const unsigned char *attrs) {
+    size_t n = (size_t)term->width * term->height;
+    if (term->invalid || term->state != 0 || term->row != term->height || term->col != 0) return 0;
+    for (size_t i = 0; i < n; i++) {
+        if (term->cells[i] != cells[i] ||
+            visible_attr(term->cells[i], term->attrs[i]) != visible_attr(cells[i], attrs[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * encode_full_frame_attr y encode_delta_frame_attr decodificados por una
+ * terminal: frames al azar (con cambios de solo atributo, visibles o no)
+ * y los de seek.json en orden. Cada frame deja la pantalla igual al
+ * frame y los atributos en cero; un cambio invisible no escribe nada.
+ */
+static void check_sgr_encoding(const char *dir) {
+    enum { W = 37, H = 11, FRAMES = 200 };
+    static const unsigned char palette[] = {
+        0, 1, 8, 9, 16, ATTR_BOLD, ATTR_BOLD | 3, ATTR_UNDERLINE, ATTR_UNDERLINE | 12,
+        ATTR_BOLD | ATTR_UNDERLINE | 5
+    };
+    char cells[2][W * H], screen[W * H];
+    unsigned char attrs[2][W * H], screen_attrs[W * H];
+    Terminal term = {screen, screen_attrs, W, H, 0, 0, 0, 0};
+    ByteBuffer enc;
+    bytebuf_init(&enc);
+    srand(47);
+    for (int f = 0; f < FRAMES; f++) {
+        char *cur = cells[f % 2], *prev = cells[(f + 1) % 2];
+        unsigned char *cur_attrs = attrs[f % 2], *prev_attrs = attrs[(f + 1) % 2];
+        int invisible = f % 10 == 9;
+        for (int i = 0; i < W * H; i++) {
+            cur[i] = f > 0 ? prev[i] : ' ';
+            cur_attrs[i] = f > 0 ? prev_attrs[i] : 0;
+            if (invisible) {
+                // Solo el color de espacios sin subrayado: no se ve
+                if (cur[i] == ' ' && !(cur_attrs[i] & ATTR_UNDERLINE)) cur_attrs[i] = rand() % 17;
+                continue;
+            }
+            int r = rand() % (f == 0 ? 1 : 8);
+            if (r == 0) cur[i] = " ab#"[rand() % 4];
+            if (r <= 1) cur_attrs[i] = palette[rand() % sizeof(palette)];
+        }
+        bytebuf_reset(&enc);
+        int rc = f == 0 || f % 50 == 0
+                     ? encode_full_frame_attr(cur, cur_attrs, W, H, &enc)
+                     : encode_delta_frame_attr(prev, prev_attrs, cur, cur_attrs, W, H, &enc);
+        CHECK(rc == 0, "falló la codificación del frame %d", f);
+        terminal_feed(&term, enc.data, enc.len);
+        CHECK(terminal_shows(&term, cur, cur_attrs), "el frame %d se ve distinto", f);
+        if (invisible) {
+            char expected[16];
+            int n = snprintf(expected, sizeof(expected), "\033[%d;1H", H + 1);
+            CHECK(enc.len == (size_t)n && memcmp(enc.data, expected, n) == 0,
+                  "el frame %d solo cambia atributos invisibles y escribió %zu bytes", f, enc.len);
+        }
+    }
+
+    AnimationConfig *config = load_fixture(dir, "seek.json");
+    if (config) {
+        int width = config->canvas.width, height = config->canvas.height;
+        size_t n = (size_t)width * height;
+        char *buf = malloc(n * 3);
+        unsigned char *abuf = malloc(n * 3);
+        if (!buf || !abuf) {
+            CHECK(0, "sin memoria");
+        } else {
+            Terminal t2 = {buf + 2 * n, abuf + 2 * n, width, height, 0, 0, 0, 0};
+            int bad = 0;
+            for (int t = 0; t <= render_max_time(config); t++) {
+                char *cur = buf + (t % 2) * n, *prev = buf + ((t + 1) % 2) * n;
+                unsigned char *cur_attrs = abuf + (t % 2) * n, *prev_attrs = abuf + ((t + 1) % 2) * n;
+                render_frame(config, t, cur, cur_attrs);
+                bytebuf_reset(&enc);
+                if (t == 0) encode_full_frame_attr(cur, cur_attrs, width, height, &enc);
+                else encode_delta_frame_attr(prev, prev_attrs, cur, cur_attrs, width, height, &enc);
+                terminal_feed(&t2, enc.data, enc.len);
+                bad += !terminal_shows(&t2, cur, cur_attrs);
+            }
+            CHECK(bad == 0, "seek.json: %d frames se ven distintos", bad);
+        }
+        free(buf);
+        free(abuf);
+        free_config(config);
+    }
+    bytebuf_free(&enc);
+}
+
+// Choques de un tick, juntados por el callback (sin respuesta: la trayectoria no cambia)
+typedef struct {
+    CollisionEvent *events;
+    int count, cap;
+} EventLog;
+
+static CollisionResponse log_event(const CollisionEvent *ev, void *user) {
+    EventLog *log = user;
+    if (log->count < log->cap) log->events[log->count] = *ev;
+    log->count++;
+    return COLLISION_NONE;
+}
+
+static int cmp_event(const void *pa, const void *pb) {
+    const CollisionEvent *a = pa, *b = pb;
+    if (a->a != b->a) return a->a < b->a ? -1 : 1;
+    return (a->b > b->b) - (a->b < b->b);
+}
+
+// Celdas no transparentes de las dos figuras en el tick t dentro de r, celda por celda
+static int solid_cells(const Scene *s, const TrajectoryState *st, int a, int b, Rect r) {
+    const char *ga = scene_glyph(s, a, scene_rotation_at(s, a, st->t));
+    const char *gb = scene_glyph(s, b, scene_rotation_at(s, b, st->t));
+    if (!ga || !gb) return 0;
+    int cells = 0;
+    for (int y = r.y; y < r.y + r.h; y++) {
+        for (int x = r.x; x < r.x + r.w; x++) {
+            cells += ga[(y - st->y[a]) * (s->cols[a] + 1) + x - st->x[a]] != ' ' &&
+                     gb[(y - st->y[b]) * (s->cols[b] + 1) + x - st->x[b]] != ' ';
+        }
+    }
+    return cells;
+}
+
+/*
+ * collision_detect contra todos los pares de figuras vivas, tick a tick:
+ * los mismos pares, con la misma intersección y las mismas celdas. En
+ * crowd.json los sprites pasan de 64 columnas (máscaras de dos palabras).
+ */
+static void check_collisions(const char *dir) {
+    static const char *fixtures[] = {"seek.json", "crowd.json"};
+    for (size_t n = 0; n < sizeof(fixtures) / sizeof(fixtures[0]); n++) {
+        AnimationConfig *config = load_fixture(dir, fixtures[n]);
+        if (!config) continue;
+        config->collisions = COLLISION_FLAG;
+        const Scene *s = config->scene;
+        int nf = s->num_figures;
+        int cap = nf * (nf - 1) / 2 + 1;
+        EventLog log = {malloc(sizeof(CollisionEvent) * cap), 0, cap};
+        CollisionEvent *ref = malloc(sizeof(CollisionEvent) * cap);
+        CollisionSystem *cs = collision_create(config);
+        SpatialGrid g;
+        TrajectoryState st;
+        int grid_ok = grid_init(&g, config->world.width, config->world.height, GRID_CELL_SIZE, nf) == 0;
+        int traj_ok = trajectory_state_init(&st, config->trajectory, 0) == 0;
+        if (!log.events || !ref || !cs || !grid_ok || !traj_ok) {
+            CHECK(0, "%s: sin memoria", fixtures[n]);
+        } else {
+            collision_set_callback(cs, log_event, &log);
+            Rect world = {0, 0, config->world.width, config->world.height};
+            int mismatched = 0, total = 0;
+            for (int t = 0; t <= render_max_time(config); t++) {
+                grid_build(&g, config, &st);
+                log.count = 0;
+                int found = collision_detect(cs, config, &g, &st);
+
+                int m = 0;
+                for (int a = 0; a < nf; a++) {
+                    Rect ra = {st.x[a], st.y[a], s->cols[a], s->rows[a]};
+                    if (t < s->t_start[a] || t > s->t_end[a] || !rect_intersects(ra, world)) continue;
+                    for (int b = a + 1; b < nf; b++) {
+                        Rect rb = {st.x[b], st.y[b], s->cols[b], s->rows[b]};
+                        if (t < s->t_start[b] || t > s->t_end[b] || !rect_intersects(rb, world) ||
+                            !rect_intersects(ra, rb)) {
+                            continue;
+                        }
+                        Rect r = {ra.x > rb.x ? ra.x : rb.x, ra.y > rb.y ? ra.y : rb.y, 0, 0};
+                        r.w = (ra.x + ra.w < rb.x + rb.w ? ra.x + ra.w : rb.x + rb.w) - r.x;
+                        r.h = (ra.y + ra.h < rb.y + rb.h ? ra.y + ra.h : rb.y + rb.h) - r.y;
+                        int cells = solid_cells(s, &st, a, b, r);
+                        if (cells > 0) ref[m++] = (CollisionEvent){t, a, b, r, cells};
+                    }
+                }
+
+                int same = found == log.count && log.count == m;
+                qsort(log.events, same ? m : 0, sizeof(CollisionEvent), cmp_event);
+                for (int k = 0; same && k < m; k++) {
+                    const CollisionEvent *e = &log.events[k], *f = &ref[k];
+                    same = e->t == t && e->a == f->a && e->b == f->b && e->cells == f->cells &&
+                           e->overlap.x == f->overlap.x && e->overlap.y == f->overlap.y &&
+                           e->overlap.w == f->overlap.w && e->overlap.h == f->overlap.h;
+                }
+                mismatched += !same;
+                total += m;
+                trajectory_step(&st);
+                collision_apply(cs, &st);
+            }
+            CHECK(total > 0, "%s: la escena no tiene choques que probar", fixtures[n]);
+            CHECK(mismatched == 0, "%s: collision_detect difiere en %d ticks", fixtures[n], mismatched);
+        }
+        if (traj_ok) trajectory_state_free(&st);
+        if (grid_ok) grid_free(&g);
+        collision_free(cs);
+        free(log.events);
+        free(ref);
+        free_config(config);
+    }
+}
+
+static int write_bytes(const char *path, const void *data, size_t size) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    int ok = fwrite(data, 1, size, f) == size;
+    return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+// Lee path completo en memoria (malloc). NULL si falla.
+static char *read_bytes(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    char *data = NULL;
+    long len = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    if (len > 0 && fseek(f, 0, SEEK_SET) == 0 && (data = malloc(len)) &&
+        fread(data, 1, len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = data ? (size_t)len : 0;
+    return data;
+}
+
+/*
+ * Escena compilada: lo que escribe scene_file_write se carga con la misma
+ * escena y los mismos frames que el JSON de origen, y un archivo con el
+ * encabezado, las secciones o los offsets dañados se rechaza en lugar de
+ * leer fuera del mapeo.
+ */
+static void check_scene_file(const char *dir) {
+    static const char *fixtures[] = {"seek.json", "paths.json", "world.json"};
+    char path[512];
+    for (size_t n = 0; n < sizeof(fixtures) / sizeof(fixtures[0]); n++) {
+        AnimationConfig *a = load_fixture(dir, fixtures[n]);
+        if (!a) continue;
+        snprintf(path, sizeof(path), "%s/%s.mdscene", dir, fixtures[n]);
+        AnimationConfig *b = scene_file_write(a, path) == 0 ? scene_file_load(path, 1) : NULL;
+        CHECK(b != NULL, "%s: no se pudo compilar y volver a cargar", path);
+        if (b) {
+            check_same_scene(path, a, b);
+            CHECK(a->canvas.width == b->canvas.width && a->canvas.height == b->canvas.height &&
+                  a->world.width == b->world.width && a->world.height == b->world.height &&
+                  a->fps == b->fps && a->collisions == b->collisions &&
+                  a->scene->colored == b->scene->colored && a->hash == b->hash,
+                  "%s: la configuración no se conserva", path);
+
+            size_t cells = (size_t)a->canvas.width * a->canvas.height;
+            char *fa = malloc(cells), *fb = malloc(cells);
+            unsigned char *aa = malloc(cells), *ab = malloc(cells);
+            int differ = !fa || !fb || !aa || !ab;
+            for (int t = 0; !differ && t <= render_max_time(a); t += 5) {
+                render_frame(a, t, fa, aa);
+                render_frame(b, t, fb, ab);
+                differ = memcmp(fa, fb, cells) != 0 ||
+                         (a->scene->colored && memcmp(aa, ab, cells) != 0);
+            }
+            CHECK(!differ, "%s: los frames difieren del JSON", path);
+            free(fa);
+            free(fb);
+            free(aa);
+            free(ab);
+            free_config(b);
+        }
+        free_config(a);
+        if (n > 0) remove(path);
+    }
+
+    // Daños sobre la primera escena compilada (seek.json.mdscene)
+    snprintf(path, sizeof(path), "%s/%s.mdscene", dir, fixtures[0]);
+    size_t size;
+    char *good = read_bytes(path, &size);
+    char *bad = good ? malloc(size) : NULL;
+    if (!good || !bad) {
+        CHECK(0, "no se pudo leer %s", path);
+        free(good);
+        free(bad);
+        return;
+    }
+    SceneFileHeader *h = (SceneFileHeader *)bad;
+    size_t checksum = offsetof(SceneFileHeader, header_checksum);
+    enum { PAYLOAD, HEADER, TRUNCATED, SECTION, GLYPH, SPAN, CASES };
+    fprintf(stderr, "[check] se espera un error por cada escena compilada dañada:\n");
+    for (int c = 0; c < CASES; c++) {
+        memcpy(bad, good, size);
+        size_t len = size;
+        switch (c) {
+        case PAYLOAD: bad[size - 1] ^= 1; break;
+        case HEADER: h->num_figures++; break;
+        case TRUNCATED: len = size - SCENE_FILE_ALIGN; break;
+        case SECTION: h->sections[SCENE_SECTION_KEYS].offset = size + SCENE_FILE_ALIGN; break;
+        case GLYPH: ((int32_t *)(bad + h->sections[SCENE_SECTION_GLYPH].offset))[0] = h->atlas_size; break;
+        case SPAN: ((int32_t *)(bad + h->sections[SCENE_SECTION_SPAN].offset))[0] = 0; break;
+        }
+        // Encabezado con checksum válido: el daño lo tiene que ver la validación de secciones
+        if (c == SECTION) h->header_checksum = hash_bytes(h, checksum);
+        if (write_bytes(path, bad, len) != 0) {
+            CHECK(0, "no se pudo escribir %s", path);
+            break;
+        }
+        // Sin verify solo se validan el encabezado y los offsets, que alcanzan para el resto
+        AnimationConfig *config = scene_file_load(path, c == PAYLOAD);
+        CHECK(!config, "se cargó una escena compilada con el daño %d", c);
+        if (config) free_config(config);
+        if (c == PAYLOAD) {
+            config = scene_file_load(path, 0);
+            CHECK(config != NULL, "sin verify se rechazó un daño fuera de los offsets");
+            if (config) free_config(config);
+        }
+    }
+    remove(path);
+    free(good);
+    free(bad);
+}
+
+/*
+ * Grabación (.mdar): la que escribe recording_write abre con sus frames
+ * dentro del mapeo, y un encabezado o un índice dañado (offsets cerca de
+ * 2^64 que dan la vuelta al sumar) se rechaza al abrir.
+ */
+static void check_recording(const char *dir) {
+    AnimationConfig *config = load_fixture(dir, "seek.json");
+    if (!config) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/seek.mdar", dir);
+    int written = recording_write(config, path, 10, NULL) == 0;
+    int frames = render_max_time(config) + 1;
+    free_config(config);
+    CHECK(written, "no se pudo grabar %s", path);
+    if (!written) return;
+
+    Recording rec;
+    int opened = recording_open(&rec, path) == 0;
+    CHECK(opened && rec.header->num_frames == (uint32_t)frames, "%s: no abre con %d frames", path,
+          frames);
+    if (opened) recording_close(&rec);
+
+    size_t size;
+    char *good = read_bytes(path, &size);
+    char *bad = good ? malloc(size) : NULL;
+    if (!good || !bad) {
+        CHECK(0, "no se pudo leer %s", path);
+        free(good);
+        free(bad);
+        return;
+    }
+    RecordingHeader *h = (RecordingHeader *)bad;
+    enum { WRAPPED_INDEX, INSIDE_HEADER, MANY_FRAMES, TRUNCATED, WRAPPED_FRAME, LONG_FRAME,
+           SHORT_FILE, CASES };
+    fprintf(stderr, "[check] se espera un error por cada grabación dañada:\n");
+    for (int c = 0; c < CASES; c++) {
+        memcpy(bad, good, size);
+        size_t len = size;
+        RecordingIndexEntry *index = (RecordingIndexEntry *)(bad + h->index_offset);
+        switch (c) {
+        case WRAPPED_INDEX: h->index_offset = UINT64_MAX - 7; break;
+        case INSIDE_HEADER: h->index_offset = 0; break;
+        case MANY_FRAMES: h->num_frames = UINT32_MAX; break;
+        case TRUNCATED: len = size - sizeof(RecordingIndexEntry); break;
+        case WRAPPED_FRAME: index[frames - 1].offset = UINT64_MAX - 3; break;
+        case LONG_FRAME: index[0].length = UINT32_MAX; break;
+        case SHORT_FILE:
+            // El caso que daba SIGSEGV: 120 bytes, un frame, índice a 8 bytes de 2^64
+            h->num_frames = 1;
+            h->index_offset = UINT64_MAX - 7;
+            len = 120;
+            break;
+        }
+        if (write_bytes(path, bad, len) != 0) {
+            CHECK(0, "no se pudo escribir %s", path);
+            break;
+        }
+        opened = recording_open(&rec, path) == 0;
+        CHECK(!opened, "se abrió una grabación con el daño %d", c);
+        if (opened) recording_close(&rec);
+    }
+    remove(path);
+    free(good);
+    free(bad);
+}
+
+int main(int argc, char **argv) {
+    const char *dir = argc > 1 ? argv[1] : "check";
+
+    check_frame_seeker(dir);
+    check_trajectory(dir);
+    check_spatial_grid(dir);
+    check_json_stream(dir);
+    check_config_loaders(dir);
+    check_scene_file(dir);
+    check_recording(dir);
+    check_sgr_encoding(dir);
+    check_collisions(dir);
+
+    printf("%d comprobaciones, %d fallos\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,357 @@
+#include "collision.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scene.h"
+
+struct CollisionSystem {
+    CollisionResponse policy;
+    CollisionCallback callback;
+    void *user;
+
+    // Posición dibujada por eje: c + m * p (m = 1 sigue la trayectoria)
+    int max_figures;
+    int *cx, *cy, *mx, *my;
+    int *bounced;            // último tick en que rebotó cada figura (uno por tick)
+    int *hits;
+    int num_moved;           // figuras con m != 1 o c != 0
+
+    // Máscaras por sprite: mask_start[id] en pool (-1 = sin construir)
+    int *mask_start;
+    int num_masks;
+    uint64_t *pool;
+    int pool_len, pool_cap;
+
+    long long pairs, narrow, events, cells;
+};
+
+CollisionResponse collision_policy_from_string(const char *name) {
+    if (!name) return COLLISION_NONE;
+    if (strcmp(name, "flag") == 0) return COLLISION_FLAG;
+    if (strcmp(name, "stop") == 0) return COLLISION_STOP;
+    if (strcmp(name, "bounce") == 0) return COLLISION_BOUNCE;
+    return COLLISION_NONE;
+}
+
+const char *collision_policy_name(CollisionResponse policy) {
+    switch (policy) {
+    case COLLISION_FLAG: return "flag";
+    case COLLISION_STOP: return "stop";
+    case COLLISION_BOUNCE: return "bounce";
+    default: return "none";
+    }
+}
+
+static void reset_figure(CollisionSystem *cs, int i) {
+    if (cs->mx[i] != 1 || cs->my[i] != 1 || cs->cx[i] != 0 || cs->cy[i] != 0) cs->num_moved--;
+    cs->cx[i] = cs->cy[i] = 0;
+    cs->mx[i] = cs->my[i] = 1;
+    cs->bounced[i] = -1;
+    cs->hits[i] = 0;
+}
+
+static void reset_all(CollisionSystem *cs) {
+    for (int i = 0; i < cs->max_figures; i++) {
+        cs->cx[i] = cs->cy[i] = 0;
+        cs->mx[i] = cs->my[i] = 1;
+        cs->bounced[i] = -1;
+        cs->hits[i] = 0;
+    }
+    cs->num_moved = 0;
+}
+
+// Admite hasta n figuras; las nuevas siguen su trayectoria
+static int reserve_figures(CollisionSystem *cs, int n) {
+    if (n <= cs->max_figures) return 0;
+    int **arrays[] = {&cs->cx, &cs->cy, &cs->mx, &cs->my, &cs->bounced, &cs->hits};
+    for (size_t k = 0; k < sizeof(arrays) / sizeof(arrays[0]); k++) {
+        int *grown = realloc(*arrays[k], sizeof(int) * n);
+        if (!grown) return -1;
+        *arrays[k] = grown;
+    }
+    for (int i = cs->max_figures; i < n; i++) {
+        cs->cx[i] = cs->cy[i] = 0;
+        cs->mx[i] = cs->my[i] = 1;
+        cs->bounced[i] = -1;
+        cs->hits[i] = 0;
+    }
+    cs->max_figures = n;
+    return 0;
+}
+
+// Olvida las máscaras (el atlas cambió) y admite los sprites de la escena
+static int reset_masks(CollisionSystem *cs, const Scene *s) {
+    int n = s->sprites.num_sprites;
+    if (n > cs->num_masks) {
+        int *grown = realloc(cs->mask_start, sizeof(int) * n);
+        if (!grown) return -1;
+        cs->mask_start = grown;
+        cs->num_masks = n;
+    }
+    for (int id = 0; id < cs->num_masks; id++) cs->mask_start[id] = -1;
+    cs->pool_len = 0;
+    return 0;
+}
+
+CollisionSystem *collision_create(const AnimationConfig *config) {
+    if (config->collisions == COLLISION_NONE) return NULL;
+    CollisionSystem *cs = calloc(1, sizeof(CollisionSystem));
+    if (!cs) return NULL;
+    cs->policy = config->collisions;
+    if (reserve_figures(cs, config->scene->num_figures > 0 ? config->scene->num_figures : 1) != 0 ||
+        reset_masks(cs, config->scene) != 0) {
+        collision_free(cs);
+        return NULL;
+    }
+    return cs;
+}
+
+void collision_free(CollisionSystem *cs) {
+    if (!cs) return;
+    free(cs->cx);
+    free(cs->cy);
+    free(cs->mx);
+    free(cs->my);
+    free(cs->bounced);
+    free(cs->hits);
+    free(cs->mask_start);
+    free(cs->pool);
+    free(cs);
+}
+
+void collision_set_callback(CollisionSystem *cs, CollisionCallback cb, void *user) {
+    if (!cs) return;
+    cs->callback = cb;
+    cs->user = user;
+}
+
+static int mask_words(int cols) {
+    return (cols + 63) / 64;
+}
+
+// Máscara del sprite id: bit c de la fila r = celda no transparente. NULL si no hay memoria.
+static const uint64_t *sprite_mask(CollisionSystem *cs, const Scene *s, int id) {
+    if (cs->mask_start[id] >= 0) return cs->pool + cs->mask_start[id];
+
+    const Sprite *sp = &s->sprites.sprites[id];
+    int words = mask_words(sp->cols);
+    int need = sp->rows * words;
+    if (cs->pool_len + need > cs->pool_cap) {
+        int cap = cs->pool_cap > 0 ? cs->pool_cap : 1024;
+        while (cap < cs->pool_len + need) cap *= 2;
+        uint64_t *grown = realloc(cs->pool, sizeof(uint64_t) * cap);
+        if (!grown) return NULL;
+        cs->pool = grown;
+        cs->pool_cap = cap;
+    }
+
+    uint64_t *mask = cs->pool + cs->pool_len;
+    memset(mask, 0, sizeof(uint64_t) * need);
+    const char *glyph = s->atlas + sp->offset;
+    for (int r = 0; r < sp->rows; r++) {
+        const char *row = glyph + r * (sp->cols + 1);
+        for (int c = 0; c < sp->cols; c++) {
+            if (row[c] != ' ') mask[r * words + c / 64] |= 1ULL << (c % 64);
+        }
+    }
+    cs->mask_start[id] = cs->pool_len;
+    cs->pool_len += need;
+    return mask;
+}
+
+// Bits [start, start + len) de una fila, alineados al bit 0 (len <= 64)
+static inline uint64_t row_bits(const uint64_t *row, int start, int len) {
+    int w = start / 64, o = start % 64;
+    uint64_t v = row[w] >> o;
+    if (o > 0 && o + len > 64) v |= row[w + 1] << (64 - o);
+    return len < 64 ? v & ((1ULL << len) - 1) : v;
+}
+
+// Celdas sólidas en común de a (en ax, ay) y b (en bx, by) dentro de r
+static int overlap_cells(const uint64_t *ma, int wa, int ax, int ay,
+                         const uint64_t *mb, int wb, int bx, int by, Rect r) {
+    int cells = 0;
+    for (int y = r.y; y < r.y + r.h; y++) {
+        const uint64_t *ra = ma + (y - ay) * wa;
+        const uint64_t *rb = mb + (y - by) * wb;
+        for (int x = r.x; x < r.x + r.w; x += 64) {
+            int len = r.x + r.w - x < 64 ? r.x + r.w - x : 64;
+            cells += __builtin_popcountll(row_bits(ra, x - ax, len) & row_bits(rb, x - bx, len));
+        }
+    }
+    return cells;
+}
+
+static void set_axis(CollisionSystem *cs, int *c, int *m, int i, int pos, int new_m) {
+    int was_identity = cs->mx[i] == 1 && cs->my[i] == 1 && cs->cx[i] == 0 && cs->cy[i] == 0;
+    // Misma posición en este tick: p = m * (pos - c) y c' = pos - m' * p
+    int p = m[i] * (pos - c[i]);
+    m[i] = new_m;
+    c[i] = pos - new_m * p;
+    int is_identity = cs->mx[i] == 1 && cs->my[i] == 1 && cs->cx[i] == 0 && cs->cy[i] == 0;
+    cs->num_moved += was_identity - is_identity;
+}
+
+// Dirección en que avanza la figura i en el eje (-1, 0, 1) según su segmento y su m
+static int direction(const TrajectoryState *st, int i, int along_x) {
+    if (st->t < st->t0[i] || st->t >= st->t1[i]) return 0;
+    if (along_x) return (st->dqx[i] | st->drx[i]) ? st->sx[i] : 0;
+    return (st->dqy[i] | st->dry[i]) ? st->sy[i] : 0;
+}
+
+// Sentido en que se dibuja la figura i en el eje: el de la trayectoria por su m
+static int velocity(const CollisionSystem *cs, const TrajectoryState *st, int i, int along_x) {
+    return (along_x ? cs->mx[i] : cs->my[i]) * direction(st, i, along_x);
+}
+
+/*
+ * Rebota i en un eje si avanza hacia el otro. delta es centro del otro -
+ * centro propio (en medias celdas) un tick antes, así que también se
+ * decide bien cuando se cruzaron y los centros coinciden.
+ */
+static void bounce_axis(CollisionSystem *cs, const TrajectoryState *st, int i, int along_x,
+                        int delta, int v, int v_other) {
+    delta -= 2 * (v_other - v);
+    if (delta == 0 || v == 0 || (v > 0) != (delta > 0)) return;
+    int *c = along_x ? cs->cx : cs->cy;
+    int *m = along_x ? cs->mx : cs->my;
+    set_axis(cs, c, m, i, along_x ? st->x[i] : st->y[i], -m[i]);
+}
+
+static void respond(CollisionSystem *cs, const Scene *s, const TrajectoryState *st,
+                    const CollisionEvent *ev, CollisionResponse r) {
+    int pair[2] = {ev->a, ev->b};
+    // Velocidades antes de rebotar a ninguna de las dos
+    int vx[2], vy[2];
+    for (int k = 0; k < 2; k++) {
+        vx[k] = velocity(cs, st, pair[k], 1);
+        vy[k] = velocity(cs, st, pair[k], 0);
+    }
+    for (int k = 0; k < 2; k++) {
+        int i = pair[k], j = pair[1 - k];
+        cs->hits[i]++;
+        if (r == COLLISION_STOP) {
+            set_axis(cs, cs->cx, cs->mx, i, st->x[i], 0);
+            set_axis(cs, cs->cy, cs->my, i, st->y[i], 0);
+        } else if (r == COLLISION_BOUNCE && cs->bounced[i] != st->t) {
+            // Eje del choque: el lado más corto de la intersección (los dos si es cuadrada)
+            int dx = (2 * st->x[j] + s->cols[j]) - (2 * st->x[i] + s->cols[i]);
+            int dy = (2 * st->y[j] + s->rows[j]) - (2 * st->y[i] + s->rows[i]);
+            if (ev->overlap.w <= ev->overlap.h) bounce_axis(cs, st, i, 1, dx, vx[k], vx[1 - k]);
+            if (ev->overlap.h <= ev->overlap.w) bounce_axis(cs, st, i, 0, dy, vy[k], vy[1 - k]);
+            cs->bounced[i] = st->t;
+        }
+    }
+}
+
+int collision_detect(CollisionSystem *cs, const AnimationConfig *config,
+                     const SpatialGrid *grid, const TrajectoryState *st) {
+    if (!cs) return 0;
+    const Scene *s = config->scene;
+    int t = st->t;
+    int found = 0;
+
+    for (int cy = 0; cy < grid->rows; cy++) {
+        for (int cx = 0; cx < grid->cols; cx++) {
+            for (int n1 = grid->cell_head[cy * grid->cols + cx]; n1 != -1; n1 = grid->node_next[n1]) {
+                for (int n2 = grid->node_next[n1]; n2 != -1; n2 = grid->node_next[n2]) {
+                    int a = grid->node_figure[n1], b = grid->node_figure[n2];
+                    if (a > b) {
+                        int tmp = a;
+                        a = b;
+                        b = tmp;
+                    }
+                    Rect ra = grid->bounds[a], rb = grid->bounds[b];
+                    if (!rect_intersects(ra, rb)) continue;
+
+                    Rect r;
+                    r.x = ra.x > rb.x ? ra.x : rb.x;
+                    r.y = ra.y > rb.y ? ra.y : rb.y;
+                    r.w = (ra.x + ra.w < rb.x + rb.w ? ra.x + ra.w : rb.x + rb.w) - r.x;
+                    r.h = (ra.y + ra.h < rb.y + rb.h ? ra.y + ra.h : rb.y + rb.h) - r.y;
+
+                    // El par se prueba solo en la casilla de la esquina (recortada al mundo)
+                    if ((r.x < 0 ? 0 : r.x) / grid->cell_size != cx ||
+                        (r.y < 0 ? 0 : r.y) / grid->cell_size != cy) {
+                        continue;
+                    }
+                    cs->pairs++;
+
+                    int sa = s->sprite[a * SCENE_NUM_ANGLES + scene_rotation_at(s, a, t)];
+                    int sb = s->sprite[b * SCENE_NUM_ANGLES + scene_rotation_at(s, b, t)];
+                    if (sa < 0 || sb < 0) continue;  // sin glifo en esa rotación
+                    const uint64_t *ma = sprite_mask(cs, s, sa);
+                    const uint64_t *mb = sprite_mask(cs, s, sb);
+                    if (!ma || !mb) continue;
+                    ma = cs->pool + cs->mask_start[sa];  // el pool pudo moverse con mb
+                    cs->narrow++;
+
+                    int cells = overlap_cells(ma, mask_words(s->sprites.sprites[sa].cols), ra.x, ra.y,
+                                              mb, mask_words(s->sprites.sprites[sb].cols), rb.x, rb.y, r);
+                    if (cells == 0) continue;
+
+                    CollisionEvent ev = {t, a, b, r, cells};
+                    CollisionResponse resp = cs->callback ? cs->callback(&ev, cs->user) : cs->policy;
+                    cs->events++;
+                    cs->cells += cells;
+                    found++;
+                    if (resp != COLLISION_NONE) respond(cs, s, st, &ev, resp);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void collision_apply(CollisionSystem *cs, TrajectoryState *st) {
+    if (!cs || cs->num_moved == 0) return;
+    int n = st->table->num_figures < cs->max_figures ? st->table->num_figures : cs->max_figures;
+    for (int i = 0; i < n; i++) {
+        st->x[i] = cs->cx[i] + cs->mx[i] * st->x[i];
+        st->y[i] = cs->cy[i] + cs->my[i] * st->y[i];
+    }
+}
+
+void collision_seek(CollisionSystem *cs, const AnimationConfig *config, SpatialGrid *grid,
+                    TrajectoryState *st, int t) {
+    if (!cs) {
+        trajectory_seek(st, t);
+        return;
+    }
+    if (t < st->t) {
+        reset_all(cs);
+        trajectory_seek(st, 0);
+    }
+    while (st->t < t) {
+        grid_build(grid, config, st);
+        collision_detect(cs, config, grid, st);
+        trajectory_step(st);
+        collision_apply(cs, st);
+    }
+}
+
+int collision_sync(CollisionSystem *cs, const AnimationConfig *config,
+                   const HotReloadChange *change, TrajectoryState *st) {
+    if (!cs) return 0;
+    if (reserve_figures(cs, config->scene->num_figures) != 0 ||
+        reset_masks(cs, config->scene) != 0) {
+        return -1;
+    }
+    // Las figuras cambiadas (y las que sobran si la escena se achicó) vuelven a su trayectoria
+    for (int c = 0; c < change->num_changed; c++) reset_figure(cs, change->changed[c]);
+    for (int i = config->scene->num_figures; i < cs->max_figures; i++) reset_figure(cs, i);
+    // Con resized o relayout el cursor se reubicó entero: volver a aplicar a todas
+    if (change->resized || change->relayout) collision_apply(cs, st);
+    return 0;
+}
+
+int collision_hits(const CollisionSystem *cs, int i) {
+    return cs && i >= 0 && i < cs->max_figures ? cs->hits[i] : 0;
+}
+
+void collision_report(const CollisionSystem *cs, FILE *out) {
+    if (!cs) return;
+    fprintf(out, "[COLISIONES] política %s | %lld pares probados, %lld a fase fina | "
+            "%lld choques, %lld celdas en común\n",
+            collision_policy_name(cs->policy), cs->pairs, cs->narrow, cs->events, cs->cells);
+}
@@ -0,0 +1,99 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdio.h>
+#include "anim_config.h"
+#include "hot_reload.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+
+// Qué hacer con las dos figuras de un choque (también la política de "collisions")
+typedef enum {
+    COLLISION_NONE,          // sin detección (política) / ignorar el choque (callback)
+    COLLISION_FLAG,          // solo contar el choque en cada figura
+    COLLISION_STOP,          // las dos quedan quietas hasta su t_end
+    COLLISION_BOUNCE         // invierten el eje del choque si se acercaban
+} CollisionResponse;
+
+// Un par de figuras con celdas sólidas en común en el tick t
+typedef struct {
+    int t;
+    int a, b;                // a < b
+    Rect overlap;            // intersección de los bounding boxes
+    int cells;               // celdas no transparentes de ambas dentro de overlap
+} CollisionEvent;
+
+typedef CollisionResponse (*CollisionCallback)(const CollisionEvent *ev, void *user);
+
+/*
+ * Detección de choques a nivel de celda entre las figuras activas. La
+ * fase gruesa es la rejilla espacial del motor (spatial_grid.h), ya
+ * armada en cada tick: solo se prueban los pares que comparten casilla,
+ * así que el costo crece con las figuras por casilla y no con n². Cada
+ * par se prueba en una sola casilla, la que contiene la esquina superior
+ * izquierda de la intersección. La fase fina compara máscaras de bits
+ * por sprite (una palabra de 64 columnas por fila, construidas la primera
+ * vez que se usan) con AND y popcount sobre la intersección.
+ *
+ * La respuesta no mueve a nadie en el tick del choque: cambia cómo sigue
+ * cada figura. Por eje, la posición que se dibuja es c + m * p, con p la
+ * de la trayectoria: m = 1 sigue la trayectoria, m = -1 la recorre
+ * reflejada (rebote) y m = 0 la deja fija (stop). Así la respuesta
+ * sobrevive a los cambios de segmento sin tocar la tabla de trayectorias.
+ *
+ * El estado depende de todos los ticks de la vuelta, por eso collision_seek
+ * avanza tick a tick en lugar de saltar, y vuelve a empezar en una vuelta
+ * nueva: cada vuelta se reproduce igual (y el caché de frames sigue valiendo).
+ *
+ * Un CollisionSystem NULL significa sin detección: todas las funciones
+ * lo aceptan y collision_seek se reduce a trajectory_seek.
+ */
+typedef struct CollisionSystem CollisionSystem;
+
+// Política de la clave "collisions": "flag", "stop" o "bounce" (otra = COLLISION_NONE)
+CollisionResponse collision_policy_from_string(const char *name);
+const char *collision_policy_name(CollisionResponse policy);
+
+// NULL si config->collisions es COLLISION_NONE o no hay memoria
+CollisionSystem *collision_create(const AnimationConfig *config);
+void collision_free(CollisionSystem *cs);
+
+/*
+ * Reemplaza la respuesta por defecto (la política de la configuración).
+ * El callback corre en el hilo que dibuja, una vez por par y por tick
+ * mientras se solapen.
+ */
+void collision_set_callback(CollisionSystem *cs, CollisionCallback cb, void *user);
+
+/*
+ * Prueba los pares de la rejilla (armada con grid_build en el tick de st)
+ * y aplica las respuestas. Retorna los choques del tick.
+ */
+int collision_detect(CollisionSystem *cs, const AnimationConfig *config,
+                     const SpatialGrid *grid, const TrajectoryState *st);
+
+// Después de cada trajectory_step: pasa las posiciones de la trayectoria a las dibujadas
+void collision_apply(CollisionSystem *cs, TrajectoryState *st);
+
+/*
+ * Lleva st al tick t pasando por los choques intermedios (usa grid como
+ * rejilla de trabajo). Si t es anterior al cursor, vuelve a empezar desde 0.
+ */
+void collision_seek(CollisionSystem *cs, const AnimationConfig *config, SpatialGrid *grid,
+                    TrajectoryState *st, int t);
+
+/*
+ * Tras una recarga en caliente y hot_reload_sync_trajectory: admite las
+ * figuras y sprites nuevos y las cambiadas vuelven a su trayectoria.
+ * Retorna 0 o -1.
+ */
+int collision_sync(CollisionSystem *cs, const AnimationConfig *config,
+                   const HotReloadChange *change, TrajectoryState *st);
+
+// Choques contados por la figura i desde el último reinicio
+int collision_hits(const CollisionSystem *cs, int i);
+
+// Pares probados, choques y celdas en stderr (o donde diga out)
+void collision_report(const CollisionSystem *cs, FILE *out);
+
+#endif // COLLISION_H
@@ -1,28 +1,1092 @@
 #include "config_parser.h"
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <cjson/cJSON.h>
+#include "anim_utils.h"
+#include "collision.h"
+#include "display.h"
+#include "frame_cache.h"
+#include "frame_clock.h"
+#include "frame_encoder.h"
+#include "json_stream.h"
+#include "present_sync.h"
+#include "scene.h"
+#include "scene_file.h"
+#include "sink_queue.h"
+#include "thread_pool.h"
+#include "trajectory.h"
+#include "viewport.h"
 
-static char **parse_rotation_array(cJSON *array, int rows, int cols) {
-    if (!cJSON_IsArray(array)) return NULL;
+/* ---------- Partes comunes a los dos lectores ---------- */
 
-    char **matrix = malloc(sizeof(char *) * rows);
-    for (int i = 0; i < rows; ++i) {
-        cJSON *row = cJSON_GetArrayItem(array, i);
-        if (!cJSON_IsString(row)) {
-            matrix[i] = NULL;
+#define FIGURE_CHUNK 256         // figuras por trozo del pool en los pasos finales
+
+static int load_threads = 0;     // 0 = procesadores en línea
+
+void config_set_load_threads(int threads) {
+    load_threads = threads;
+}
+
+// Valores por defecto de las claves opcionales
+static void config_defaults(AnimationConfig *config) {
+    memset(config, 0, sizeof(*config));
+    config->fps = FRAME_CLOCK_DEFAULT_FPS;
+    config->frame_policy = frame_policy_from_string(NULL);
+    config->loops = 1;
+    config->frame_cache_bytes = FRAME_CACHE_AUTO;
+    config->sink_policy = sink_policy_from_string(NULL);
+    config->sink_capacity = SINK_DEFAULT_CAPACITY;
+    snprintf(config->displays.sink, sizeof(config->displays.sink), "%s", "display_%d.out");
+    config->displays.transport = display_transport_from_string(NULL);
+    config->displays.sync_timeout_ms = PRESENT_SYNC_DEFAULT_TIMEOUT_MS;
+    config->displays.slow_id = -1;
+}
+
+// Lleva los valores fuera de rango a sus defaults, igual que antes de leerlos
+static void config_normalize(AnimationConfig *config) {
+    if (config->loops <= 0) config->loops = 1;
+    if (config->workers < 0) config->workers = 0;
+    if (config->sink_capacity <= 0) config->sink_capacity = SINK_DEFAULT_CAPACITY;
+    if (config->displays.rows <= 0 || config->displays.cols <= 0) {
+        config->displays.rows = config->displays.cols = 0;
+    }
+    if (config->displays.sync_timeout_ms < 0) {
+        config->displays.sync_timeout_ms = PRESENT_SYNC_DEFAULT_TIMEOUT_MS;
+    }
+    viewport_normalize(config);
+}
+
+// Agrega el viewport vp con los count keyframes de su pan (keys se libera). Retorna 0 o -1.
+static int add_viewport(AnimationConfig *config, Viewport vp, Keyframe *keys, int count) {
+    Viewport *viewports = realloc(config->viewports, sizeof(Viewport) * (config->num_viewports + 1));
+    if (viewports) config->viewports = viewports;
+    Keyframe *pan = count > 0 ? realloc(config->pan_keys, sizeof(Keyframe) * (config->num_pan_keys + count))
+                              : config->pan_keys;
+    if (pan) config->pan_keys = pan;
+    if (!viewports || (count > 0 && !pan)) {
+        free(keys);
+        return -1;
+    }
+    vp.pan_start = config->num_pan_keys;
+    vp.pan_count = count;
+    if (count > 0) memcpy(pan + config->num_pan_keys, keys, sizeof(Keyframe) * count);
+    config->num_pan_keys += count;
+    config->viewports[config->num_viewports++] = vp;
+    free(keys);
+    return 0;
+}
+
+// Con "path", el intervalo y los extremos salen de los keyframes
+static void figure_from_path(Figure *f) {
+    f->t_start = f->path[0].t;
+    f->t_end = f->path[0].t;
+    f->pos0 = f->path[0].pos;
+    f->pos1 = f->path[0].pos;
+    for (int k = 1; k < f->num_keyframes; k++) {
+        if (f->path[k].t < f->t_start) {
+            f->t_start = f->path[k].t;
+            f->pos0 = f->path[k].pos;
+        }
+        if (f->path[k].t >= f->t_end) {
+            f->t_end = f->path[k].t;
+            f->pos1 = f->path[k].pos;
+        }
+    }
+}
+
+static void trajectory_task(void *ctx, int begin, int end) {
+    AnimationConfig *config = ctx;
+    trajectory_fill(config->trajectory, config, begin, end);
+}
+
+// Trayectorias precalculadas, por trozos en el pool
+static AnimationConfig *config_finish(AnimationConfig *config, ThreadPool *pool) {
+    config->trajectory = trajectory_alloc(config);
+    if (!config->trajectory) {
+        fprintf(stderr, "Error precalculando las trayectorias\n");
+        free_config(config);
+        return NULL;
+    }
+    thread_pool_run(pool, trajectory_task, config, config->num_figures, FIGURE_CHUNK);
+    return config;
+}
+
+/* ---------- Lector por eventos (json_stream.h) ---------- */
+
+#define GLYPH_BATCH 1024         // figuras por tanda de glifos
+#define GLYPH_CHUNK 64           // figuras por trozo del pool
+
+/*
+ * Tanda de figuras con las filas de sus rotaciones todavía crudas
+ * ("rows" y "cols" pueden venir después). Mientras el pool arma los
+ * bloques y sus hashes, el lector sigue llenando la otra tanda; el
+ * internado se hace luego en el hilo del lector y en orden de figura, así
+ * que el atlas y los ids de sprite salen iguales que en una carga serie.
+ */
+typedef struct {
+    int first, count;            // figuras [first, first + count)
+    int rows[GLYPH_BATCH], cols[GLYPH_BATCH];
+    int rot_first[GLYPH_BATCH][SCENE_NUM_ANGLES];   // primera fila en row_off (-1 = sin rotación)
+    int rot_rows[GLYPH_BATCH][SCENE_NUM_ANGLES];
+    size_t block_off[GLYPH_BATCH][SCENE_NUM_ANGLES];
+    unsigned hash[GLYPH_BATCH][SCENE_NUM_ANGLES];
+
+    char *text;                  // filas seguidas, cada una terminada en '\0'
+    size_t text_len, text_cap;
+    size_t *row_off;             // offset de cada fila en text
+    int num_rows, rows_cap;
+    char *blocks;                // bloques armados por el pool
+    size_t blocks_cap;
+} GlyphBatch;
+
+/*
+ * Arma figuras y glifos a medida que llegan los tokens, sin copia del
+ * archivo ni árbol DOM: la memoria pico queda cerca del modelo final.
+ */
+typedef struct {
+    JsonStream js;
+    AnimationConfig *config;
+    int declared;                // "num_figures" (-1 = todavía no apareció)
+    int capacity;                // figuras reservadas en config->figures y en la escena
+    long long figures_offset;    // byte del arreglo "figures" (-1 = no apareció)
+
+    ThreadPool *pool;
+    GlyphBatch batch[2];
+    int cur;                     // tanda que llena el lector
+    int pending;                 // tanda en el pool (-1 = ninguna)
+} ConfigReader;
+
+static int key_is(const ConfigReader *r, const char *key) {
+    return strcmp(r->js.text, key) == 0;
+}
+
+static int unexpected(ConfigReader *r, JsonEvent ev, const char *what, const char *expected) {
+    if (ev == JSON_ERROR) return -1;
+    return json_fail(&r->js, r->js.offset, "%s: se esperaba %s y vino %s",
+                     what, expected, json_event_name(ev));
+}
+
+static int skip_value(ConfigReader *r) {
+    return json_skip(&r->js, json_next(&r->js));
+}
+
+static int read_int(ConfigReader *r, const char *what, int *out) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_NUMBER) return unexpected(r, ev, what, "un entero");
+    double v = r->js.number;
+    if (v < INT_MIN || v > INT_MAX || (double)(long long)v != v) {
+        return json_fail(&r->js, r->js.offset, "%s: %g no es un entero válido", what, v);
+    }
+    *out = (int)v;
+    return 0;
+}
+
+// Presupuesto en bytes: entero, no negativo y dentro de long (el cast de fuera es indefinido)
+static int valid_budget(double v) {
+    return v >= 0 && v < (double)LONG_MAX + 1.0 && (double)(long)v == v;
+}
+
+static int read_budget(ConfigReader *r, const char *what, long *out) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_NUMBER) return unexpected(r, ev, what, "un entero");
+    double v = r->js.number;
+    if (!valid_budget(v)) {
+        return json_fail(&r->js, r->js.offset, "%s: %g no es una cantidad de bytes válida", what, v);
+    }
+    *out = (long)v;
+    return 0;
+}
+
+static int read_bool(ConfigReader *r, const char *what, int *out) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_TRUE && ev != JSON_FALSE) return unexpected(r, ev, what, "un booleano");
+    *out = ev == JSON_TRUE;
+    return 0;
+}
+
+// La cadena queda en r->js.text hasta el próximo evento
+static int read_string(ConfigReader *r, const char *what) {
+    JsonEvent ev = json_next(&r->js);
+    return ev == JSON_STRING ? 0 : unexpected(r, ev, what, "una cadena");
+}
+
+static int open_object(ConfigReader *r, const char *what) {
+    JsonEvent ev = json_next(&r->js);
+    return ev == JSON_OBJECT_START ? 0 : unexpected(r, ev, what, "un objeto");
+}
+
+static int missing(ConfigReader *r, long long offset, const char *what, const char *key) {
+    return json_fail(&r->js, offset, "%s: falta \"%s\"", what, key);
+}
+
+// {"x": .., "y": ..}
+static int read_position(ConfigReader *r, const char *what, Position *p) {
+    if (open_object(r, what) != 0) return -1;
+    long long start = r->js.offset;
+    int has_x = 0, has_y = 0;
+    JsonEvent ev;
+    char name[64];
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "x")) {
+            snprintf(name, sizeof(name), "%s.x", what);
+            rc = read_int(r, name, &p->x);
+            has_x = 1;
+        } else if (key_is(r, "y")) {
+            snprintf(name, sizeof(name), "%s.y", what);
+            rc = read_int(r, name, &p->y);
+            has_y = 1;
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    if (ev != JSON_OBJECT_END) return -1;
+    if (!has_x) return missing(r, start, what, "x");
+    if (!has_y) return missing(r, start, what, "y");
+    return 0;
+}
+
+static int read_canvas(ConfigReader *r) {
+    if (open_object(r, "canvas") != 0) return -1;
+    long long start = r->js.offset;
+    int has_w = 0, has_h = 0;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "width")) {
+            rc = read_int(r, "canvas.width", &r->config->canvas.width);
+            has_w = 1;
+        } else if (key_is(r, "height")) {
+            rc = read_int(r, "canvas.height", &r->config->canvas.height);
+            has_h = 1;
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    if (ev != JSON_OBJECT_END) return -1;
+    if (!has_w) return missing(r, start, "canvas", "width");
+    if (!has_h) return missing(r, start, "canvas", "height");
+    return 0;
+}
+
+static int read_frame_cache(ConfigReader *r) {
+    if (open_object(r, "frame_cache") != 0) return -1;
+    // Pedido explícito: con caché aunque no haya repeticiones
+    r->config->frame_cache_bytes = FRAME_CACHE_DEFAULT_BUDGET;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "budget_bytes")) {
+            rc = read_budget(r, "frame_cache.budget_bytes", &r->config->frame_cache_bytes);
+        } else if (key_is(r, "compress")) {
+            rc = read_bool(r, "frame_cache.compress", &r->config->frame_cache_compress);
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+static int read_sinks(ConfigReader *r) {
+    if (open_object(r, "sinks") != 0) return -1;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "policy")) {
+            rc = read_string(r, "sinks.policy");
+            if (rc == 0) r->config->sink_policy = sink_policy_from_string(r->js.text);
+        } else if (key_is(r, "capacity")) {
+            rc = read_int(r, "sinks.capacity", &r->config->sink_capacity);
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+static int read_slow(ConfigReader *r) {
+    if (open_object(r, "displays.slow") != 0) return -1;
+    DisplayLayout *d = &r->config->displays;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "id")) rc = read_int(r, "displays.slow.id", &d->slow_id);
+        else if (key_is(r, "delay_ms")) rc = read_int(r, "displays.slow.delay_ms", &d->slow_delay_ms);
+        else rc = skip_value(r);
+        if (rc != 0) return -1;
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+static int read_displays(ConfigReader *r) {
+    if (open_object(r, "displays") != 0) return -1;
+    DisplayLayout *d = &r->config->displays;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "rows")) {
+            rc = read_int(r, "displays.rows", &d->rows);
+        } else if (key_is(r, "cols")) {
+            rc = read_int(r, "displays.cols", &d->cols);
+        } else if (key_is(r, "sink")) {
+            rc = read_string(r, "displays.sink");
+            if (rc == 0) snprintf(d->sink, sizeof(d->sink), "%s", r->js.text);
+        } else if (key_is(r, "transport")) {
+            rc = read_string(r, "displays.transport");
+            if (rc == 0) d->transport = display_transport_from_string(r->js.text);
+        } else if (key_is(r, "sync")) {
+            rc = read_bool(r, "displays.sync", &d->present_sync);
+        } else if (key_is(r, "sync_timeout_ms")) {
+            rc = read_int(r, "displays.sync_timeout_ms", &d->sync_timeout_ms);
+        } else if (key_is(r, "slow")) {
+            rc = read_slow(r);
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+/*
+ * "path" de una figura o "pan" de un viewport: [{"t": .., "x": .., "y": ..}, ...].
+ * *keys y *count deben llegar en NULL y 0; un arreglo vacío equivale a no tenerlo.
+ */
+static int read_keyframes(ConfigReader *r, const char *what, Keyframe **keys, int *count) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_ARRAY_START) return unexpected(r, ev, what, "un arreglo");
+    int cap = 0;
+    char name[64];
+    while ((ev = json_next(&r->js)) != JSON_ARRAY_END) {
+        snprintf(name, sizeof(name), "%s[%d]", what, *count);
+        if (ev != JSON_OBJECT_START) return unexpected(r, ev, name, "un objeto");
+        long long start = r->js.offset;
+        if (*count == cap) {
+            cap = cap ? cap * 2 : 8;
+            Keyframe *grown = realloc(*keys, sizeof(Keyframe) * cap);
+            if (!grown) return json_fail(&r->js, start, "%s: sin memoria", name);
+            *keys = grown;
+        }
+        Keyframe *key = &(*keys)[*count];
+        int has_t = 0, has_x = 0, has_y = 0;
+        while ((ev = json_next(&r->js)) == JSON_KEY) {
+            int rc;
+            if (key_is(r, "t")) {
+                rc = read_int(r, name, &key->t);
+                has_t = 1;
+            } else if (key_is(r, "x")) {
+                rc = read_int(r, name, &key->pos.x);
+                has_x = 1;
+            } else if (key_is(r, "y")) {
+                rc = read_int(r, name, &key->pos.y);
+                has_y = 1;
+            } else {
+                rc = skip_value(r);
+            }
+            if (rc != 0) return -1;
+        }
+        if (ev != JSON_OBJECT_END) return -1;
+        if (!has_t) return missing(r, start, name, "t");
+        if (!has_x) return missing(r, start, name, "x");
+        if (!has_y) return missing(r, start, name, "y");
+        (*count)++;
+    }
+    if (*count == 0) {
+        free(*keys);
+        *keys = NULL;
+    }
+    return 0;
+}
+
+static int read_world(ConfigReader *r) {
+    if (open_object(r, "world") != 0) return -1;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "width")) rc = read_int(r, "world.width", &r->config->world.width);
+        else if (key_is(r, "height")) rc = read_int(r, "world.height", &r->config->world.height);
+        else rc = skip_value(r);
+        if (rc != 0) return -1;
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+// "viewports": [{"x", "y", "width", "height", "screen": {"x", "y"}, "pan": [keyframes]}, ...]
+static int read_viewports(ConfigReader *r) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_ARRAY_START) return unexpected(r, ev, "viewports", "un arreglo");
+    char what[32], name[64];
+    while ((ev = json_next(&r->js)) != JSON_ARRAY_END) {
+        snprintf(what, sizeof(what), "viewports[%d]", r->config->num_viewports);
+        if (ev != JSON_OBJECT_START) return unexpected(r, ev, what, "un objeto");
+        long long start = r->js.offset;
+        Viewport vp;
+        memset(&vp, 0, sizeof(vp));
+        Keyframe *pan = NULL;
+        int num_pan = 0, rc = 0;
+        while (rc == 0 && (ev = json_next(&r->js)) == JSON_KEY) {
+            snprintf(name, sizeof(name), "%s.%s", what, r->js.text);
+            if (key_is(r, "x")) {
+                rc = read_int(r, name, &vp.x);
+            } else if (key_is(r, "y")) {
+                rc = read_int(r, name, &vp.y);
+            } else if (key_is(r, "width")) {
+                rc = read_int(r, name, &vp.width);
+            } else if (key_is(r, "height")) {
+                rc = read_int(r, name, &vp.height);
+            } else if (key_is(r, "screen")) {
+                Position at;
+                rc = read_position(r, name, &at);
+                vp.screen_x = at.x;
+                vp.screen_y = at.y;
+            } else if (key_is(r, "pan")) {
+                rc = read_keyframes(r, name, &pan, &num_pan);
+            } else {
+                rc = skip_value(r);
+            }
+        }
+        if (rc != 0 || ev != JSON_OBJECT_END) {
+            free(pan);
+            return -1;
+        }
+        if (add_viewport(r->config, vp, pan, num_pan) != 0) {
+            return json_fail(&r->js, start, "%s: sin memoria", what);
+        }
+    }
+    return 0;
+}
+
+static int stage_row(GlyphBatch *b, const char *row, size_t len) {
+    if (b->num_rows == b->rows_cap) {
+        int cap = b->rows_cap ? b->rows_cap * 2 : 1024;
+        size_t *off = realloc(b->row_off, sizeof(size_t) * cap);
+        if (!off) return -1;
+        b->row_off = off;
+        b->rows_cap = cap;
+    }
+    if (b->text_len + len + 1 > b->text_cap) {
+        size_t cap = b->text_cap ? b->text_cap : 16384;
+        while (cap < b->text_len + len + 1) cap *= 2;
+        char *text = realloc(b->text, cap);
+        if (!text) return -1;
+        b->text = text;
+        b->text_cap = cap;
+    }
+    b->row_off[b->num_rows++] = b->text_len;
+    memcpy(b->text + b->text_len, row, len + 1);
+    b->text_len += len + 1;
+    return 0;
+}
+
+// "rotations": {"0": [filas], "90": [...], "180": [...], "270": [...]}
+static int read_rotations(ConfigReader *r, const char *what) {
+    if (open_object(r, what) != 0) return -1;
+    GlyphBatch *b = &r->batch[r->cur];
+    int slot = b->count;
+    JsonEvent ev;
+    char name[64];
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int k = -1;
+        for (int a = 0; a < SCENE_NUM_ANGLES; a++) {
+            char key[4];
+            snprintf(key, sizeof(key), "%d", a * 90);
+            if (key_is(r, key)) k = a;
+        }
+        if (k < 0) {
+            if (skip_value(r) != 0) return -1;
             continue;
         }
+        snprintf(name, sizeof(name), "%s.%d", what, k * 90);
+        ev = json_next(&r->js);
+        if (ev != JSON_ARRAY_START) return unexpected(r, ev, name, "un arreglo de filas");
+        b->rot_first[slot][k] = b->num_rows;
+        while ((ev = json_next(&r->js)) == JSON_STRING) {
+            if (stage_row(b, r->js.text, r->js.text_len) != 0) {
+                return json_fail(&r->js, r->js.offset, "%s: sin memoria", name);
+            }
+        }
+        if (ev != JSON_ARRAY_END) return unexpected(r, ev, name, "una cadena");
+        b->rot_rows[slot][k] = b->num_rows - b->rot_first[slot][k];
+    }
+    return ev == JSON_OBJECT_END ? 0 : -1;
+}
+
+// Reserva lugar para la figura i en config->figures y en la escena
+static int reserve_figure(ConfigReader *r, int i) {
+    AnimationConfig *config = r->config;
+    if (i == r->capacity) {
+        int cap = r->declared > i ? r->declared : (r->capacity ? r->capacity * 2 : 64);
+        Figure *figures = realloc(config->figures, sizeof(Figure) * cap);
+        if (!figures) return -1;
+        config->figures = figures;
+        if (scene_resize(config->scene, cap) != 0) return -1;
+        r->capacity = cap;
+    }
+    memset(&config->figures[i], 0, sizeof(Figure));
+    config->num_figures = i + 1;    // free_config ya la libera si algo falla
+    return 0;
+}
+
+// Tarea del pool: arma el bloque y el hash de cada glifo de las figuras [begin, end)
+static void prepare_glyphs(void *ctx, int begin, int end) {
+    GlyphBatch *b = ctx;
+    for (int slot = begin; slot < end; slot++) {
+        int rows = b->rows[slot], cols = b->cols[slot];
+        for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+            int first = b->rot_first[slot][k];
+            if (first < 0) continue;
+            char *block = b->blocks + b->block_off[slot][k];
+            memset(block, '\0', (size_t)rows * (cols + 1));
+            for (int j = 0; j < rows && j < b->rot_rows[slot][k]; j++) {
+                strncpy(block + j * (cols + 1), b->text + b->row_off[first + j], cols);
+            }
+            b->hash[slot][k] = sprite_hash(block, rows, cols);
+        }
+    }
+}
+
+// Espera la tanda que está en el pool y la interna en orden de figura
+static int merge_glyphs(ConfigReader *r) {
+    if (r->pending < 0) return 0;
+    thread_pool_wait(r->pool);
+    GlyphBatch *b = &r->batch[r->pending];
+    r->pending = -1;
+    for (int slot = 0; slot < b->count; slot++) {
+        for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+            if (b->rot_first[slot][k] < 0) continue;
+            if (scene_intern_glyph_hashed(r->config->scene, b->first + slot, k,
+                                          b->blocks + b->block_off[slot][k], b->hash[slot][k]) != 0) {
+                return json_fail(&r->js, r->js.offset, "figures[%d]: sin memoria para el glifo",
+                                 b->first + slot);
+            }
+        }
+    }
+    return 0;
+}
+
+// Manda la tanda en curso al pool y deja la otra lista para seguir leyendo
+static int flush_glyphs(ConfigReader *r) {
+    GlyphBatch *b = &r->batch[r->cur];
+    if (b->count == 0) return 0;
+
+    size_t total = 0;
+    for (int slot = 0; slot < b->count; slot++) {
+        for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+            if (b->rot_first[slot][k] < 0) continue;
+            b->block_off[slot][k] = total;
+            total += (size_t)b->rows[slot] * (b->cols[slot] + 1);
+        }
+    }
+    if (total > b->blocks_cap) {
+        char *blocks = realloc(b->blocks, total);
+        if (!blocks) return json_fail(&r->js, r->js.offset, "sin memoria para los glifos");
+        b->blocks = blocks;
+        b->blocks_cap = total;
+    }
+
+    if (merge_glyphs(r) != 0) return -1;
+    thread_pool_start(r->pool, prepare_glyphs, b, b->count, GLYPH_CHUNK);
+    r->pending = r->cur;
+    r->cur ^= 1;
+
+    GlyphBatch *next = &r->batch[r->cur];
+    next->count = 0;
+    next->num_rows = 0;
+    next->text_len = 0;
+    return 0;
+}
+
+static int read_figure(ConfigReader *r, int i) {
+    long long start = r->js.offset;
+    if (reserve_figure(r, i) != 0) return json_fail(&r->js, start, "figures[%d]: sin memoria", i);
+    Figure *f = &r->config->figures[i];
+
+    GlyphBatch *b = &r->batch[r->cur];
+    int slot = b->count;
+    if (slot == 0) b->first = i;
+    for (int k = 0; k < SCENE_NUM_ANGLES; k++) b->rot_first[slot][k] = -1;
+
+    char what[32], name[64];
+    snprintf(what, sizeof(what), "figures[%d]", i);
+    int has_t_start = 0, has_t_end = 0, has_pos0 = 0, has_pos1 = 0, has_rows = 0, has_cols = 0;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        snprintf(name, sizeof(name), "%s.%s", what, r->js.text);
+        int rc;
+        if (key_is(r, "t_start")) {
+            rc = read_int(r, name, &f->t_start);
+            has_t_start = 1;
+        } else if (key_is(r, "t_end")) {
+            rc = read_int(r, name, &f->t_end);
+            has_t_end = 1;
+        } else if (key_is(r, "pos0")) {
+            rc = read_position(r, name, &f->pos0);
+            has_pos0 = 1;
+        } else if (key_is(r, "pos1")) {
+            rc = read_position(r, name, &f->pos1);
+            has_pos1 = 1;
+        } else if (key_is(r, "rows")) {
+            rc = read_int(r, name, &f->rows);
+            has_rows = 1;
+        } else if (key_is(r, "cols")) {
+            rc = read_int(r, name, &f->cols);
+            has_cols = 1;
+        } else if (key_is(r, "path")) {
+            rc = read_keyframes(r, name, &f->path, &f->num_keyframes);
+        } else if (key_is(r, "rotations")) {
+            rc = read_rotations(r, name);
+        } else if (key_is(r, "color")) {
+            rc = read_string(r, name);
+            if (rc == 0) f->attr = (f->attr & ~ATTR_COLOR_MASK) | attr_color_from_string(r->js.text);
+        } else if (key_is(r, "bold") || key_is(r, "underline")) {
+            int on, flag = key_is(r, "bold") ? ATTR_BOLD : ATTR_UNDERLINE;
+            rc = read_bool(r, name, &on);
+            if (rc == 0) f->attr = on ? f->attr | flag : f->attr & ~flag;
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    if (ev != JSON_OBJECT_END) return -1;
+
+    if (!has_rows) return missing(r, start, what, "rows");
+    if (!has_cols) return missing(r, start, what, "cols");
+    if (f->rows <= 0 || f->cols <= 0) {
+        return json_fail(&r->js, start, "%s: tamaño %dx%d inválido", what, f->rows, f->cols);
+    }
+    if (f->path) {
+        figure_from_path(f);
+    } else {
+        if (!has_t_start) return missing(r, start, what, "t_start");
+        if (!has_t_end) return missing(r, start, what, "t_end");
+        if (!has_pos0) return missing(r, start, what, "pos0");
+        if (!has_pos1) return missing(r, start, what, "pos1");
+    }
+
+    scene_set_figure(r->config->scene, i, f);
+    b->rows[slot] = f->rows;
+    b->cols[slot] = f->cols;
+    b->count++;
+    return b->count == GLYPH_BATCH ? flush_glyphs(r) : 0;
+}
 
-        matrix[i] = malloc(cols + 1);
-        strncpy(matrix[i], row->valuestring, cols);
-        matrix[i][cols] = '\0';
+static int read_figures(ConfigReader *r) {
+    JsonEvent ev = json_next(&r->js);
+    if (ev != JSON_ARRAY_START) return unexpected(r, ev, "figures", "un arreglo");
+    if (r->figures_offset >= 0) return json_fail(&r->js, r->js.offset, "\"figures\" repetido");
+    r->figures_offset = r->js.offset;
+    int i = 0;
+    char what[32];
+    while ((ev = json_next(&r->js)) != JSON_ARRAY_END) {
+        snprintf(what, sizeof(what), "figures[%d]", i);
+        if (ev != JSON_OBJECT_START) return unexpected(r, ev, what, "un objeto");
+        // Las figuras de más (respecto de "num_figures") se ignoran
+        int rc = r->declared >= 0 && i >= r->declared ? json_skip(&r->js, ev) : read_figure(r, i);
+        if (rc != 0) return -1;
+        i++;
     }
-    return matrix;
+    if (flush_glyphs(r) != 0) return -1;
+    return merge_glyphs(r);
+}
+
+// Ajusta la cantidad de figuras leídas a "num_figures"
+static int trim_figures(ConfigReader *r) {
+    AnimationConfig *config = r->config;
+    if (config->num_figures < r->declared) {
+        long long at = r->figures_offset >= 0 ? r->figures_offset : 0;
+        return json_fail(&r->js, at, "figures: se declararon %d figuras y hay %d",
+                         r->declared, config->num_figures);
+    }
+    // "num_figures" llegó después de "figures": se descartan las sobrantes
+    for (int i = r->declared; i < config->num_figures; i++) {
+        free(config->figures[i].path);
+        scene_release_figure(config->scene, i);
+    }
+    config->num_figures = r->declared;
+
+    if (scene_resize(config->scene, r->declared) != 0) return json_fail(&r->js, 0, "sin memoria");
+    Figure *figures = realloc(config->figures, sizeof(Figure) * (r->declared > 0 ? r->declared : 1));
+    if (figures) config->figures = figures;
+    r->capacity = r->declared;
+    return 0;
+}
+
+static int read_root(ConfigReader *r) {
+    AnimationConfig *config = r->config;
+    if (open_object(r, "la raíz") != 0) return -1;
+    int has_canvas = 0;
+    JsonEvent ev;
+    while ((ev = json_next(&r->js)) == JSON_KEY) {
+        int rc;
+        if (key_is(r, "num_figures")) {
+            rc = read_int(r, "num_figures", &r->declared);
+            if (rc == 0 && r->declared < 0) {
+                rc = json_fail(&r->js, r->js.offset, "num_figures: %d es negativo", r->declared);
+            }
+        } else if (key_is(r, "canvas")) {
+            rc = read_canvas(r);
+            has_canvas = 1;
+        } else if (key_is(r, "fps")) {
+            rc = read_int(r, "fps", &config->fps);
+        } else if (key_is(r, "frame_policy")) {
+            rc = read_string(r, "frame_policy");
+            if (rc == 0) config->frame_policy = frame_policy_from_string(r->js.text);
+        } else if (key_is(r, "loops")) {
+            rc = read_int(r, "loops", &config->loops);
+        } else if (key_is(r, "workers")) {
+            rc = read_int(r, "workers", &config->workers);
+        } else if (key_is(r, "collisions")) {
+            rc = read_string(r, "collisions");
+            if (rc == 0) config->collisions = collision_policy_from_string(r->js.text);
+        } else if (key_is(r, "frame_cache")) {
+            rc = read_frame_cache(r);
+        } else if (key_is(r, "sinks")) {
+            rc = read_sinks(r);
+        } else if (key_is(r, "displays")) {
+            rc = read_displays(r);
+        } else if (key_is(r, "world")) {
+            rc = read_world(r);
+        } else if (key_is(r, "viewports")) {
+            rc = read_viewports(r);
+        } else if (key_is(r, "figures")) {
+            rc = read_figures(r);
+        } else {
+            rc = skip_value(r);
+        }
+        if (rc != 0) return -1;
+    }
+    if (ev != JSON_OBJECT_END || json_next(&r->js) != JSON_EOF) return -1;
+
+    if (r->declared < 0) return missing(r, 0, "la raíz", "num_figures");
+    if (!has_canvas) return missing(r, 0, "la raíz", "canvas");
+    return trim_figures(r);
 }
 
 AnimationConfig *load_config(const char *filename) {
+    if (scene_file_probe(filename)) return scene_file_load(filename, 0);
+
+    ConfigReader *r = calloc(1, sizeof(ConfigReader));
+    AnimationConfig *config = malloc(sizeof(AnimationConfig));
+    if (!r || !config) {
+        free(r);
+        free(config);
+        return NULL;
+    }
+    config_defaults(config);
+    config->scene = scene_create(0);
+    r->config = config;
+    r->declared = -1;
+    r->figures_offset = -1;
+    r->pending = -1;
+    r->pool = thread_pool_create(load_threads);
+
+    int rc = json_stream_open(&r->js, filename);
+    if (rc == 0 && !config->scene) rc = json_fail(&r->js, 0, "sin memoria");
+    if (rc == 0) rc = read_root(r);
+    if (rc != 0) fprintf(stderr, "Error en la configuración: %s\n", r->js.error);
+    config->hash = r->js.hash;
+
+    thread_pool_wait(r->pool);      // una tanda puede seguir en el pool si hubo error
+    json_stream_close(&r->js);
+    for (int k = 0; k < 2; k++) {
+        free(r->batch[k].text);
+        free(r->batch[k].row_off);
+        free(r->batch[k].blocks);
+    }
+    ThreadPool *pool = r->pool;
+    free(r);
+    if (rc != 0) {
+        thread_pool_destroy(pool);
+        free_config(config);
+        return NULL;
+    }
+    config_normalize(config);
+    config = config_finish(config, pool);
+    thread_pool_destroy(pool);
+    return config;
+}
+
+/* ---------- Lector con cJSON (árbol completo en memoria) ---------- */
+
+static int dom_int(cJSON *obj, const char *key, int *out) {
+    cJSON *item = cJSON_GetObjectItem(obj, key);
+    if (!cJSON_IsNumber(item)) return 0;
+    *out = item->valueint;
+    return 1;
+}
+
+static const char *dom_string(cJSON *obj, const char *key) {
+    cJSON *item = cJSON_GetObjectItem(obj, key);
+    return cJSON_IsString(item) ? item->valuestring : NULL;
+}
+
+static int dom_position(cJSON *obj, const char *key, Position *p) {
+    cJSON *pos = cJSON_GetObjectItem(obj, key);
+    return dom_int(pos, "x", &p->x) && dom_int(pos, "y", &p->y);
+}
+
+// Bloque temporal para internar una rotación de size bytes, en '\0'
+static char *block_reserve(char **block, int *cap, int size) {
+    if (size > *cap) {
+        char *b = realloc(*block, size);
+        if (!b) return NULL;
+        *block = b;
+        *cap = size;
+    }
+    memset(*block, '\0', size);
+    return *block;
+}
+
+/*
+ * Arma el bloque de una rotación en block (rows * (cols + 1) bytes, filas
+ * terminadas en '\0') y lo interna en la escena: las rotaciones idénticas
+ * comparten un único sprite en el atlas. Como el lector por eventos, imprime
+ * el error y retorna -1 si no es un arreglo de cadenas o no hay memoria.
+ */
+static int parse_rotation_array(Scene *scene, int fig, int k, cJSON *array, char **block, int *block_cap) {
+    if (!cJSON_IsArray(array)) {
+        fprintf(stderr, "Error en la configuración: figures[%d].rotations.%d: se esperaba un "
+                        "arreglo de filas\n", fig, k * 90);
+        return -1;
+    }
+
+    int rows = scene->rows[fig], cols = scene->cols[fig];
+    char *b = block_reserve(block, block_cap, rows * (cols + 1));
+    int i = 0;
+    cJSON *row;
+    cJSON_ArrayForEach(row, array) {
+        if (!cJSON_IsString(row)) {
+            fprintf(stderr, "Error en la configuración: figures[%d].rotations.%d[%d]: se esperaba "
+                            "una cadena\n", fig, k * 90, i);
+            return -1;
+        }
+        if (b && i < rows) strncpy(b + i * (cols + 1), row->valuestring, cols);
+        i++;
+    }
+    if (!b || scene_intern_glyph(scene, fig, k, b) != 0) {
+        fprintf(stderr, "Error en la configuración: figures[%d]: sin memoria para los glifos\n", fig);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Lee "path" o "pan": [{"t": .., "x": .., "y": ..}, ...] en *keys (NULL si
+ * no hay keyframes). Imprime el error y retorna -1 si no es un arreglo, a
+ * un keyframe le falta algo o no hay memoria.
+ */
+static int parse_path(cJSON *array, const char *what, Keyframe **keys, int *count) {
+    *keys = NULL;
+    *count = 0;
+    if (!array) return 0;
+    if (!cJSON_IsArray(array)) {
+        fprintf(stderr, "Error en la configuración: %s: se esperaba un arreglo\n", what);
+        return -1;
+    }
+    int n = cJSON_GetArraySize(array);
+    if (n == 0) return 0;
+
+    Keyframe *path = malloc(sizeof(Keyframe) * n);
+    if (!path) {
+        fprintf(stderr, "Error en la configuración: %s: sin memoria\n", what);
+        return -1;
+    }
+    int i = 0;
+    cJSON *key;
+    cJSON_ArrayForEach(key, array) {
+        if (!dom_int(key, "t", &path[i].t) || !dom_int(key, "x", &path[i].pos.x) ||
+            !dom_int(key, "y", &path[i].pos.y)) {
+            fprintf(stderr, "Error en la configuración: %s[%d]: necesita \"t\", \"x\" e \"y\"\n",
+                    what, i);
+            free(path);
+            return -1;
+        }
+        i++;
+    }
+    *keys = path;
+    *count = n;
+    return 0;
+}
+
+// Figura i del arreglo; imprime qué falta y retorna -1 si está incompleta
+static int parse_figure(AnimationConfig *config, int i, cJSON *fig, char **block, int *block_cap) {
+    Figure *fptr = &config->figures[i];
+    memset(fptr, 0, sizeof(Figure));
+    if (!cJSON_IsObject(fig)) {
+        fprintf(stderr, "Error en la configuración: figures[%d] no es un objeto\n", i);
+        return -1;
+    }
+
+    char what[32];
+    snprintf(what, sizeof(what), "figures[%d].path", i);
+    if (parse_path(cJSON_GetObjectItem(fig, "path"), what, &fptr->path, &fptr->num_keyframes) != 0) {
+        return -1;
+    }
+
+    const char *lacking = NULL;
+    if (fptr->path) {
+        figure_from_path(fptr);
+    } else if (!dom_int(fig, "t_start", &fptr->t_start)) {
+        lacking = "t_start";
+    } else if (!dom_int(fig, "t_end", &fptr->t_end)) {
+        lacking = "t_end";
+    } else if (!dom_position(fig, "pos0", &fptr->pos0)) {
+        lacking = "pos0";
+    } else if (!dom_position(fig, "pos1", &fptr->pos1)) {
+        lacking = "pos1";
+    }
+    if (!lacking && !dom_int(fig, "rows", &fptr->rows)) lacking = "rows";
+    if (!lacking && !dom_int(fig, "cols", &fptr->cols)) lacking = "cols";
+    if (lacking) {
+        fprintf(stderr, "Error en la configuración: figures[%d]: falta \"%s\"\n", i, lacking);
+        return -1;
+    }
+    if (fptr->rows <= 0 || fptr->cols <= 0) {
+        fprintf(stderr, "Error en la configuración: figures[%d]: tamaño %dx%d inválido\n",
+                i, fptr->rows, fptr->cols);
+        return -1;
+    }
+
+    // Color opcional: "color" ("red", "bright_cyan", ...), "bold" y "underline"
+    fptr->attr = attr_color_from_string(dom_string(fig, "color"));
+    if (cJSON_IsTrue(cJSON_GetObjectItem(fig, "bold"))) fptr->attr |= ATTR_BOLD;
+    if (cJSON_IsTrue(cJSON_GetObjectItem(fig, "underline"))) fptr->attr |= ATTR_UNDERLINE;
+
+    scene_set_figure(config->scene, i, fptr);
+
+    // Las rotaciones van directo al atlas
+    cJSON *rot = cJSON_GetObjectItem(fig, "rotations");
+    if (rot && !cJSON_IsObject(rot)) {
+        fprintf(stderr, "Error en la configuración: figures[%d].rotations: se esperaba un objeto\n", i);
+        return -1;
+    }
+    for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+        char key[4];
+        sprintf(key, "%d", k * 90);
+        cJSON *rotation = cJSON_GetObjectItem(rot, key);
+        if (rotation && parse_rotation_array(config->scene, i, k, rotation, block, block_cap) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int parse_root(AnimationConfig *config, cJSON *root) {
+    int num_figures;
+    cJSON *canvas = cJSON_GetObjectItem(root, "canvas");
+    if (!dom_int(root, "num_figures", &num_figures) || num_figures < 0) {
+        fprintf(stderr, "Error en la configuración: falta \"num_figures\"\n");
+        return -1;
+    }
+    if (!dom_int(canvas, "width", &config->canvas.width) ||
+        !dom_int(canvas, "height", &config->canvas.height)) {
+        fprintf(stderr, "Error en la configuración: \"canvas\" necesita \"width\" y \"height\"\n");
+        return -1;
+    }
+
+    // Ritmo opcional: "fps" (0 = sin límite) y "frame_policy" ("drop" / "catch_up")
+    dom_int(root, "fps", &config->fps);
+    config->frame_policy = frame_policy_from_string(dom_string(root, "frame_policy"));
+
+    // Repeticiones y caché de frames codificados: "frame_cache": {"budget_bytes", "compress"}
+    dom_int(root, "loops", &config->loops);
+
+    // "workers": hilos de render del motor mt con figuras repartidas por costo (balancer.h)
+    dom_int(root, "workers", &config->workers);
+
+    // "collisions": "flag" | "stop" | "bounce" (collision.h; sin la clave no se detectan)
+    config->collisions = collision_policy_from_string(dom_string(root, "collisions"));
+    cJSON *cache = cJSON_GetObjectItem(root, "frame_cache");
+    cJSON *budget = cJSON_GetObjectItem(cache, "budget_bytes");
+    if (cJSON_IsObject(cache)) config->frame_cache_bytes = FRAME_CACHE_DEFAULT_BUDGET;
+    if (cJSON_IsNumber(budget)) {
+        if (!valid_budget(budget->valuedouble)) {
+            fprintf(stderr, "Error en la configuración: frame_cache.budget_bytes: %g no es una "
+                            "cantidad de bytes válida\n", budget->valuedouble);
+            return -1;
+        }
+        config->frame_cache_bytes = (long)budget->valuedouble;
+    }
+    config->frame_cache_compress = cJSON_IsTrue(cJSON_GetObjectItem(cache, "compress"));
+
+    // "sinks": {"policy": "drop_oldest" | "coalesce" | "block", "capacity"}
+    cJSON *sinks = cJSON_GetObjectItem(root, "sinks");
+    config->sink_policy = sink_policy_from_string(dom_string(sinks, "policy"));
+    dom_int(sinks, "capacity", &config->sink_capacity);
+
+    // "displays": {"rows", "cols", "sink", "transport", "sync", "sync_timeout_ms",
+    //              "slow": {"id", "delay_ms"}} (sink admite "%d", p. ej. "/dev/pts/%d")
+    cJSON *displays = cJSON_GetObjectItem(root, "displays");
+    DisplayLayout *d = &config->displays;
+    dom_int(displays, "rows", &d->rows);
+    dom_int(displays, "cols", &d->cols);
+    const char *dsink = dom_string(displays, "sink");
+    if (dsink) snprintf(d->sink, sizeof(d->sink), "%s", dsink);
+    d->transport = display_transport_from_string(dom_string(displays, "transport"));
+    d->present_sync = cJSON_IsTrue(cJSON_GetObjectItem(displays, "sync"));
+    dom_int(displays, "sync_timeout_ms", &d->sync_timeout_ms);
+    cJSON *slow = cJSON_GetObjectItem(displays, "slow");
+    dom_int(slow, "id", &d->slow_id);
+    dom_int(slow, "delay_ms", &d->slow_delay_ms);
+
+    // "world": {"width", "height"} y "viewports": [{"x", "y", "width", "height",
+    //          "screen": {"x", "y"}, "pan": [keyframes]}] (viewport.h)
+    cJSON *world = cJSON_GetObjectItem(root, "world");
+    dom_int(world, "width", &config->world.width);
+    dom_int(world, "height", &config->world.height);
+    cJSON *viewports = cJSON_GetObjectItem(root, "viewports");
+    for (cJSON *item = cJSON_IsArray(viewports) ? viewports->child : NULL; item; item = item->next) {
+        Viewport vp;
+        memset(&vp, 0, sizeof(vp));
+        Position at = {0, 0};
+        dom_int(item, "x", &vp.x);
+        dom_int(item, "y", &vp.y);
+        dom_int(item, "width", &vp.width);
+        dom_int(item, "height", &vp.height);
+        if (dom_position(item, "screen", &at)) {
+            vp.screen_x = at.x;
+            vp.screen_y = at.y;
+        }
+        char what[32];
+        snprintf(what, sizeof(what), "viewports[%d].pan", config->num_viewports);
+        Keyframe *pan;
+        int num_pan;
+        if (parse_path(cJSON_GetObjectItem(item, "pan"), what, &pan, &num_pan) != 0) return -1;
+        if (add_viewport(config, vp, pan, num_pan) != 0) {
+            fprintf(stderr, "Error en la configuración: viewports: sin memoria\n");
+            return -1;
+        }
+    }
+
+    cJSON *figures = cJSON_GetObjectItem(root, "figures");
+    if (num_figures > 0 && (!cJSON_IsArray(figures) || cJSON_GetArraySize(figures) < num_figures)) {
+        fprintf(stderr, "Error en la configuración: se declararon %d figuras y hay %d\n",
+                num_figures, cJSON_GetArraySize(figures));
+        return -1;
+    }
+    config->figures = malloc(sizeof(Figure) * (num_figures > 0 ? num_figures : 1));
+    config->scene = scene_create(num_figures);
+    if (!config->figures || !config->scene) return -1;
+
+    char *block = NULL;      // bloque temporal para internar rotaciones
+    int block_cap = 0;
+    int rc = 0;
+    cJSON *fig = figures ? figures->child : NULL;   // recorrido en orden: cJSON_GetArrayItem es O(i)
+    for (int i = 0; i < num_figures && rc == 0; i++, fig = fig->next) {
+        config->num_figures = i + 1;
+        rc = parse_figure(config, i, fig, &block, &block_cap);
+    }
+    free(block);
+    return rc;
+}
+
+AnimationConfig *load_config_cjson(const char *filename) {
     FILE *f = fopen(filename, "r");
     if (!f) {
         perror("No se pudo abrir el archivo de configuración");
@@ -34,10 +1098,16 @@ AnimationConfig *load_config(const char *filename) {
     rewind(f);
 
     char *json_str = malloc(fsize + 1);
-    fread(json_str, 1, fsize, f);
+    if (!json_str || fread(json_str, 1, fsize, f) != (size_t)fsize) {
+        fprintf(stderr, "Error leyendo %s\n", filename);
+        free(json_str);
+        fclose(f);
+        return NULL;
+    }
     json_str[fsize] = 0;
     fclose(f);
 
+    unsigned long long hash = hash_bytes(json_str, fsize);
     cJSON *root = cJSON_Parse(json_str);
     free(json_str);
     if (!root) {
@@ -46,68 +1116,35 @@ AnimationConfig *load_config(const char *filename) {
     }
 
     AnimationConfig *config = malloc(sizeof(AnimationConfig));
-    config->num_figures = cJSON_GetObjectItem(root, "num_figures")->valueint;
-
-    cJSON *canvas = cJSON_GetObjectItem(root, "canvas");
-    config->canvas.width = cJSON_GetObjectItem(canvas, "width")->valueint;
-    config->canvas.height = cJSON_GetObjectItem(canvas, "height")->valueint;
-
-    cJSON *figures = cJSON_GetObjectItem(root, "figures");
-    config->figures = malloc(sizeof(Figure) * config->num_figures);
-
-    for (int i = 0; i < config->num_figures; i++) {
-        cJSON *fig = cJSON_GetArrayItem(figures, i);
-        Figure *fptr = &config->figures[i];
-
-        fptr->t_start = cJSON_GetObjectItem(fig, "t_start")->valueint;
-        fptr->t_end = cJSON_GetObjectItem(fig, "t_end")->valueint;
-
-        cJSON *pos0 = cJSON_GetObjectItem(fig, "pos0");
-        cJSON *pos1 = cJSON_GetObjectItem(fig, "pos1");
-        fptr->pos0.x = cJSON_GetObjectItem(pos0, "x")->valueint;
-        fptr->pos0.y = cJSON_GetObjectItem(pos0, "y")->valueint;
-        fptr->pos1.x = cJSON_GetObjectItem(pos1, "x")->valueint;
-        fptr->pos1.y = cJSON_GetObjectItem(pos1, "y")->valueint;
-
-        fptr->rows = cJSON_GetObjectItem(fig, "rows")->valueint;
-        fptr->cols = cJSON_GetObjectItem(fig, "cols")->valueint;
-
-        fptr->rotations = malloc(sizeof(char **) * 360);
-        for (int j = 0; j < 360; j++) fptr->rotations[j] = NULL;
-
-        cJSON *rot = cJSON_GetObjectItem(fig, "rotations");
-        fptr->num_rotations = 0;
-
-        int angles[] = {0, 90, 180, 270};
-        for (int k = 0; k < 4; k++) {
-            char key[4];
-            sprintf(key, "%d", angles[k]);
-            cJSON *rotation = cJSON_GetObjectItem(rot, key);
-            if (rotation) {
-                fptr->rotations[angles[k]] = parse_rotation_array(rotation, fptr->rows, fptr->cols);
-                fptr->num_rotations++;
-            }
-        }
+    if (!config) {
+        cJSON_Delete(root);
+        return NULL;
     }
-
+    config_defaults(config);
+    config->hash = hash;
+    int rc = parse_root(config, root);
     cJSON_Delete(root);
-    return config;
+    if (rc != 0) {
+        free_config(config);
+        return NULL;
+    }
+    config_normalize(config);
+    return config_finish(config, NULL);
 }
 
 void free_config(AnimationConfig *config) {
     if (!config) return;
+    if (config->file) {
+        scene_file_unload(config);
+        return;
+    }
     for (int i = 0; i < config->num_figures; i++) {
-        Figure *f = &config->figures[i];
-        for (int a = 0; a < 360; a++) {
-            if (f->rotations[a]) {
-                for (int r = 0; r < f->rows; r++) {
-                    free(f->rotations[a][r]);
-                }
-                free(f->rotations[a]);
-            }
-        }
-        free(f->rotations);
+        free(config->figures[i].path);  // las rotaciones viven en el atlas de la escena
     }
+    trajectory_free(config->trajectory);
+    scene_free(config->scene);
     free(config->figures);
+    free(config->viewports);
+    free(config->pan_keys);
     free(config);
-}
\ No newline at end of file
+}
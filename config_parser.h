@@ -3,8 +3,24 @@
 
 #include "anim_config.h"
 
-// Función para leer y parsear el archivo JSON
+/*
+ * Lee el archivo JSON por eventos (json_stream.h) y arma figuras y glifos
+ * sin copiar el archivo. Los errores se reportan con el byte donde
+ * ocurren, p. ej. "config.json:1234: figures[3]: falta \"rows\"".
+ * Si filename es una escena compilada (scene_file.h) la mapea en su lugar;
+ * en ese caso config->figures queda en NULL.
+ */
 AnimationConfig *load_config(const char *filename);
+
+/*
+ * Hilos del pool que arma glifos, vistas y trayectorias en load_config
+ * (0 = uno por procesador, 1 = todo en el hilo que llama). El resultado
+ * es el mismo con cualquier cantidad.
+ */
+void config_set_load_threads(int threads);
+
+// Misma configuración leída con cJSON (archivo entero + árbol DOM); para comparar
+AnimationConfig *load_config_cjson(const char *filename);
 void free_config(AnimationConfig *config);
 
 #endif // CONFIG_PARSER_H
\ No newline at end of file
@@ -0,0 +1,498 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "display.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "anim_stats.h"
+#include "display_proto.h"
+#include "render.h"
+#include "scene.h"
+#include "viewport.h"
+
+Rect display_region(const Canvas *canvas, int rows, int cols, int r, int c) {
+    Rect region;
+    region.x = c * canvas->width / cols;
+    region.y = r * canvas->height / rows;
+    region.w = (c + 1) * canvas->width / cols - region.x;
+    region.h = (r + 1) * canvas->height / rows - region.y;
+    return region;
+}
+
+DisplayTransport display_transport_from_string(const char *name) {
+    if (name && strcmp(name, "shm") == 0) return DISPLAY_TRANSPORT_SHM;
+    if (name && strcmp(name, "socket") == 0) return DISPLAY_TRANSPORT_SOCKET;
+    return DISPLAY_TRANSPORT_PIPE;
+}
+
+void display_sink_path(const char *pattern, int id, char *out, size_t size) {
+    const char *mark = strstr(pattern, "%d");
+    if (!mark) {
+        snprintf(out, size, "%s", pattern);
+        return;
+    }
+    snprintf(out, size, "%.*s%d%s", (int)(mark - pattern), pattern, id, mark + 2);
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/*
+ * Cuerpo del proceso de un display: copia lo que llega por in_fd al
+ * destino hasta que el renderizador cierra el canal.
+ */
+static void display_process_main(int in_fd, const char *sink) {
+    int out = open(sink, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        perror(sink);
+        _exit(1);
+    }
+    char buf[64 * 1024];
+    ssize_t n;
+    while ((n = read(in_fd, buf, sizeof(buf))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (write_all(out, buf, n) != 0) break;
+    }
+    close(out);
+    _exit(0);
+}
+
+/*
+ * Display local sobre socket: aplica los mensajes del protocolo binario a
+ * su propio buffer y dibuja en el destino solo lo que cambió.
+ */
+static void display_socket_main(int in_fd, Display *d, const char *sink) {
+    int out = open(sink, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        perror(sink);
+        _exit(1);
+    }
+    ProtoServeStats stats;
+    int status = proto_serve(in_fd, out, &stats);
+    fprintf(stderr, "[DISPLAY %d] región %dx%d en (%d,%d) | %ld frames | %lld bytes recibidos | "
+            "%lld bytes dibujados\n",
+            d->id, d->region.w, d->region.h, d->region.x, d->region.y,
+            stats.frames, stats.wire_bytes, stats.output_bytes);
+    close(out);
+    _exit(status == 0 ? 0 : 1);
+}
+
+// Sink "unix:/ruta": display externo escuchando en un socket Unix
+static int connect_display_server(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// El protocolo binario lleva solo caracteres: el color no viaja por el socket
+static int proto_sink_encode(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                             const unsigned char *cur_attrs, int width, int height,
+                             unsigned long seq, ByteBuffer *out) {
+    (void)prev_attrs;
+    (void)cur_attrs;
+    return proto_encode_frame(prev, cur, width, height, (uint32_t)seq, out);
+}
+
+static void swap_region(Display *d) {
+    char *tmp = d->prev;
+    d->prev = d->cur;
+    d->cur = tmp;
+    d->has_prev = 1;
+}
+
+/*
+ * Cuerpo del proceso de un display sobre el anillo compartido: toma el
+ * frame publicado más reciente, lee su región directamente del slot y la
+ * codifica acá, en paralelo con los demás displays. La región se copia a
+ * cur solo para que sirva de base al delta siguiente.
+ */
+static void display_shm_main(DisplaySet *ds, Display *d, const char *sink) {
+    ShmRing *ring = &ds->ring;
+    PresentSyncShared *sync = ds->present_sync ? ds->sync.shared : NULL;
+    struct timespec delay = {ds->slow_delay_ms / 1000, (ds->slow_delay_ms % 1000) * 1000000L};
+    int slow = d->id == ds->slow_id && ds->slow_delay_ms > 0;
+    ring->owner = 0;  // el anillo lo borra el renderizador
+    int out = open(sink, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        perror(sink);
+        shm_ring_release(ring, d->id, UINT64_MAX);  // no hacer esperar al productor
+        _exit(1);
+    }
+
+    ByteBuffer encoded;
+    bytebuf_init(&encoded);
+    int width = ring->header->width;
+    int w = d->region.w, h = d->region.h;
+    long frames = 0, skipped = 0, torn = 0;
+    long long bytes = 0;
+    uint64_t last = 0, seq;
+
+    while ((seq = shm_ring_wait(ring, last, -1)) != 0) {
+        if (last > 0) skipped += (long)(seq - last - 1);
+        last = seq;
+
+        const char *cells = shm_ring_cells(shm_ring_slot(ring, seq));
+        for (int y = 0; y < h; y++) {
+            memcpy(d->cur + (size_t)y * w,
+                   cells + (size_t)(d->region.y + y) * width + d->region.x, w);
+        }
+        // Si el productor pisó el slot mientras leíamos, el frame no sirve
+        int valid = shm_ring_still_valid(ring, seq);
+        shm_ring_release(ring, d->id, seq);
+        if (!valid) {
+            torn++;
+            continue;
+        }
+
+        bytebuf_reset(&encoded);
+        if (!d->has_prev || frames % DISPLAY_KEYFRAME_INTERVAL == 0) {
+            encode_full_frame(d->cur, w, h, &encoded);
+        } else {
+            encode_delta_frame(d->prev, d->cur, w, h, &encoded);
+        }
+
+        if (slow) nanosleep(&delay, NULL);  // display lento simulado
+        // Con la barrera, escribir recién cuando el grupo presenta este frame
+        if (sync) present_sync_ready(sync, d->id, seq);
+        if (write_all(out, encoded.data, encoded.len) != 0) break;
+        if (sync) present_sync_presented(sync, d->id, seq);
+        bytes += encoded.len;
+        frames++;
+        swap_region(d);
+    }
+
+    fprintf(stderr, "[DISPLAY %d] región %dx%d en (%d,%d) | %ld frames | %lld bytes | "
+            "%ld saltados | %ld descartados\n",
+            d->id, w, h, d->region.x, d->region.y, frames, bytes, skipped, torn);
+    shm_ring_release(ring, d->id, UINT64_MAX);
+    bytebuf_free(&encoded);
+    close(out);
+    _exit(0);
+}
+
+int display_set_open(DisplaySet *ds, const AnimationConfig *config) {
+    memset(ds, 0, sizeof(*ds));
+    const DisplayLayout *layout = &config->displays;
+    if (layout->rows <= 0 || layout->cols <= 0) return -1;
+
+    /*
+     * Si algo falla a mitad de camino, display_set_close recibe el arreglo
+     * tal como quedó: count solo cuenta displays reservados y los que no
+     * llegaron a abrirse no tienen descriptor ni proceso.
+     */
+    ds->displays = calloc(layout->rows * layout->cols, sizeof(Display));
+    if (ds->displays) ds->count = layout->rows * layout->cols;
+    for (int k = 0; k < ds->count; k++) {
+        ds->displays[k].id = k;
+        ds->displays[k].fd = -1;
+        ds->displays[k].pid = 0;
+    }
+    ds->max_figures = config->num_figures > 0 ? config->num_figures : 1;
+    ds->visible = malloc(sizeof(int) * ds->max_figures);
+    ds->transport = layout->transport;
+    ds->canvas_width = config->canvas.width;
+    ds->canvas_height = config->canvas.height;
+    bytebuf_init(&ds->encoded);
+    if (!ds->displays || !ds->visible) return -1;
+
+    if (ds->transport == DISPLAY_TRANSPORT_SHM) {
+        char name[64];
+        snprintf(name, sizeof(name), "/mda_ring_%d", (int)getpid());
+        if (shm_ring_create(&ds->ring, name, config->canvas.width, config->canvas.height,
+                            SHM_RING_DEFAULT_SLOTS, ds->count) != 0) {
+            return -1;
+        }
+    }
+
+    // El anillo y el protocolo binario llevan solo caracteres
+    if (config->scene->colored && ds->transport != DISPLAY_TRANSPORT_PIPE) {
+        fprintf(stderr, "La escena tiene color y el transporte \"%s\" no lo lleva: los displays "
+                        "la muestran monocroma (el color viaja solo con \"pipe\")\n",
+                ds->transport == DISPLAY_TRANSPORT_SHM ? "shm" : "socket");
+    }
+
+    ds->slow_id = layout->slow_id;
+    ds->slow_delay_ms = layout->slow_delay_ms;
+    if (layout->present_sync) {
+        if (ds->transport != DISPLAY_TRANSPORT_SHM) {
+            fprintf(stderr, "La sincronización de displays requiere \"transport\": \"shm\"\n");
+        } else if (present_sync_init(&ds->sync, ds->count, layout->sync_timeout_ms) == 0) {
+            ds->present_sync = 1;
+        }
+    }
+
+    // Un display que muere no debe matar al renderizador
+    signal(SIGPIPE, SIG_IGN);
+    fflush(stdout);
+
+    for (int r = 0; r < layout->rows; r++) {
+        for (int c = 0; c < layout->cols; c++) {
+            Display *d = &ds->displays[r * layout->cols + c];
+            d->region = display_region(&config->canvas, layout->rows, layout->cols, r, c);
+            size_t size = (size_t)d->region.w * d->region.h;
+            d->prev = malloc(size > 0 ? size : 1);
+            d->cur = malloc(size > 0 ? size : 1);
+            d->cur_attrs = malloc(size > 0 ? size : 1);
+            if (!d->prev || !d->cur || !d->cur_attrs) return -1;
+
+            char sink[300];
+            display_sink_path(layout->sink, d->id, sink, sizeof(sink));
+
+            if (ds->transport == DISPLAY_TRANSPORT_SHM) {
+                pid_t pid = fork();
+                if (pid < 0) {
+                    perror("fork");
+                    return -1;
+                }
+                if (pid == 0) display_shm_main(ds, d, sink);
+                d->pid = pid;
+                continue;
+            }
+
+            int socket_mode = ds->transport == DISPLAY_TRANSPORT_SOCKET;
+            SinkEncoder encoder = socket_mode ? proto_sink_encode : sink_encode_delta;
+            if (socket_mode && strncmp(sink, "unix:", 5) == 0) {
+                int fd = connect_display_server(sink + 5);
+                if (fd < 0) return -1;
+                if (sink_queue_init(&d->queue, fd, d->region.w, d->region.h, config->sink_capacity,
+                                    config->sink_policy, encoder, DISPLAY_KEYFRAME_INTERVAL) != 0) {
+                    close(fd);
+                    return -1;
+                }
+                d->fd = fd;
+                continue;
+            }
+
+            int fds[2];
+            if (socket_mode ? socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 : pipe(fds) != 0) {
+                perror(socket_mode ? "socketpair" : "pipe");
+                return -1;
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                close(fds[0]);
+                close(fds[1]);
+                return -1;
+            }
+            if (pid == 0) {
+                // El hijo no hereda los canales de los displays anteriores
+                for (int k = 0; k < d->id; k++) {
+                    if (ds->displays[k].fd >= 0) close(ds->displays[k].fd);
+                }
+                close(fds[1]);
+                if (socket_mode) display_socket_main(fds[0], d, sink);
+                display_process_main(fds[0], sink);
+            }
+            close(fds[0]);
+            d->pid = pid;
+            if (sink_queue_init(&d->queue, fds[1], d->region.w, d->region.h, config->sink_capacity,
+                                config->sink_policy, encoder, DISPLAY_KEYFRAME_INTERVAL) != 0) {
+                close(fds[1]);  // el hijo ve EOF y termina
+                return -1;
+            }
+            d->fd = fds[1];
+        }
+    }
+    return 0;
+}
+
+int display_set_reserve(DisplaySet *ds, int max_figures) {
+    if (max_figures <= ds->max_figures) return 0;
+    int *visible = realloc(ds->visible, sizeof(int) * max_figures);
+    if (!visible) return -1;
+    ds->visible = visible;
+    ds->max_figures = max_figures;
+    return 0;
+}
+
+// Pinta la región del display con lo que las cámaras ven en ella; retorna las celdas pintadas
+static long render_region(DisplaySet *ds, Display *d, const AnimationConfig *config,
+                          SpatialGrid *grid, const TrajectoryState *traj) {
+    const Scene *scene = config->scene;
+    FrameBuffer fb = {d->cur, d->region.w, d->region.h, d->region.w,
+                      scene->colored ? d->cur_attrs : NULL};
+    memset(d->cur, ' ', (size_t)d->region.w * d->region.h);
+    if (fb.attrs) memset(fb.attrs, 0, (size_t)d->region.w * d->region.h);
+
+    long painted = 0;
+    viewport_paint(config, grid, traj, d->region, &fb, ds->visible, ds->max_figures,
+                   anim_stats_on ? &painted : NULL);
+    return painted;
+}
+
+// Pinta el canvas completo directamente en el próximo slot del anillo
+static void publish_canvas(DisplaySet *ds, const AnimationConfig *config, SpatialGrid *grid,
+                           const TrajectoryState *traj, int t) {
+    int w = config->canvas.width, h = config->canvas.height;
+    char *cells = shm_ring_begin_write(&ds->ring, t, DISPLAY_SHM_TIMEOUT_MS);
+    FrameBuffer fb = {cells, w, h, w, NULL};
+    memset(cells, ' ', (size_t)w * h);
+
+    Rect all = {0, 0, w, h};
+    viewport_paint(config, grid, traj, all, &fb, ds->visible, ds->max_figures, NULL);
+    shm_ring_publish(&ds->ring);
+    ds->frames_published++;
+
+    // Esperar (acotado) a que los displays tengan este frame para presentarlo juntos
+    if (ds->present_sync) present_sync_release(&ds->sync, ds->ring.next_seq - 1);
+}
+
+void display_set_send(DisplaySet *ds, const AnimationConfig *config, SpatialGrid *grid,
+                      const TrajectoryState *traj, int t) {
+    if (ds->transport == DISPLAY_TRANSPORT_SHM) {
+        // Los displays codifican y escriben en su proceso: acá solo se pinta el slot
+        long long start = anim_stats_now();
+        publish_canvas(ds, config, grid, traj, t);
+        if (anim_stats_on) anim_stats_add(STATS_RASTER_NS, anim_stats_now() - start);
+        return;
+    }
+    for (int k = 0; k < ds->count; k++) {
+        Display *d = &ds->displays[k];
+        if (d->fd < 0) continue;
+
+        long long start = anim_stats_now();
+        long painted = render_region(ds, d, config, grid, traj);
+        long long encode_ns = d->queue.encode_ns, write_ns = d->queue.write_ns;
+        long long bytes = d->queue.bytes;
+        unsigned long long sgr = frame_encoder_sgr_bytes;
+        if (anim_stats_on) {
+            anim_stats_add(STATS_RASTER_NS, anim_stats_now() - start);
+            anim_stats_add(STATS_CELLS_PAINTED, painted);
+        }
+
+        // La codificación ocurre al salir de la cola, contra lo último enviado
+        const unsigned char *attrs = config->scene->colored ? d->cur_attrs : NULL;
+        if (sink_queue_push(&d->queue, d->cur, attrs, d->region.w) != 0 ||
+            sink_queue_pump(&d->queue) < 0) {
+            fprintf(stderr, "Display %d desconectado\n", d->id);
+            sink_queue_free(&d->queue);
+            close(d->fd);
+            d->fd = -1;
+            continue;
+        }
+        if (anim_stats_on) {
+            anim_stats_add(STATS_ENCODE_NS, d->queue.encode_ns - encode_ns);
+            anim_stats_add(STATS_WRITE_NS, d->queue.write_ns - write_ns);
+            anim_stats_add(STATS_BYTES, d->queue.bytes - bytes);
+            anim_stats_add(STATS_SGR_BYTES, (long long)(frame_encoder_sgr_bytes - sgr));
+        }
+    }
+}
+
+// Con el anillo, cada display reporta sus propios bytes al terminar
+static void close_shm(DisplaySet *ds, double seconds) {
+    if (ds->present_sync) present_sync_finish(&ds->sync);
+    if (ds->ring.header) shm_ring_finish(&ds->ring);
+    for (int k = 0; k < ds->count; k++) {
+        Display *d = &ds->displays[k];
+        if (d->pid > 0) waitpid(d->pid, NULL, 0);
+        free(d->prev);
+        free(d->cur);
+        free(d->cur_attrs);
+    }
+    fprintf(stderr, "[DISPLAYS] %d displays por memoria compartida | %ld frames publicados",
+            ds->count, ds->frames_published);
+    if (seconds > 0) fprintf(stderr, " (%.1f fps)", ds->frames_published / seconds);
+    fprintf(stderr, " | %ld esperas por displays lentos, %ld slots pisados\n",
+            ds->ring.overwrite_waits, ds->ring.overwrite_timeouts);
+    if (ds->present_sync) {
+        present_sync_report(&ds->sync, stderr);
+        present_sync_free(&ds->sync);
+    }
+    shm_ring_close(&ds->ring);
+}
+
+static void close_pipes(DisplaySet *ds, double seconds) {
+    long long total = 0;
+    long frames = 0;
+    for (int k = 0; k < ds->count; k++) {
+        Display *d = &ds->displays[k];
+        SinkQueue *q = &d->queue;
+        if (d->fd < 0) {
+            // No llegó a abrirse (display_set_open falló antes): sin cola ni reporte
+            if (d->pid > 0) waitpid(d->pid, NULL, 0);
+            free(d->prev);
+            free(d->cur);
+            free(d->cur_attrs);
+            continue;
+        }
+        sink_queue_flush(q, SINK_FLUSH_TIMEOUT_MS);
+        sink_queue_free(q);  // el descriptor vuelve a ser bloqueante
+        if (ds->transport == DISPLAY_TRANSPORT_SOCKET && !q->failed) {
+            bytebuf_reset(&ds->encoded);
+            proto_encode_end((uint32_t)(q->sent_frames + 1), &ds->encoded);
+            write_all(d->fd, ds->encoded.data, ds->encoded.len);
+        }
+        close(d->fd);
+        if (d->pid > 0) waitpid(d->pid, NULL, 0);
+        fprintf(stderr, "[DISPLAY %d] región %dx%d en (%d,%d) | %ld frames | %lld bytes\n",
+                d->id, d->region.w, d->region.h, d->region.x, d->region.y,
+                q->sent_frames, q->bytes);
+        char name[32];
+        snprintf(name, sizeof(name), "display %d", d->id);
+        sink_queue_report(q, name, stderr);
+        total += q->bytes;
+        if (q->sent_frames > frames) frames = q->sent_frames;
+        free(d->prev);
+        free(d->cur);
+        free(d->cur_attrs);
+    }
+    if (seconds > 0) {
+        fprintf(stderr, "[DISPLAYS] %d displays | %lld bytes | %.1f KB/s agregados\n",
+                ds->count, total, total / seconds / 1024.0);
+    }
+    if (frames > 0) {
+        // Lo que manda animator.c repintando el canvas entero cada frame
+        size_t full = full_frame_size(ds->canvas_width, ds->canvas_height);
+        double per_frame = (double)total / frames;
+        fprintf(stderr, "[DISPLAYS] %.1f bytes/frame vs %zu de la repintada completa (%.1fx menos)\n",
+                per_frame, full, per_frame > 0 ? full / per_frame : 0.0);
+    }
+}
+
+void display_set_close(DisplaySet *ds, double seconds) {
+    if (ds->transport == DISPLAY_TRANSPORT_SHM) {
+        close_shm(ds, seconds);
+    } else {
+        close_pipes(ds, seconds);
+    }
+    free(ds->displays);
+    free(ds->visible);
+    bytebuf_free(&ds->encoded);
+    memset(ds, 0, sizeof(*ds));
+}
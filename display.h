@@ -0,0 +1,97 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <sys/types.h>
+#include "anim_config.h"
+#include "frame_encoder.h"
+#include "present_sync.h"
+#include "shm_ring.h"
+#include "sink_queue.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+
+// Cada cuántos frames un display recibe su región completa en vez del delta
+#define DISPLAY_KEYFRAME_INTERVAL 100
+
+/*
+ * Cómo llega el frame a los procesos de display:
+ *   PIPE → el renderizador codifica cada región y la escribe en su pipe.
+ *   SHM  → el renderizador pinta el canvas completo en un slot de un anillo
+ *          en memoria compartida; cada display lee su región ahí mismo y
+ *          la codifica en su propio proceso.
+ *   SOCKET → protocolo binario (display_proto.h) por un socket Unix; el
+ *          display aplica los tramos a su buffer y dibuja localmente. Un
+ *          sink "unix:/ruta" se conecta a un display_server externo.
+ */
+typedef enum {
+    DISPLAY_TRANSPORT_PIPE,
+    DISPLAY_TRANSPORT_SHM,
+    DISPLAY_TRANSPORT_SOCKET
+} DisplayTransport;
+
+// Espera máxima del renderizador por un display atrasado antes de pisar su slot
+#define DISPLAY_SHM_TIMEOUT_MS 100
+
+/*
+ * Un display sirve una región rectangular del canvas desde su propio
+ * proceso. El renderizador le manda solo los bytes de esa región, ya
+ * codificados para una terminal del tamaño de la región.
+ */
+typedef struct {
+    int id;
+    Rect region;
+    pid_t pid;
+    int fd;                  // escritura hacia el proceso del display (-1 = cerrado)
+    char *prev, *cur;        // contenido anterior y actual de la región
+    unsigned char *cur_attrs;  // plano de atributos de cur (solo pipe; socket y anillo son monocromos)
+    int has_prev;
+    SinkQueue queue;         // pipe/socket: frames en espera hacia el display
+} Display;
+
+typedef struct {
+    int count;
+    Display *displays;
+    ByteBuffer encoded;
+    int *visible;            // figuras de la consulta a la rejilla
+    int max_figures;
+    int transport;           // DisplayTransport
+    int canvas_width, canvas_height;
+    ShmRing ring;            // solo con DISPLAY_TRANSPORT_SHM
+    long frames_published;
+    int present_sync;        // barrera de presentación entre displays (con el anillo)
+    PresentSync sync;
+    int slow_id, slow_delay_ms;
+} DisplaySet;
+
+// Región del display (r, c) en una rejilla rows x cols sobre el canvas
+Rect display_region(const Canvas *canvas, int rows, int cols, int r, int c);
+
+// "pipe" (por defecto), "shm" o "socket"
+DisplayTransport display_transport_from_string(const char *name);
+
+// Sustituye el primer "%d" del patrón por id
+void display_sink_path(const char *pattern, int id, char *out, size_t size);
+
+/*
+ * Lanza un proceso por región de config->displays. Cada proceso copia lo
+ * que recibe a su destino (archivo, pty o terminal). Retorna 0 o -1.
+ */
+int display_set_open(DisplaySet *ds, const AnimationConfig *config);
+
+// Agranda la lista de figuras visibles si la escena creció. Retorna 0 o -1.
+int display_set_reserve(DisplaySet *ds, int max_figures);
+
+/*
+ * Rasteriza la región de cada display con las figuras que la rejilla
+ * reporta dentro de ella (las que cruzan un borde quedan recortadas en
+ * cada lado) y lo encola hacia él: un display lento acumula o pierde
+ * frames según la política de su cola, sin frenar a los demás. Con el anillo compartido se
+ * pinta el canvas una sola vez en el slot y se publica.
+ */
+void display_set_send(DisplaySet *ds, const AnimationConfig *config, SpatialGrid *grid,
+                      const TrajectoryState *traj, int t);
+
+// Cierra los canales, espera a los procesos y reporta bytes por display
+void display_set_close(DisplaySet *ds, double seconds);
+
+#endif // DISPLAY_H
@@ -0,0 +1,328 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "display_proto.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum { OP_SKIP = 0, OP_RUN = 1, OP_LITERAL = 2 };
+
+// Payload máximo aceptado al leer (un canvas enorme como literales)
+#define PROTO_MAX_PAYLOAD (64u * 1024 * 1024)
+
+static void store_u16(char *p, uint32_t v) {
+    p[0] = (char)(v & 0xff);
+    p[1] = (char)((v >> 8) & 0xff);
+}
+
+static void store_u32(char *p, uint32_t v) {
+    for (int k = 0; k < 4; k++) p[k] = (char)((v >> (8 * k)) & 0xff);
+}
+
+static uint32_t load_u16(const char *p) {
+    const unsigned char *u = (const unsigned char *)p;
+    return u[0] | (uint32_t)u[1] << 8;
+}
+
+static uint32_t load_u32(const char *p) {
+    const unsigned char *u = (const unsigned char *)p;
+    return u[0] | (uint32_t)u[1] << 8 | (uint32_t)u[2] << 16 | (uint32_t)u[3] << 24;
+}
+
+static int put_byte(ByteBuffer *out, int c) {
+    char b = (char)c;
+    return bytebuf_append(out, &b, 1);
+}
+
+static int put_command(ByteBuffer *out, int op, size_t n) {
+    if (n < 64) return put_byte(out, op << 6 | (int)n);
+    if (put_byte(out, op << 6) != 0) return -1;
+    // varint LEB128
+    while (n >= 0x80) {
+        if (put_byte(out, (int)(n & 0x7f) | 0x80) != 0) return -1;
+        n >>= 7;
+    }
+    return put_byte(out, (int)n);
+}
+
+// Tramo de celdas nuevas: RUN para repeticiones largas, LITERAL para el resto
+static int encode_cells(ByteBuffer *out, const char *cells, size_t n) {
+    size_t lit = 0, i = 0;
+    while (i < n) {
+        size_t r = 1;
+        while (i + r < n && cells[i + r] == cells[i]) r++;
+        if (r < PROTO_MIN_RUN) {
+            i += r;
+            continue;
+        }
+        if (i > lit) {
+            if (put_command(out, OP_LITERAL, i - lit) != 0 ||
+                bytebuf_append(out, cells + lit, i - lit) != 0) return -1;
+        }
+        if (put_command(out, OP_RUN, r) != 0 || put_byte(out, cells[i]) != 0) return -1;
+        i += r;
+        lit = i;
+    }
+    if (n > lit) {
+        if (put_command(out, OP_LITERAL, n - lit) != 0 ||
+            bytebuf_append(out, cells + lit, n - lit) != 0) return -1;
+    }
+    return 0;
+}
+
+// Celda de referencia: el frame anterior, o blanco para un keyframe
+#define BASE(prev, i) ((prev) ? (prev)[i] : ' ')
+
+static int encode_changes(const char *prev, const char *cur, size_t n, ByteBuffer *out) {
+    size_t cursor = 0, i = 0;
+    while (i < n) {
+        if (cur[i] == BASE(prev, i)) {
+            i++;
+            continue;
+        }
+        // Extender el tramo mientras los huecos sin cambios sean cortos
+        size_t end = i + 1;
+        for (size_t j = end; j < n && j - end <= PROTO_MERGE_GAP; j++) {
+            if (cur[j] != BASE(prev, j)) end = j + 1;
+        }
+        if (i > cursor && put_command(out, OP_SKIP, i - cursor) != 0) return -1;
+        if (encode_cells(out, cur + i, end - i) != 0) return -1;
+        cursor = i = end;
+    }
+    return 0;
+}
+
+static int begin_message(ByteBuffer *out, int type, uint32_t seq, size_t *start) {
+    *start = out->len;
+    if (bytebuf_reserve(out, PROTO_HEADER_SIZE) != 0) return -1;
+    char *h = out->data + out->len;
+    h[0] = 'M';
+    h[1] = 'P';
+    h[2] = PROTO_VERSION;
+    h[3] = (char)type;
+    store_u32(h + 4, seq);
+    store_u32(h + 8, 0);
+    out->len += PROTO_HEADER_SIZE;
+    return 0;
+}
+
+static void end_message(ByteBuffer *out, size_t start) {
+    store_u32(out->data + start + 8, (uint32_t)(out->len - start - PROTO_HEADER_SIZE));
+}
+
+int proto_encode_frame(const char *prev, const char *cur, int width, int height,
+                       uint32_t seq, ByteBuffer *out) {
+    size_t start;
+    if (begin_message(out, prev ? PROTO_DELTA : PROTO_KEYFRAME, seq, &start) != 0) return -1;
+    if (!prev) {
+        char size[4];
+        store_u16(size, width);
+        store_u16(size + 2, height);
+        if (bytebuf_append(out, size, sizeof(size)) != 0) return -1;
+    }
+    if (encode_changes(prev, cur, (size_t)width * height, out) != 0) return -1;
+    end_message(out, start);
+    return 0;
+}
+
+int proto_encode_end(uint32_t seq, ByteBuffer *out) {
+    size_t start;
+    if (begin_message(out, PROTO_END, seq, &start) != 0) return -1;
+    end_message(out, start);
+    return 0;
+}
+
+void proto_decoder_init(ProtoDecoder *d) {
+    memset(d, 0, sizeof(*d));
+}
+
+void proto_decoder_free(ProtoDecoder *d) {
+    free(d->cells);
+    memset(d, 0, sizeof(*d));
+}
+
+static int read_count(const char **p, const char *end, size_t *n) {
+    size_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*p >= end) return -1;
+        unsigned char b = (unsigned char)*(*p)++;
+        v |= (size_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *n = v;
+            return v > 0 ? 0 : -1;
+        }
+    }
+    return -1;
+}
+
+// Aplica la lista de tramos sobre el buffer del display, verificando límites
+static int apply_spans(ProtoDecoder *d, const char *p, const char *end) {
+    size_t pos = 0, cells = (size_t)d->width * d->height;
+    while (p < end) {
+        unsigned char cmd = (unsigned char)*p++;
+        size_t n = cmd & 0x3f;
+        if (n == 0 && read_count(&p, end, &n) != 0) return -1;
+        if (n > cells - pos) return -1;
+        switch (cmd >> 6) {
+        case OP_SKIP:
+            break;
+        case OP_RUN:
+            if (p >= end) return -1;
+            memset(d->cells + pos, *p++, n);
+            break;
+        case OP_LITERAL:
+            if ((size_t)(end - p) < n) return -1;
+            memcpy(d->cells + pos, p, n);
+            p += n;
+            break;
+        default:
+            return -1;
+        }
+        pos += n;
+    }
+    return 0;
+}
+
+int proto_decode(ProtoDecoder *d, const char *msg, size_t len) {
+    if (len < PROTO_HEADER_SIZE || msg[0] != 'M' || msg[1] != 'P' || msg[2] != PROTO_VERSION ||
+        load_u32(msg + 8) != len - PROTO_HEADER_SIZE) {
+        return -1;
+    }
+    int type = msg[3];
+    uint32_t seq = load_u32(msg + 4);
+    const char *p = msg + PROTO_HEADER_SIZE, *end = msg + len;
+
+    switch (type) {
+    case PROTO_KEYFRAME: {
+        if (end - p < 4) return -1;
+        int width = (int)load_u16(p), height = (int)load_u16(p + 2);
+        p += 4;
+        size_t size = (size_t)width * height;
+        if (width != d->width || height != d->height || !d->cells) {
+            char *cells = realloc(d->cells, size > 0 ? size : 1);
+            if (!cells) return -1;
+            d->cells = cells;
+            d->width = width;
+            d->height = height;
+        }
+        memset(d->cells, ' ', size);
+        d->synced = 0;
+        if (apply_spans(d, p, end) != 0) return -1;
+        d->synced = 1;
+        d->seq = seq;
+        d->keyframes++;
+        return 1;
+    }
+    case PROTO_DELTA:
+        // Un delta solo vale sobre el frame anterior exacto
+        if (!d->synced || seq != d->seq + 1) {
+            d->synced = 0;
+            d->rejected++;
+            return 0;
+        }
+        if (apply_spans(d, p, end) != 0) {
+            d->synced = 0;
+            return -1;
+        }
+        d->seq = seq;
+        d->deltas++;
+        return 1;
+    case PROTO_END:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+static int read_full(int fd, char *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, buf + got, len - got);
+        if (n == 0) return got == 0 ? 0 : -1;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        got += n;
+    }
+    return 1;
+}
+
+int proto_read_message(int fd, ByteBuffer *msg) {
+    bytebuf_reset(msg);
+    if (bytebuf_reserve(msg, PROTO_HEADER_SIZE) != 0) return -1;
+    int r = read_full(fd, msg->data, PROTO_HEADER_SIZE);
+    if (r <= 0) return r;
+    uint32_t length = load_u32(msg->data + 8);
+    if (length > PROTO_MAX_PAYLOAD) return -1;
+    msg->len = PROTO_HEADER_SIZE;
+    if (bytebuf_reserve(msg, length) != 0) return -1;
+    if (length > 0 && read_full(fd, msg->data + PROTO_HEADER_SIZE, length) != 1) return -1;
+    msg->len += length;
+    return 1;
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int proto_serve(int in_fd, int out_fd, ProtoServeStats *stats) {
+    ProtoDecoder d;
+    proto_decoder_init(&d);
+    ByteBuffer msg, ansi;
+    bytebuf_init(&msg);
+    bytebuf_init(&ansi);
+    memset(stats, 0, sizeof(*stats));
+
+    char *shown = NULL;      // último frame dibujado en el destino
+    int shown_w = 0, shown_h = 0;
+    int status = 0, r;
+    while ((r = proto_read_message(in_fd, &msg)) == 1) {
+        stats->messages++;
+        stats->wire_bytes += msg.len;
+        int applied = proto_decode(&d, msg.data, msg.len);
+        if (applied < 0) {
+            status = -1;
+            break;
+        }
+        if (msg.data[3] == PROTO_END) break;
+        if (applied == 0) continue;
+
+        size_t size = (size_t)d.width * d.height;
+        bytebuf_reset(&ansi);
+        if (!shown || shown_w != d.width || shown_h != d.height) {
+            free(shown);
+            shown = malloc(size > 0 ? size : 1);
+            if (!shown) {
+                status = -1;
+                break;
+            }
+            shown_w = d.width;
+            shown_h = d.height;
+            encode_full_frame(d.cells, d.width, d.height, &ansi);
+        } else {
+            encode_delta_frame(shown, d.cells, d.width, d.height, &ansi);
+        }
+        memcpy(shown, d.cells, size);
+        if (write_all(out_fd, ansi.data, ansi.len) != 0) break;
+        stats->output_bytes += ansi.len;
+        stats->frames++;
+    }
+    if (r < 0) status = -1;
+
+    free(shown);
+    bytebuf_free(&msg);
+    bytebuf_free(&ansi);
+    proto_decoder_free(&d);
+    return status;
+}
@@ -0,0 +1,86 @@
+#ifndef DISPLAY_PROTO_H
+#define DISPLAY_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_encoder.h"
+
+/*
+ * Protocolo binario hacia displays que no comparten memoria con el
+ * renderizador (sockets Unix). Cada mensaje lleva un encabezado fijo:
+ *
+ *   'M' 'P' versión tipo | seq (u32 LE) | largo del payload (u32 LE)
+ *
+ * El payload de KEYFRAME empieza con ancho y alto (u16 LE) y describe el
+ * frame completo como cambios sobre un buffer en blanco; el de DELTA,
+ * los cambios respecto del frame seq - 1. Ambos son una lista de tramos
+ * sobre las celdas en orden de filas, cada uno con un byte de comando:
+ *
+ *   op (2 bits) | n (6 bits, 0 = n en varint a continuación)
+ *   SKIP n      → avanzar n celdas sin cambios
+ *   RUN n c     → n copias del byte c
+ *   LITERAL n … → n bytes tal cual
+ */
+#define PROTO_VERSION     1
+#define PROTO_HEADER_SIZE 12
+
+enum {
+    PROTO_KEYFRAME = 1,
+    PROTO_DELTA = 2,
+    PROTO_END = 3
+};
+
+// Celdas iguales que se reenvían en vez de cortar el tramo (un SKIP cuesta 1-2 bytes)
+#define PROTO_MERGE_GAP 2
+
+// Repeticiones a partir de las cuales conviene RUN en vez de LITERAL
+#define PROTO_MIN_RUN 3
+
+/*
+ * Agrega a out el mensaje del frame seq: KEYFRAME si prev es NULL, si no
+ * DELTA respecto de prev. Retorna 0 o -1.
+ */
+int proto_encode_frame(const char *prev, const char *cur, int width, int height,
+                       uint32_t seq, ByteBuffer *out);
+
+// Mensaje de fin de la animación
+int proto_encode_end(uint32_t seq, ByteBuffer *out);
+
+// Estado del lado del display: su propia copia del frame
+typedef struct {
+    char *cells;
+    int width, height;
+    uint32_t seq;
+    int synced;              // 0 hasta recibir un keyframe (o tras un seq salteado)
+    long keyframes, deltas, rejected;
+} ProtoDecoder;
+
+void proto_decoder_init(ProtoDecoder *d);
+void proto_decoder_free(ProtoDecoder *d);
+
+/*
+ * Aplica un mensaje completo (encabezado + payload) al buffer del
+ * display. Retorna 1 si el buffer quedó con un frame nuevo, 0 si no
+ * cambió (fin, o delta descartado hasta el próximo keyframe) y -1 si el
+ * mensaje está mal formado.
+ */
+int proto_decode(ProtoDecoder *d, const char *msg, size_t len);
+
+// Lee un mensaje del descriptor en msg. Retorna 1, 0 en fin de stream o -1.
+int proto_read_message(int fd, ByteBuffer *msg);
+
+typedef struct {
+    long messages, frames;
+    long long wire_bytes;     // bytes del protocolo recibidos
+    long long output_bytes;   // ANSI escrito al destino
+} ProtoServeStats;
+
+/*
+ * Servidor de display: aplica los mensajes que llegan por in_fd y
+ * dibuja localmente en out_fd (ANSI, solo lo que cambió respecto del
+ * último frame dibujado) hasta PROTO_END o el cierre del stream.
+ * Retorna 0 o -1 si llegó un mensaje inválido.
+ */
+int proto_serve(int in_fd, int out_fd, ProtoServeStats *stats);
+
+#endif // DISPLAY_PROTO_H
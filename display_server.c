@@ -0,0 +1,81 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "display_proto.h"
+#include "frame_encoder.h"
+
+/*
+ * Display de prueba para el transporte "socket": escucha en un socket
+ * Unix, aplica el protocolo binario de cada conexión a su propio buffer
+ * y dibuja en el destino. Atiende una conexión por vez.
+ * Uso: display_server <socket> [destino] [conexiones]
+ *   (configurar el animador con "sink": "unix:<socket>")
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <socket> [destino] [conexiones]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    const char *sink = argc > 2 ? argv[2] : "/dev/stdout";
+    int connections = argc > 3 ? atoi(argv[3]) : 1;
+
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Ruta de socket demasiado larga: %s\n", path);
+        return 1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0) {
+        perror(path);
+        close(listener);
+        return 1;
+    }
+
+    int out = open(sink, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        perror(sink);
+        close(listener);
+        unlink(path);
+        return 1;
+    }
+
+    int status = 0;
+    for (int k = 0; k < connections; k++) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            perror("accept");
+            status = 1;
+            break;
+        }
+        ProtoServeStats stats;
+        if (proto_serve(fd, out, &stats) != 0) {
+            fprintf(stderr, "Mensaje inválido en la conexión %d\n", k);
+            status = 1;
+        }
+        close(fd);
+        fprintf(stderr, "[DISPLAY SERVER] %ld mensajes | %ld frames | %lld bytes recibidos "
+                "(%.1f por frame) | %lld bytes dibujados\n",
+                stats.messages, stats.frames, stats.wire_bytes,
+                stats.frames ? (double)stats.wire_bytes / stats.frames : 0.0, stats.output_bytes);
+    }
+
+    close(out);
+    close(listener);
+    unlink(path);
+    return status;
+}
@@ -0,0 +1,215 @@
+#include "frame_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ====================== PackBits ====================== */
+/*
+ * Byte de control n con signo: 0..127 → siguen n + 1 bytes literales;
+ * -127..-1 → el siguiente byte se repite 1 - n veces.
+ */
+static int packbits_compress(const char *in, size_t n, ByteBuffer *out) {
+    if (bytebuf_reserve(out, n + n / 128 + 1) != 0) return -1;
+    char *p = out->data + out->len;
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 128 && in[i + run] == in[i]) run++;
+        if (run >= 3) {
+            *p++ = (char)(signed char)(1 - (int)run);
+            *p++ = in[i];
+            i += run;
+            continue;
+        }
+
+        // Literales hasta que empiece una repetición de 3 o más
+        size_t start = i, len = 0;
+        while (i < n && len < 128) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            i++;
+            len++;
+        }
+        *p++ = (char)(signed char)(len - 1);
+        memcpy(p, in + start, len);
+        p += len;
+    }
+    out->len = p - out->data;
+    return 0;
+}
+
+static int packbits_expand(const char *in, size_t n, size_t raw_len, ByteBuffer *out) {
+    if (bytebuf_reserve(out, raw_len) != 0) return -1;
+    char *p = out->data + out->len;
+    size_t i = 0;
+    while (i < n) {
+        int ctrl = (signed char)in[i++];
+        if (ctrl >= 0) {
+            memcpy(p, in + i, ctrl + 1);
+            p += ctrl + 1;
+            i += ctrl + 1;
+        } else if (ctrl != -128) {
+            memset(p, in[i++], 1 - ctrl);
+            p += 1 - ctrl;
+        }
+    }
+    out->len = p - out->data;
+    return 0;
+}
+
+/* ====================== Tabla hash + LRU ====================== */
+static unsigned bucket_of(const FrameCache *c, unsigned long long config_hash, int frame) {
+    unsigned long long h = config_hash ^ ((unsigned long long)(unsigned)frame * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 29;
+    return (unsigned)h & (c->num_buckets - 1);
+}
+
+int frame_cache_init(FrameCache *c, long budget_bytes, int compress) {
+    memset(c, 0, sizeof(*c));
+    c->budget = budget_bytes > 0 ? (size_t)budget_bytes : FRAME_CACHE_DEFAULT_BUDGET;
+    c->compress = compress;
+    c->num_buckets = 256;
+    c->buckets = calloc(c->num_buckets, sizeof(FrameCacheEntry *));
+    return c->buckets ? 0 : -1;
+}
+
+static void lru_unlink(FrameCache *c, FrameCacheEntry *e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else c->lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else c->lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void lru_push_front(FrameCache *c, FrameCacheEntry *e) {
+    e->lru_prev = NULL;
+    e->lru_next = c->lru_head;
+    if (c->lru_head) c->lru_head->lru_prev = e;
+    c->lru_head = e;
+    if (!c->lru_tail) c->lru_tail = e;
+}
+
+static size_t entry_cost(const FrameCacheEntry *e) {
+    return sizeof(FrameCacheEntry) + e->stored_len;
+}
+
+static void remove_entry(FrameCache *c, FrameCacheEntry *e) {
+    FrameCacheEntry **pp = &c->buckets[bucket_of(c, e->config_hash, e->frame)];
+    while (*pp != e) pp = &(*pp)->hash_next;
+    *pp = e->hash_next;
+    lru_unlink(c, e);
+    c->used -= entry_cost(e);
+    c->raw_bytes -= e->raw_len;
+    c->num_entries--;
+    free(e->data);
+    free(e);
+}
+
+static FrameCacheEntry *find_entry(const FrameCache *c, unsigned long long config_hash, int frame) {
+    FrameCacheEntry *e = c->buckets[bucket_of(c, config_hash, frame)];
+    while (e && (e->config_hash != config_hash || e->frame != frame)) e = e->hash_next;
+    return e;
+}
+
+static void grow_buckets(FrameCache *c) {
+    int old_n = c->num_buckets;
+    FrameCacheEntry **old = c->buckets;
+    FrameCacheEntry **buckets = calloc(old_n * 2, sizeof(FrameCacheEntry *));
+    if (!buckets) return;  // seguir con cadenas más largas
+    c->buckets = buckets;
+    c->num_buckets = old_n * 2;
+    for (int b = 0; b < old_n; b++) {
+        FrameCacheEntry *e = old[b];
+        while (e) {
+            FrameCacheEntry *next = e->hash_next;
+            unsigned nb = bucket_of(c, e->config_hash, e->frame);
+            e->hash_next = c->buckets[nb];
+            c->buckets[nb] = e;
+            e = next;
+        }
+    }
+    free(old);
+}
+
+void frame_cache_free(FrameCache *c) {
+    while (c->lru_head) remove_entry(c, c->lru_head);
+    free(c->buckets);
+    memset(c, 0, sizeof(*c));
+}
+
+int frame_cache_get(FrameCache *c, unsigned long long config_hash, int frame, ByteBuffer *out) {
+    FrameCacheEntry *e = find_entry(c, config_hash, frame);
+    if (!e) {
+        c->misses++;
+        return 0;
+    }
+
+    int ok = e->compressed ? packbits_expand(e->data, e->stored_len, e->raw_len, out)
+                           : bytebuf_append(out, e->data, e->stored_len);
+    if (ok != 0) {
+        c->misses++;
+        return 0;
+    }
+    lru_unlink(c, e);
+    lru_push_front(c, e);
+    c->hits++;
+    return 1;
+}
+
+void frame_cache_put(FrameCache *c, unsigned long long config_hash, int frame,
+                     const char *data, size_t len) {
+    FrameCacheEntry *old = find_entry(c, config_hash, frame);
+    if (old) remove_entry(c, old);
+
+    FrameCacheEntry *e = calloc(1, sizeof(FrameCacheEntry));
+    if (!e) return;
+    e->config_hash = config_hash;
+    e->frame = frame;
+    e->raw_len = len;
+
+    ByteBuffer packed;
+    bytebuf_init(&packed);
+    if (c->compress && packbits_compress(data, len, &packed) == 0 && packed.len < len) {
+        e->data = packed.data;          // el entry se queda con el buffer
+        e->stored_len = packed.len;
+        e->compressed = 1;
+    } else {
+        bytebuf_free(&packed);
+        e->data = malloc(len > 0 ? len : 1);
+        if (!e->data) {
+            free(e);
+            return;
+        }
+        memcpy(e->data, data, len);
+        e->stored_len = len;
+    }
+
+    // Un frame más grande que todo el presupuesto no se guarda
+    if (entry_cost(e) > c->budget) {
+        free(e->data);
+        free(e);
+        return;
+    }
+    while (c->used + entry_cost(e) > c->budget && c->lru_tail) {
+        remove_entry(c, c->lru_tail);
+        c->evictions++;
+    }
+
+    if (c->num_entries >= c->num_buckets) grow_buckets(c);
+    unsigned b = bucket_of(c, config_hash, frame);
+    e->hash_next = c->buckets[b];
+    c->buckets[b] = e;
+    lru_push_front(c, e);
+    c->used += entry_cost(e);
+    c->raw_bytes += len;
+    c->num_entries++;
+    c->insertions++;
+}
+
+void frame_cache_report(const FrameCache *c, FILE *out) {
+    long lookups = c->hits + c->misses;
+    fprintf(out, "[FRAME CACHE] aciertos %ld | fallos %ld (%.1f%% acierto) | desalojos %ld | inserciones %ld\n",
+            c->hits, c->misses, lookups ? 100.0 * c->hits / lookups : 0.0,
+            c->evictions, c->insertions);
+    fprintf(out, "[FRAME CACHE] %d frames | %zu / %zu bytes usados | %zu bytes sin comprimir%s\n",
+            c->num_entries, c->used, c->budget, c->raw_bytes,
+            c->compress ? " (PackBits)" : "");
+}
@@ -0,0 +1,55 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stdio.h>
+#include "frame_encoder.h"
+
+#define FRAME_CACHE_DEFAULT_BUDGET (8L * 1024 * 1024)
+
+// Sin "frame_cache" en la configuración: el presupuesto por defecto solo si hay repeticiones
+#define FRAME_CACHE_AUTO (-1L)
+
+typedef struct FrameCacheEntry {
+    unsigned long long config_hash;
+    int frame;
+    char *data;                       // bytes guardados (comprimidos o no)
+    size_t stored_len;                // bytes en data
+    size_t raw_len;                   // bytes del frame codificado original
+    int compressed;
+    struct FrameCacheEntry *hash_next;
+    struct FrameCacheEntry *lru_prev, *lru_next;
+} FrameCacheEntry;
+
+/*
+ * Caché LRU de frames ya codificados, con presupuesto en bytes. La clave
+ * es (hash de la configuración, número de frame). Si compress está
+ * activo, los frames se guardan con PackBits y se expanden al leerlos.
+ */
+typedef struct {
+    size_t budget, used;
+    int compress;
+
+    FrameCacheEntry **buckets;
+    int num_buckets;                  // potencia de 2
+    int num_entries;
+    FrameCacheEntry *lru_head;        // el más reciente
+    FrameCacheEntry *lru_tail;        // el próximo a desalojar
+
+    long hits, misses, evictions, insertions;
+    size_t raw_bytes;                 // bytes sin comprimir de lo que hay en caché
+} FrameCache;
+
+// budget_bytes <= 0 usa FRAME_CACHE_DEFAULT_BUDGET. Retorna 0 o -1.
+int frame_cache_init(FrameCache *c, long budget_bytes, int compress);
+void frame_cache_free(FrameCache *c);
+
+// Si el frame está en caché lo agrega a out y retorna 1; si no, retorna 0
+int frame_cache_get(FrameCache *c, unsigned long long config_hash, int frame, ByteBuffer *out);
+
+// Guarda una copia del frame codificado, desalojando los menos usados
+void frame_cache_put(FrameCache *c, unsigned long long config_hash, int frame,
+                     const char *data, size_t len);
+
+void frame_cache_report(const FrameCache *c, FILE *out);
+
+#endif // FRAME_CACHE_H
@@ -0,0 +1,159 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "frame_clock.h"
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#define NS_PER_SEC 1000000000LL
+
+static long long ts_to_ns(const struct timespec *ts) {
+    return (long long)ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+static struct timespec ns_to_ts(long long ns) {
+    struct timespec ts;
+    ts.tv_sec = ns / NS_PER_SEC;
+    ts.tv_nsec = ns % NS_PER_SEC;
+    return ts;
+}
+
+long long frame_clock_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ts_to_ns(&now);
+}
+
+// Casilla del histograma para d ns: 4 por octava según los 2 bits tras el más alto
+static int hist_bucket(long long d) {
+    if (d < 4) return 0;
+    int msb = 0;
+    while ((d >> (msb + 1)) != 0) msb++;
+    int b = msb * 4 + (int)((d >> (msb - 2)) & 3);
+    return b < FRAME_CLOCK_HIST_BUCKETS ? b : FRAME_CLOCK_HIST_BUCKETS - 1;
+}
+
+// Centro geométrico de la casilla b en ns
+static double hist_value(int b) {
+    int msb = b / 4;
+    double lo = ldexp(1.0 + (b % 4) / 4.0, msb);
+    double hi = ldexp(1.0 + (b % 4 + 1) / 4.0, msb);
+    return sqrt(lo * hi);
+}
+
+void frame_clock_init_at(FrameClock *c, int fps, FramePolicy policy, long long epoch_ns) {
+    memset(c, 0, sizeof(*c));
+    c->epoch_ns = epoch_ns;
+    c->ready_ns = epoch_ns;
+    c->period_ns = fps > 0 ? NS_PER_SEC / fps : 0;
+    c->policy = policy;
+    c->frame = 0;
+    c->frames = 1;           // el frame 0 se presenta al arrancar
+}
+
+void frame_clock_init(FrameClock *c, int fps, FramePolicy policy) {
+    frame_clock_init_at(c, fps, policy, frame_clock_now_ns());
+}
+
+int frame_clock_wait_for(FrameClock *c, int frame) {
+    long long now = frame_clock_now_ns();
+    c->frame_time_hist[hist_bucket(now - c->ready_ns)]++;
+
+    if (c->period_ns == 0) {
+        c->ready_ns = now;
+        c->frame = frame;
+        c->frames++;
+        return frame;
+    }
+
+    long long epoch = c->epoch_ns;
+    long long deadline = epoch + (long long)frame * c->period_ns;
+
+    if (now >= deadline) {
+        c->missed++;
+        if (c->policy == FRAME_POLICY_DROP) {
+            // Último frame cuyo deadline ya venció
+            int due = (int)((now - epoch) / c->period_ns);
+            if (due > frame) {
+                c->dropped += due - frame;
+                frame = due;
+                deadline = epoch + (long long)frame * c->period_ns;
+            }
+        }
+    } else {
+        // Deadline absoluto: reintentar si una señal (p. ej. SIGALRM) interrumpe
+        struct timespec ts = ns_to_ts(deadline);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+        now = frame_clock_now_ns();
+    }
+
+    long long jitter = now - deadline;
+    if (jitter < 0) jitter = -jitter;
+    c->jitter_sum_ns += jitter;
+    c->jitter_sq_sum += (jitter / 1000) * (jitter / 1000);
+    if (jitter > c->jitter_max_ns) c->jitter_max_ns = jitter;
+
+    c->ready_ns = now;
+    c->frame = frame;
+    c->frames++;
+    return frame;
+}
+
+int frame_clock_next(FrameClock *c) {
+    return frame_clock_wait_for(c, c->frame + 1);
+}
+
+void frame_clock_merge(FrameClock *dst, const FrameClock *src) {
+    dst->frames += src->frames;
+    dst->missed += src->missed;
+    dst->dropped += src->dropped;
+    dst->jitter_sum_ns += src->jitter_sum_ns;
+    dst->jitter_sq_sum += src->jitter_sq_sum;
+    if (src->jitter_max_ns > dst->jitter_max_ns) dst->jitter_max_ns = src->jitter_max_ns;
+    if (src->period_ns) dst->period_ns = src->period_ns;
+    if (src->ready_ns > dst->ready_ns) dst->ready_ns = src->ready_ns;
+    for (int b = 0; b < FRAME_CLOCK_HIST_BUCKETS; b++) {
+        dst->frame_time_hist[b] += src->frame_time_hist[b];
+    }
+}
+
+double frame_clock_percentile_us(const FrameClock *c, double p) {
+    long total = 0;
+    for (int b = 0; b < FRAME_CLOCK_HIST_BUCKETS; b++) total += c->frame_time_hist[b];
+    if (total == 0) return 0.0;
+
+    long rank = (long)(p / 100.0 * (total - 1));
+    long seen = 0;
+    for (int b = 0; b < FRAME_CLOCK_HIST_BUCKETS; b++) {
+        seen += c->frame_time_hist[b];
+        if (seen > rank) return hist_value(b) / 1000.0;
+    }
+    return hist_value(FRAME_CLOCK_HIST_BUCKETS - 1) / 1000.0;
+}
+
+double frame_clock_elapsed(const FrameClock *c) {
+    return (c->ready_ns - c->epoch_ns) / (double)NS_PER_SEC;
+}
+
+void frame_clock_report(const FrameClock *c, FILE *out) {
+    // El frame 0 no tiene deadline previo: no entra en el jitter
+    long waited = c->frames > 1 ? c->frames - 1 : 1;
+    double mean_us = c->jitter_sum_ns / 1000.0 / waited;
+    double var = (double)c->jitter_sq_sum / waited - mean_us * mean_us;
+    double fps = c->period_ns ? (double)NS_PER_SEC / c->period_ns : 0.0;
+
+    fprintf(out, "[FRAME CLOCK] objetivo %.1f fps | frames %ld | deadlines perdidos %ld | saltados %ld\n",
+            fps, c->frames, c->missed, c->dropped);
+    fprintf(out, "[FRAME CLOCK] jitter medio %.1f us | desviación %.1f us | máximo %.1f us\n",
+            mean_us, var > 0 ? sqrt(var) : 0.0, c->jitter_max_ns / 1000.0);
+    fprintf(out, "[FRAME CLOCK] tiempo de frame p50 %.1f us | p99 %.1f us | %.3f s hasta el último frame\n",
+            frame_clock_percentile_us(c, 50), frame_clock_percentile_us(c, 99),
+            frame_clock_elapsed(c));
+}
+
+FramePolicy frame_policy_from_string(const char *name) {
+    if (name && strcmp(name, "catch_up") == 0) return FRAME_POLICY_CATCH_UP;
+    return FRAME_POLICY_DROP;
+}
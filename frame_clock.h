@@ -0,0 +1,77 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <stdio.h>
+
+#define FRAME_CLOCK_DEFAULT_FPS 10
+
+// Histograma del tiempo de frame: 4 casillas por potencia de 2 de ns (~19 % de ancho)
+#define FRAME_CLOCK_HIST_BUCKETS 128
+
+// Qué hacer cuando el renderizador va atrasado respecto a los deadlines
+typedef enum {
+    FRAME_POLICY_DROP,       // saltar al último frame vencido (el tiempo de la animación sigue al reloj)
+    FRAME_POLICY_CATCH_UP    // presentar todos los frames, sin dormir, hasta ponerse al día
+} FramePolicy;
+
+/*
+ * Reloj de frames con deadlines absolutos sobre CLOCK_MONOTONIC:
+ * el frame n se presenta en epoch + n * period, así que el tiempo de
+ * render e impresión no se acumula como deriva. fps <= 0 = sin límite.
+ */
+typedef struct {
+    long long epoch_ns;      // CLOCK_MONOTONIC al arrancar
+    long long period_ns;
+    FramePolicy policy;
+    int frame;               // último frame entregado
+
+    // Estadísticas
+    long frames;             // frames presentados
+    long missed;             // deadlines que ya habían pasado al llegar
+    long dropped;            // frames saltados por la política DROP
+    long long jitter_sum_ns; // |hora real de presentación - deadline|
+    long long jitter_sq_sum; // suma de cuadrados en µs², para la desviación
+    long long jitter_max_ns;
+
+    // Tiempo de frame: desde que se presentó el anterior hasta pedir el siguiente
+    long long ready_ns;      // cuándo se presentó el último frame
+    int frame_time_hist[FRAME_CLOCK_HIST_BUCKETS];
+} FrameClock;
+
+// Arranca el reloj ahora; el frame 0 vence de inmediato
+void frame_clock_init(FrameClock *c, int fps, FramePolicy policy);
+
+// Igual, pero con un epoch compartido (varios hilos con el mismo calendario)
+void frame_clock_init_at(FrameClock *c, int fps, FramePolicy policy, long long epoch_ns);
+
+/*
+ * Duerme hasta el deadline del siguiente frame y retorna su número.
+ * Si ese deadline ya pasó, con FRAME_POLICY_DROP retorna el último
+ * frame vencido (saltando los intermedios) sin dormir.
+ */
+int frame_clock_next(FrameClock *c);
+
+// Igual que frame_clock_next, pero apuntando al frame indicado
+int frame_clock_wait_for(FrameClock *c, int frame);
+
+// Acumula las estadísticas de src en dst
+void frame_clock_merge(FrameClock *dst, const FrameClock *src);
+
+void frame_clock_report(const FrameClock *c, FILE *out);
+
+/*
+ * Percentil p (0-100) del tiempo de frame en µs, según el histograma
+ * (centro geométrico de la casilla). 0 si todavía no hay frames medidos.
+ */
+double frame_clock_percentile_us(const FrameClock *c, double p);
+
+// Segundos entre el epoch y el último frame presentado
+double frame_clock_elapsed(const FrameClock *c);
+
+// Nanosegundos de CLOCK_MONOTONIC
+long long frame_clock_now_ns(void);
+
+// Parsea "drop" / "catch_up"; retorna FRAME_POLICY_DROP si no lo reconoce
+FramePolicy frame_policy_from_string(const char *name);
+
+#endif // FRAME_CLOCK_H
@@ -0,0 +1,226 @@
+#include "frame_encoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CLEAR_SCREEN "\033[2J\033[H"
+#define SGR_RESET "\033[0m"
+
+// Celdas iguales que se reescriben en vez de mover el cursor ("\033[r;cH" ≈ 6-8 bytes)
+#define DELTA_MERGE_GAP 6
+
+unsigned long long frame_encoder_sgr_bytes = 0;
+
+static const char *color_names[8] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+};
+
+int attr_color_from_string(const char *name) {
+    if (!name) return 0;
+    int bright = strncmp(name, "bright_", 7) == 0;
+    const char *base = bright ? name + 7 : name;
+    for (int k = 0; k < 8; k++) {
+        if (strcmp(base, color_names[k]) == 0) return 1 + k + (bright ? 8 : 0);
+    }
+    return 0;
+}
+
+void bytebuf_init(ByteBuffer *b) {
+    b->data = NULL;
+    b->len = b->cap = 0;
+}
+
+void bytebuf_free(ByteBuffer *b) {
+    free(b->data);
+    bytebuf_init(b);
+}
+
+void bytebuf_reset(ByteBuffer *b) {
+    b->len = 0;
+}
+
+int bytebuf_reserve(ByteBuffer *b, size_t extra) {
+    if (b->len + extra <= b->cap) return 0;
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + extra) cap *= 2;
+    char *data = realloc(b->data, cap);
+    if (!data) return -1;
+    b->data = data;
+    b->cap = cap;
+    return 0;
+}
+
+int bytebuf_append(ByteBuffer *b, const void *data, size_t len) {
+    if (bytebuf_reserve(b, len) != 0) return -1;
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    return 0;
+}
+
+size_t full_frame_size(int width, int height) {
+    return sizeof(CLEAR_SCREEN) - 1 + (size_t)(width + 1) * height;
+}
+
+int encode_full_frame(const char *cells, int width, int height, ByteBuffer *out) {
+    size_t size = full_frame_size(width, height);
+    if (bytebuf_reserve(out, size) != 0) return -1;
+
+    char *p = out->data + out->len;
+    memcpy(p, CLEAR_SCREEN, sizeof(CLEAR_SCREEN) - 1);
+    p += sizeof(CLEAR_SCREEN) - 1;
+    for (int y = 0; y < height; y++) {
+        memcpy(p, cells + (size_t)y * width, width);
+        p += width;
+        *p++ = '\n';
+    }
+    out->len += size;
+    return 0;
+}
+
+// "\033[fila;columnaH" con coordenadas base 1
+static int append_cursor_move(ByteBuffer *out, int row, int col) {
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\033[%d;%dH", row + 1, col + 1);
+    return bytebuf_append(out, seq, n);
+}
+
+int encode_delta_frame(const char *prev, const char *cur, int width, int height, ByteBuffer *out) {
+    for (int y = 0; y < height; y++) {
+        const char *a = prev + (size_t)y * width;
+        const char *b = cur + (size_t)y * width;
+        if (memcmp(a, b, width) == 0) continue;
+
+        int x = 0;
+        while (x < width) {
+            while (x < width && a[x] == b[x]) x++;
+            if (x == width) break;
+
+            // Extender el tramo mientras los huecos iguales sean cortos
+            int start = x, end = x + 1, gap = 0;
+            for (int k = end; k < width; k++) {
+                if (a[k] != b[k]) {
+                    end = k + 1;
+                    gap = 0;
+                } else if (++gap > DELTA_MERGE_GAP) {
+                    break;
+                }
+            }
+
+            if (append_cursor_move(out, y, start) != 0) return -1;
+            if (bytebuf_append(out, b + start, end - start) != 0) return -1;
+            x = end;
+        }
+    }
+    return append_cursor_move(out, height, 0);
+}
+
+// Un espacio sin subrayado se ve igual con cualquier color o negrita
+static inline int needs_sgr(char c, unsigned char attr, unsigned char state) {
+    return attr != state && (c != ' ' || ((attr | state) & ATTR_UNDERLINE));
+}
+
+static inline int cell_differs(char pc, unsigned char pa, char cc, unsigned char ca) {
+    return pc != cc || (pa != ca && (cc != ' ' || ((pa | ca) & ATTR_UNDERLINE)));
+}
+
+// Agrega el parámetro p (1 o 2 dígitos) y su ';'
+static inline int put_param(char *seq, int n, int p) {
+    if (p >= 10) seq[n++] = (char)('0' + p / 10);
+    seq[n++] = (char)('0' + p % 10);
+    seq[n++] = ';';
+    return n;
+}
+
+/*
+ * "\033[...m" que lleva la terminal de from a to, solo con lo que cambia.
+ * Se arma a mano: con muchas figuras de colores distintos por fila hay un
+ * cambio cada pocas celdas y snprintf dominaría la codificación.
+ */
+static int append_sgr(ByteBuffer *out, unsigned char from, unsigned char to) {
+    if (to == 0) {
+        frame_encoder_sgr_bytes += sizeof(SGR_RESET) - 1;
+        return bytebuf_append(out, SGR_RESET, sizeof(SGR_RESET) - 1);
+    }
+    char seq[16] = "\033[";
+    int n = 2;
+    if ((from ^ to) & ATTR_BOLD) n = put_param(seq, n, to & ATTR_BOLD ? 1 : 22);
+    if ((from ^ to) & ATTR_UNDERLINE) n = put_param(seq, n, to & ATTR_UNDERLINE ? 4 : 24);
+    if ((from ^ to) & ATTR_COLOR_MASK) {
+        int c = to & ATTR_COLOR_MASK;
+        n = put_param(seq, n, c == 0 ? 39 : c <= 8 ? 29 + c : 81 + c);
+    }
+    seq[n - 1] = 'm';  // el último ';' cierra la secuencia
+    frame_encoder_sgr_bytes += n;
+    return bytebuf_append(out, seq, n);
+}
+
+// Escribe n celdas con sus atributos partiendo del estado *state (que actualiza)
+static int append_cells_attr(ByteBuffer *out, const char *cells, const unsigned char *attrs,
+                             int n, unsigned char *state) {
+    int start = 0;
+    for (int x = 0; x < n; x++) {
+        if (!needs_sgr(cells[x], attrs[x], *state)) continue;
+        if (bytebuf_append(out, cells + start, x - start) != 0 ||
+            append_sgr(out, *state, attrs[x]) != 0) {
+            return -1;
+        }
+        *state = attrs[x];
+        start = x;
+    }
+    return bytebuf_append(out, cells + start, n - start);
+}
+
+int encode_full_frame_attr(const char *cells, const unsigned char *attrs, int width, int height,
+                           ByteBuffer *out) {
+    if (!attrs) return encode_full_frame(cells, width, height, out);
+    if (bytebuf_reserve(out, full_frame_size(width, height)) != 0 ||
+        bytebuf_append(out, CLEAR_SCREEN, sizeof(CLEAR_SCREEN) - 1) != 0) {
+        return -1;
+    }
+    unsigned char state = 0;
+    for (int y = 0; y < height; y++) {
+        if (append_cells_attr(out, cells + (size_t)y * width, attrs + (size_t)y * width,
+                              width, &state) != 0 ||
+            bytebuf_append(out, "\n", 1) != 0) {
+            return -1;
+        }
+    }
+    return state != 0 ? append_sgr(out, state, 0) : 0;
+}
+
+int encode_delta_frame_attr(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                            const unsigned char *cur_attrs, int width, int height, ByteBuffer *out) {
+    if (!cur_attrs) return encode_delta_frame(prev, cur, width, height, out);
+    unsigned char state = 0;
+    for (int y = 0; y < height; y++) {
+        size_t row = (size_t)y * width;
+        const char *a = prev + row, *b = cur + row;
+        const unsigned char *aa = prev_attrs + row, *ba = cur_attrs + row;
+        if (memcmp(a, b, width) == 0 && memcmp(aa, ba, width) == 0) continue;
+
+        int x = 0;
+        while (x < width) {
+            while (x < width && !cell_differs(a[x], aa[x], b[x], ba[x])) x++;
+            if (x == width) break;
+
+            // Igual que encode_delta_frame: unir tramos con huecos cortos
+            int start = x, end = x + 1, gap = 0;
+            for (int k = end; k < width; k++) {
+                if (cell_differs(a[k], aa[k], b[k], ba[k])) {
+                    end = k + 1;
+                    gap = 0;
+                } else if (++gap > DELTA_MERGE_GAP) {
+                    break;
+                }
+            }
+
+            if (append_cursor_move(out, y, start) != 0 ||
+                append_cells_attr(out, b + start, ba + start, end - start, &state) != 0) {
+                return -1;
+            }
+            x = end;
+        }
+    }
+    if (state != 0 && append_sgr(out, state, 0) != 0) return -1;
+    return append_cursor_move(out, height, 0);
+}
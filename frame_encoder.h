@@ -0,0 +1,78 @@
+#ifndef FRAME_ENCODER_H
+#define FRAME_ENCODER_H
+
+#include <stddef.h>
+
+// Buffer de bytes que crece según haga falta
+typedef struct {
+    char *data;
+    size_t len, cap;
+} ByteBuffer;
+
+void bytebuf_init(ByteBuffer *b);
+void bytebuf_free(ByteBuffer *b);
+void bytebuf_reset(ByteBuffer *b);
+
+// Asegura espacio para extra bytes más. Retorna 0 en éxito, -1 si falla.
+int bytebuf_reserve(ByteBuffer *b, size_t extra);
+int bytebuf_append(ByteBuffer *b, const void *data, size_t len);
+
+/*
+ * Codifica un frame completo tal como lo imprimen los animadores:
+ * limpiar pantalla, cursor al inicio y cada fila seguida de '\n'.
+ * cells tiene width * height bytes por filas. Retorna 0 o -1.
+ */
+int encode_full_frame(const char *cells, int width, int height, ByteBuffer *out);
+
+/*
+ * Atributo de una celda, en un plano paralelo a las celdas (un byte por
+ * celda, mismo orden): bits 0-4 el color del carácter (0 = el de la
+ * terminal, 1-8 = ANSI 30-37, 9-16 = brillantes 90-97), más negrita y
+ * subrayado. 0 = sin atributos, así que un plano en cero codifica los
+ * mismos bytes que un frame monocromo.
+ */
+#define ATTR_COLOR_MASK 0x1f
+#define ATTR_BOLD       0x20
+#define ATTR_UNDERLINE  0x40
+
+// "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white" y "bright_*"; 0 si no
+int attr_color_from_string(const char *name);
+
+/*
+ * Bytes de secuencias SGR escritos por los codificadores con atributos
+ * desde que arrancó el proceso (para --stats, ver anim_stats.h).
+ */
+extern unsigned long long frame_encoder_sgr_bytes;
+
+/*
+ * encode_full_frame con color: attrs es el plano de atributos de cells
+ * (NULL = monocromo). El estado de la terminal se sigue a lo largo del
+ * frame y solo se emite SGR donde el atributo efectivo cambia: un espacio
+ * sin subrayado se ve igual con cualquier color, así que no corta el
+ * tramo. El frame termina con los atributos en cero. Retorna 0 o -1.
+ */
+int encode_full_frame_attr(const char *cells, const unsigned char *attrs, int width, int height,
+                           ByteBuffer *out);
+
+// Bytes que ocupa encode_full_frame para un canvas de width x height
+size_t full_frame_size(int width, int height);
+
+/*
+ * Codifica solo lo que cambió entre prev y cur: por cada tramo de celdas
+ * distintas, una secuencia de posicionamiento del cursor seguida de los
+ * caracteres nuevos. Tramos separados por pocas celdas iguales se unen
+ * (reescribirlas es más barato que reposicionar). Al final deja el cursor
+ * debajo del canvas, igual que encode_full_frame. Retorna 0 o -1.
+ */
+int encode_delta_frame(const char *prev, const char *cur, int width, int height, ByteBuffer *out);
+
+/*
+ * encode_delta_frame con color: una celda cambia si cambia su carácter o
+ * su atributo visible. Los tramos se escriben con el mismo seguimiento
+ * de SGR que encode_full_frame_attr, que sobrevive a los saltos del
+ * cursor. Con cur_attrs NULL es encode_delta_frame. Retorna 0 o -1.
+ */
+int encode_delta_frame_attr(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                            const unsigned char *cur_attrs, int width, int height, ByteBuffer *out);
+
+#endif // FRAME_ENCODER_H
@@ -0,0 +1,367 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "hot_reload.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "scene.h"
+
+#define HOT_RELOAD_MAX_GARBAGE 4    // configuraciones viejas esperando su free
+
+struct HotReload {
+    AnimationConfig *config;         // escena en ejecución (solo la cambia hot_reload_poll)
+    char path[1024];
+    char name[256];                  // nombre del archivo dentro del directorio vigilado
+    int inotify_fd;
+    int wake[2];                     // pipe para despertar al hilo: basura o salida
+    pthread_t thread;
+
+    /*
+     * lock cubre lo de abajo. El hilo lo toma mientras compara contra la
+     * escena en ejecución, así que poll nunca la cambia a mitad de un diff.
+     */
+    pthread_mutex_t lock;
+    AnimationConfig *pending;        // recarga lista para aplicar
+    int *pending_changed;
+    int pending_num_changed;
+    int pending_resized, pending_relayout;
+    long long event_ns, parse_ns;    // cuándo cambió el archivo y cuánto tardó la carga
+    AnimationConfig *garbage[HOT_RELOAD_MAX_GARBAGE];
+    int num_garbage;
+    int stop;
+
+    int *changed;                    // lista entregada en el último poll
+    int reloads, unchanged, failures;
+    double latency_sum_ms, latency_max_ms;
+};
+
+// Retorna 1 si la figura i es igual en ambas escenas (campos, keyframes y glifos)
+static int same_figure(const AnimationConfig *a, const AnimationConfig *b, int i) {
+    const Scene *sa = a->scene, *sb = b->scene;
+    if (sa->t_start[i] != sb->t_start[i] || sa->t_end[i] != sb->t_end[i] ||
+        sa->x0[i] != sb->x0[i] || sa->y0[i] != sb->y0[i] ||
+        sa->x1[i] != sb->x1[i] || sa->y1[i] != sb->y1[i] ||
+        sa->rows[i] != sb->rows[i] || sa->cols[i] != sb->cols[i] || sa->attr[i] != sb->attr[i]) {
+        return 0;
+    }
+
+    const Trajectory *ta = a->trajectory, *tb = b->trajectory;
+    if (ta->key_count[i] != tb->key_count[i]) return 0;
+    if (memcmp(&ta->keys[ta->key_start[i]], &tb->keys[tb->key_start[i]],
+               sizeof(Keyframe) * ta->key_count[i]) != 0) {
+        return 0;
+    }
+
+    size_t size = (size_t)sa->rows[i] * (sa->cols[i] + 1);
+    for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+        const char *ga = scene_glyph(sa, i, k), *gb = scene_glyph(sb, i, k);
+        if (!ga != !gb) return 0;
+        if (ga && memcmp(ga, gb, size) != 0) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Compara next contra la escena en ejecución y deja la lista de figuras
+ * nuevas o modificadas en *changed. Retorna cuántas son, o -1 si falla.
+ */
+static int diff_configs(const AnimationConfig *cur, const AnimationConfig *next,
+                        int **changed, int *relayout) {
+    int common = cur->num_figures < next->num_figures ? cur->num_figures : next->num_figures;
+    *changed = malloc(sizeof(int) * (next->num_figures > 0 ? next->num_figures : 1));
+    if (!*changed) return -1;
+
+    int n = 0;
+    *relayout = cur->num_figures != next->num_figures;
+    for (int i = 0; i < common; i++) {
+        if (cur->trajectory->key_count[i] != next->trajectory->key_count[i]) *relayout = 1;
+        if (!same_figure(cur, next, i)) (*changed)[n++] = i;
+    }
+    for (int i = common; i < next->num_figures; i++) (*changed)[n++] = i;
+    return n;
+}
+
+static void report_ignored(const AnimationConfig *cur, const AnimationConfig *next) {
+    if (cur->canvas.width != next->canvas.width || cur->canvas.height != next->canvas.height ||
+        cur->fps != next->fps || cur->loops != next->loops) {
+        fprintf(stderr, "[RELOAD] canvas, fps y loops no se recargan: se aplican al reiniciar\n");
+    }
+    if (cur->world.width != next->world.width || cur->world.height != next->world.height ||
+        cur->num_viewports != next->num_viewports || cur->num_pan_keys != next->num_pan_keys ||
+        (cur->num_viewports > 0 &&
+         memcmp(cur->viewports, next->viewports, sizeof(Viewport) * cur->num_viewports) != 0) ||
+        (cur->num_pan_keys > 0 &&
+         memcmp(cur->pan_keys, next->pan_keys, sizeof(Keyframe) * cur->num_pan_keys) != 0)) {
+        fprintf(stderr, "[RELOAD] world y viewports no se recargan: se aplican al reiniciar\n");
+    }
+}
+
+// Carga el archivo otra vez y deja el resultado pendiente para el próximo frame
+static void reload(HotReload *hr, long long event_ns) {
+    long long begin = frame_clock_now_ns();
+    AnimationConfig *next = load_config(hr->path);
+    long long end = frame_clock_now_ns();
+    if (!next) {
+        pthread_mutex_lock(&hr->lock);
+        hr->failures++;
+        pthread_mutex_unlock(&hr->lock);
+        fprintf(stderr, "[RELOAD] %s no se pudo cargar: sigue la escena anterior\n", hr->path);
+        return;
+    }
+
+    AnimationConfig *discard = next, *stale = NULL;
+    int *changed = NULL;
+    int relayout = 0;
+
+    pthread_mutex_lock(&hr->lock);
+    report_ignored(hr->config, next);
+    int n = diff_configs(hr->config, next, &changed, &relayout);
+    int same = n == 0 && next->num_figures == hr->config->num_figures;
+    if (n < 0) {
+        hr->failures++;
+    } else if (same) {
+        // El archivo volvió a lo que ya corre: una recarga pendiente ya no vale
+        hr->unchanged++;
+        stale = hr->pending;
+        free(hr->pending_changed);
+        hr->pending = NULL;
+        hr->pending_changed = NULL;
+    } else {
+        // Una recarga que no llegó a aplicarse se reemplaza por la nueva
+        stale = hr->pending;
+        free(hr->pending_changed);
+        if (!stale) hr->event_ns = event_ns;  // la latencia cuenta desde el primer cambio
+        hr->pending = next;
+        hr->pending_changed = changed;
+        hr->pending_num_changed = n;
+        hr->pending_resized = next->num_figures != hr->config->num_figures;
+        hr->pending_relayout = relayout;
+        hr->parse_ns = end - begin;
+        discard = NULL;
+        changed = NULL;
+    }
+    pthread_mutex_unlock(&hr->lock);
+
+    if (same) {
+        fprintf(stderr, "[RELOAD] %s: sin cambios en las figuras (carga %.1f ms)\n",
+                hr->path, (end - begin) / 1e6);
+    }
+    free(changed);
+    free_config(discard);
+    free_config(stale);
+}
+
+// Vacía la cola de inotify. Retorna 1 si algún evento era sobre el archivo vigilado
+static int read_events(HotReload *hr) {
+    union {
+        struct inotify_event ev;     // alinea el búfer para los eventos
+        char bytes[4096];
+    } u;
+    char *buf = u.bytes;
+    int hit = 0;
+    for (;;) {
+        ssize_t len = read(hr->inotify_fd, buf, sizeof(u.bytes));
+        if (len <= 0) break;
+        for (char *p = buf; p < buf + len;) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            if (ev->len > 0 && strcmp(ev->name, hr->name) == 0) hit = 1;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+    return hit;
+}
+
+static void *watch_thread(void *arg) {
+    HotReload *hr = arg;
+    long long event_ns = 0, last_ns = 0;    // primer y último cambio de la ráfaga
+    for (;;) {
+        // Con un cambio visto se espera a que el archivo deje de moverse
+        int timeout = -1;
+        if (event_ns) {
+            long long left = last_ns + HOT_RELOAD_DEBOUNCE_MS * 1000000LL - frame_clock_now_ns();
+            if (left <= 0) {
+                reload(hr, event_ns);
+                event_ns = 0;
+                continue;
+            }
+            timeout = (int)((left + 999999) / 1000000);
+        }
+
+        struct pollfd fds[2] = {
+            {hr->inotify_fd, POLLIN, 0},
+            {hr->wake[0], POLLIN, 0},
+        };
+        if (poll(fds, 2, timeout) < 0 && errno != EINTR) break;
+
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (read(hr->wake[0], drain, sizeof(drain)) > 0) {}
+
+            AnimationConfig *garbage[HOT_RELOAD_MAX_GARBAGE];
+            pthread_mutex_lock(&hr->lock);
+            int n = hr->num_garbage;
+            memcpy(garbage, hr->garbage, sizeof(garbage[0]) * n);
+            hr->num_garbage = 0;
+            int stop = hr->stop;
+            pthread_mutex_unlock(&hr->lock);
+            for (int i = 0; i < n; i++) free_config(garbage[i]);
+            if (stop) break;
+        }
+        if ((fds[0].revents & POLLIN) && read_events(hr)) {
+            last_ns = frame_clock_now_ns();
+            if (!event_ns) event_ns = last_ns;
+        }
+    }
+    return NULL;
+}
+
+HotReload *hot_reload_start(AnimationConfig *config, const char *path) {
+    HotReload *hr = calloc(1, sizeof(HotReload));
+    if (!hr) return NULL;
+    hr->config = config;
+    hr->wake[0] = hr->wake[1] = -1;
+    snprintf(hr->path, sizeof(hr->path), "%s", path);
+
+    // Se vigila el directorio: un rename del editor reemplaza el inodo del archivo
+    char dir[1024];
+    const char *slash = strrchr(path, '/');
+    if (slash) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+        if (slash == path) snprintf(dir, sizeof(dir), "/");
+        snprintf(hr->name, sizeof(hr->name), "%s", slash + 1);
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+        snprintf(hr->name, sizeof(hr->name), "%s", path);
+    }
+
+    hr->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (hr->inotify_fd < 0 ||
+        inotify_add_watch(hr->inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        fprintf(stderr, "[RELOAD] no se puede vigilar %s: %s\n", dir, strerror(errno));
+        if (hr->inotify_fd >= 0) close(hr->inotify_fd);
+        free(hr);
+        return NULL;
+    }
+    if (pipe(hr->wake) != 0) {
+        close(hr->inotify_fd);
+        free(hr);
+        return NULL;
+    }
+    for (int i = 0; i < 2; i++) {
+        int flags = fcntl(hr->wake[i], F_GETFL);
+        fcntl(hr->wake[i], F_SETFL, flags | O_NONBLOCK);
+    }
+
+    pthread_mutex_init(&hr->lock, NULL);
+    if (pthread_create(&hr->thread, NULL, watch_thread, hr) != 0) {
+        pthread_mutex_destroy(&hr->lock);
+        close(hr->wake[0]);
+        close(hr->wake[1]);
+        close(hr->inotify_fd);
+        free(hr);
+        return NULL;
+    }
+    fprintf(stderr, "[RELOAD] vigilando %s\n", hr->path);
+    return hr;
+}
+
+int hot_reload_poll(HotReload *hr, HotReloadChange *change) {
+    memset(change, 0, sizeof(*change));
+    if (!hr || pthread_mutex_trylock(&hr->lock) != 0) return 0;
+    if (!hr->pending || hr->num_garbage == HOT_RELOAD_MAX_GARBAGE) {
+        pthread_mutex_unlock(&hr->lock);
+        return 0;
+    }
+
+    // Intercambio de la escena: la vieja queda en next y se libera en el hilo
+    AnimationConfig *cur = hr->config, *next = hr->pending;
+    AnimationConfig old = *cur;
+    cur->num_figures = next->num_figures;
+    cur->figures = next->figures;
+    cur->trajectory = next->trajectory;
+    cur->scene = next->scene;
+    cur->file = next->file;
+    cur->hash = next->hash;
+    next->num_figures = old.num_figures;
+    next->figures = old.figures;
+    next->trajectory = old.trajectory;
+    next->scene = old.scene;
+    next->file = old.file;
+    next->hash = old.hash;
+    hr->garbage[hr->num_garbage++] = next;
+    hr->pending = NULL;
+
+    free(hr->changed);
+    hr->changed = hr->pending_changed;
+    hr->pending_changed = NULL;
+    change->changed = hr->changed;
+    change->num_changed = hr->pending_num_changed;
+    change->resized = hr->pending_resized;
+    change->relayout = hr->pending_relayout;
+
+    double parse_ms = hr->parse_ns / 1e6;
+    double latency_ms = (frame_clock_now_ns() - hr->event_ns) / 1e6;
+    hr->reloads++;
+    hr->latency_sum_ms += latency_ms;
+    if (latency_ms > hr->latency_max_ms) hr->latency_max_ms = latency_ms;
+    pthread_mutex_unlock(&hr->lock);
+
+    if (write(hr->wake[1], "", 1) < 0) {}  // si el pipe está lleno el hilo ya tiene aviso
+    fprintf(stderr, "[RELOAD] %d figuras nuevas o cambiadas de %d: carga %.1f ms, "
+            "aplicada %.1f ms después del cambio\n",
+            change->num_changed, cur->num_figures, parse_ms, latency_ms);
+    return 1;
+}
+
+int hot_reload_sync_trajectory(const HotReloadChange *change, TrajectoryState *st,
+                               const Trajectory *tr) {
+    if (change->resized) {
+        int t = st->t;
+        trajectory_state_free(st);
+        return trajectory_state_init(st, tr, t);
+    }
+    st->table = tr;
+    if (change->relayout) {
+        trajectory_seek(st, st->t);
+    } else {
+        for (int c = 0; c < change->num_changed; c++) trajectory_seek_figure(st, change->changed[c]);
+    }
+    return 0;
+}
+
+void hot_reload_stop(HotReload *hr) {
+    if (!hr) return;
+    pthread_mutex_lock(&hr->lock);
+    hr->stop = 1;
+    pthread_mutex_unlock(&hr->lock);
+    if (write(hr->wake[1], "", 1) < 0) {}
+    pthread_join(hr->thread, NULL);
+
+    for (int i = 0; i < hr->num_garbage; i++) free_config(hr->garbage[i]);
+    free_config(hr->pending);
+    free(hr->pending_changed);
+    free(hr->changed);
+    pthread_mutex_destroy(&hr->lock);
+    close(hr->wake[0]);
+    close(hr->wake[1]);
+    close(hr->inotify_fd);
+
+    if (hr->reloads > 0) {
+        fprintf(stderr, "[RELOAD] %d recargas aplicadas: latencia media %.1f ms, máxima %.1f ms "
+                "(%d sin cambios, %d con error)\n", hr->reloads,
+                hr->latency_sum_ms / hr->reloads, hr->latency_max_ms,
+                hr->unchanged, hr->failures);
+    } else {
+        fprintf(stderr, "[RELOAD] sin recargas aplicadas (%d sin cambios, %d con error)\n",
+                hr->unchanged, hr->failures);
+    }
+    free(hr);
+}
@@ -0,0 +1,57 @@
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+#include "anim_config.h"
+#include "trajectory.h"
+
+// Espera sin eventos nuevos antes de releer (un guardado suele ser varios)
+#define HOT_RELOAD_DEBOUNCE_MS 50
+
+/*
+ * Recarga en caliente del archivo de configuración. Un hilo vigila el
+ * directorio con inotify (los editores suelen guardar con rename) y, ante
+ * un cambio, vuelve a cargar el archivo con load_config y lo compara
+ * figura por figura con la escena en ejecución. El motor llama a
+ * hot_reload_poll al empezar cada frame: si hay una recarga lista, la
+ * escena se intercambia ahí de una sola vez y el motor solo reubica las
+ * figuras nuevas o modificadas. La configuración vieja se libera en el
+ * hilo de recarga, así que el frame no espera ni el parseo ni los free.
+ *
+ * Solo se recargan las figuras: canvas, fps, vueltas y displays quedan
+ * como estaban hasta reiniciar.
+ */
+typedef struct HotReload HotReload;
+
+// Cambios de una recarga aplicada en este frame
+typedef struct {
+    int resized;             // cambió la cantidad de figuras
+    int relayout;            // cambió la cantidad de keyframes de alguna figura
+    const int *changed;      // figuras nuevas o modificadas (válido hasta el próximo poll)
+    int num_changed;
+} HotReloadChange;
+
+/*
+ * Empieza a vigilar path, que es de donde salió config. Retorna NULL si
+ * no se puede (el motor sigue sin recarga).
+ */
+HotReload *hot_reload_start(AnimationConfig *config, const char *path);
+
+/*
+ * Se llama entre frames, desde el hilo que dibuja. Nunca bloquea: si el
+ * hilo de recarga está comparando, se prueba en el frame siguiente.
+ * Retorna 1 y llena change si se aplicó una recarga, 0 si no.
+ */
+int hot_reload_poll(HotReload *hr, HotReloadChange *change);
+
+/*
+ * Ajusta el cursor de trayectorias a la escena recargada: con la misma
+ * disposición de keyframes solo recarga las figuras cambiadas, si no las
+ * reubica todas. El cursor queda en el mismo tick. Retorna 0 o -1.
+ */
+int hot_reload_sync_trajectory(const HotReloadChange *change, TrajectoryState *st,
+                               const Trajectory *tr);
+
+// Detiene el hilo, libera lo pendiente y reporta las latencias en stderr
+void hot_reload_stop(HotReload *hr);
+
+#endif // HOT_RELOAD_H
@@ -0,0 +1,373 @@
+#include "json_stream.h"
+#include "anim_utils.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    EXPECT_VALUE,                // valor raíz o después de ':' / ',' en arreglo
+    EXPECT_VALUE_OR_END,         // recién abierto '['
+    EXPECT_KEY,                  // después de ',' en objeto
+    EXPECT_KEY_OR_END,           // recién abierto '{'
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_END,
+    EXPECT_NOTHING               // ya se leyó el valor raíz
+};
+
+int json_stream_open(JsonStream *js, const char *path) {
+    memset(js, 0, sizeof(*js));
+    js->name = path;
+    js->hash = HASH_SEED;
+    js->state = EXPECT_VALUE;
+    js->f = fopen(path, "rb");
+    if (!js->f) {
+        snprintf(js->error, sizeof(js->error), "%s: %s", path, strerror(errno));
+        js->failed = 1;
+        return -1;
+    }
+    return 0;
+}
+
+void json_stream_close(JsonStream *js) {
+    if (js->f) fclose(js->f);
+    free(js->text);
+    js->f = NULL;
+    js->text = NULL;
+}
+
+int json_fail(JsonStream *js, long long offset, const char *fmt, ...) {
+    if (js->failed) return -1;
+    js->failed = 1;
+    int n = snprintf(js->error, sizeof(js->error), "%s:%lld: ", js->name, offset);
+    if (n < 0 || (size_t)n >= sizeof(js->error)) return -1;
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(js->error + n, sizeof(js->error) - n, fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+const char *json_event_name(JsonEvent ev) {
+    switch (ev) {
+    case JSON_EOF: return "fin del archivo";
+    case JSON_OBJECT_START: return "un objeto";
+    case JSON_OBJECT_END: return "'}'";
+    case JSON_ARRAY_START: return "un arreglo";
+    case JSON_ARRAY_END: return "']'";
+    case JSON_KEY: return "una clave";
+    case JSON_STRING: return "una cadena";
+    case JSON_NUMBER: return "un número";
+    case JSON_TRUE: case JSON_FALSE: return "un booleano";
+    case JSON_NULL: return "null";
+    default: return "un error";
+    }
+}
+
+static long long position(const JsonStream *js) {
+    return js->base + (long long)js->pos;
+}
+
+// Próximo byte sin consumirlo, o -1 al final del archivo
+static int peek(JsonStream *js) {
+    if (js->pos == js->len) {
+        js->base += js->len;
+        js->len = js->f ? fread(js->buf, 1, sizeof(js->buf), js->f) : 0;
+        js->pos = 0;
+        js->hash = hash_bytes_update(js->hash, js->buf, js->len);
+        if (js->len == 0) return -1;
+    }
+    return (unsigned char)js->buf[js->pos];
+}
+
+static int next_byte(JsonStream *js) {
+    int c = peek(js);
+    if (c >= 0) js->pos++;
+    return c;
+}
+
+// Lugar para n bytes más (y el '\0' final) en js->text
+static int text_reserve(JsonStream *js, size_t n) {
+    if (js->text_len + n >= js->text_cap) {
+        size_t cap = js->text_cap ? js->text_cap : 256;
+        while (cap <= js->text_len + n) cap *= 2;
+        char *text = realloc(js->text, cap);
+        if (!text) return -1;
+        js->text = text;
+        js->text_cap = cap;
+    }
+    return 0;
+}
+
+static int text_push(JsonStream *js, char c) {
+    if (text_reserve(js, 1) != 0) return -1;
+    js->text[js->text_len++] = c;
+    return 0;
+}
+
+static int read_hex4(JsonStream *js, unsigned *out) {
+    unsigned v = 0;
+    for (int k = 0; k < 4; k++) {
+        int c = next_byte(js);
+        v <<= 4;
+        if (c >= '0' && c <= '9') v |= c - '0';
+        else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else return json_fail(js, position(js) - 1, "escape \\u inválido");
+    }
+    *out = v;
+    return 0;
+}
+
+static int push_utf8(JsonStream *js, unsigned cp) {
+    if (cp < 0x80) return text_push(js, (char)cp);
+    if (cp < 0x800) {
+        return text_push(js, (char)(0xC0 | cp >> 6)) | text_push(js, (char)(0x80 | (cp & 0x3F)));
+    }
+    if (cp < 0x10000) {
+        return text_push(js, (char)(0xE0 | cp >> 12)) |
+               text_push(js, (char)(0x80 | ((cp >> 6) & 0x3F))) |
+               text_push(js, (char)(0x80 | (cp & 0x3F)));
+    }
+    return text_push(js, (char)(0xF0 | cp >> 18)) |
+           text_push(js, (char)(0x80 | ((cp >> 12) & 0x3F))) |
+           text_push(js, (char)(0x80 | ((cp >> 6) & 0x3F))) |
+           text_push(js, (char)(0x80 | (cp & 0x3F)));
+}
+
+// Lee una cadena (la comilla inicial ya se consumió) a js->text
+static int read_string(JsonStream *js) {
+    js->text_len = 0;
+    for (;;) {
+        // Tramo sin escapes dentro del bloque actual: se copia de una vez
+        size_t end = js->pos;
+        while (end < js->len && js->buf[end] != '"' && js->buf[end] != '\\' &&
+               (unsigned char)js->buf[end] >= 0x20) {
+            end++;
+        }
+        if (end > js->pos) {
+            size_t n = end - js->pos;
+            if (text_reserve(js, n) != 0) return json_fail(js, js->offset, "sin memoria");
+            memcpy(js->text + js->text_len, js->buf + js->pos, n);
+            js->text_len += n;
+            js->pos = end;
+        }
+
+        int c = next_byte(js);
+        if (c < 0) return json_fail(js, js->offset, "cadena sin cerrar");
+        if (c == '"') break;
+        if (c < 0x20) return json_fail(js, position(js) - 1, "carácter de control en una cadena");
+        if (c != '\\') {
+            if (text_push(js, (char)c) != 0) return json_fail(js, js->offset, "sin memoria");
+            continue;
+        }
+        int e = next_byte(js);
+        char out;
+        switch (e) {
+        case '"': out = '"'; break;
+        case '\\': out = '\\'; break;
+        case '/': out = '/'; break;
+        case 'b': out = '\b'; break;
+        case 'f': out = '\f'; break;
+        case 'n': out = '\n'; break;
+        case 'r': out = '\r'; break;
+        case 't': out = '\t'; break;
+        case 'u': {
+            unsigned cp;
+            if (read_hex4(js, &cp) != 0) return -1;
+            if (cp >= 0xD800 && cp < 0xDC00) {
+                // Par sustituto (caracteres fuera del plano básico)
+                unsigned lo;
+                if (next_byte(js) != '\\' || next_byte(js) != 'u' || read_hex4(js, &lo) != 0 ||
+                    lo < 0xDC00 || lo > 0xDFFF) {
+                    return json_fail(js, position(js), "par sustituto \\u incompleto");
+                }
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            }
+            if (push_utf8(js, cp) != 0) return json_fail(js, js->offset, "sin memoria");
+            continue;
+        }
+        default:
+            return json_fail(js, position(js) - 1, "escape inválido en una cadena");
+        }
+        if (text_push(js, out) != 0) return json_fail(js, js->offset, "sin memoria");
+    }
+    if (text_push(js, '\0') != 0) return json_fail(js, js->offset, "sin memoria");
+    js->text_len--;
+    return 0;
+}
+
+static int is_digit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+// Número según la gramática JSON: -?(0|[1-9]d*)(.d+)?([eE][+-]?d+)?
+static int read_number(JsonStream *js) {
+    char num[64];
+    int n = 0;
+#define TAKE() do { \
+        if (n == (int)sizeof(num) - 1) return json_fail(js, js->offset, "número demasiado largo"); \
+        num[n++] = (char)next_byte(js); \
+    } while (0)
+
+    if (peek(js) == '-') TAKE();
+    if (peek(js) == '0') {
+        TAKE();
+    } else if (is_digit(peek(js))) {
+        while (is_digit(peek(js))) TAKE();
+    } else {
+        return json_fail(js, js->offset, "número inválido");
+    }
+    if (peek(js) == '.') {
+        TAKE();
+        if (!is_digit(peek(js))) return json_fail(js, js->offset, "número inválido");
+        while (is_digit(peek(js))) TAKE();
+    }
+    if (peek(js) == 'e' || peek(js) == 'E') {
+        TAKE();
+        if (peek(js) == '+' || peek(js) == '-') TAKE();
+        if (!is_digit(peek(js))) return json_fail(js, js->offset, "número inválido");
+        while (is_digit(peek(js))) TAKE();
+    }
+#undef TAKE
+    num[n] = '\0';
+    js->number = strtod(num, NULL);
+    return 0;
+}
+
+static int read_literal(JsonStream *js, const char *word) {
+    for (const char *p = word; *p; p++) {
+        if (next_byte(js) != *p) return json_fail(js, js->offset, "se esperaba '%s'", word);
+    }
+    return 0;
+}
+
+// Estado después de terminar un valor en el nivel actual
+static void value_done(JsonStream *js) {
+    js->state = js->depth == 0 ? EXPECT_NOTHING : EXPECT_COMMA_OR_END;
+}
+
+JsonEvent json_next(JsonStream *js) {
+    if (js->failed) return JSON_ERROR;
+    for (;;) {
+        int c = peek(js);
+        while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            js->pos++;
+            c = peek(js);
+        }
+        js->offset = position(js);
+
+        if (c < 0) {
+            if (js->state == EXPECT_NOTHING) return JSON_EOF;
+            json_fail(js, js->offset, "fin de archivo inesperado");
+            return JSON_ERROR;
+        }
+        if (js->state == EXPECT_NOTHING) {
+            json_fail(js, js->offset, "datos después del valor raíz");
+            return JSON_ERROR;
+        }
+
+        if (js->state == EXPECT_COLON) {
+            if (c != ':') {
+                json_fail(js, js->offset, "se esperaba ':'");
+                return JSON_ERROR;
+            }
+            js->pos++;
+            js->state = EXPECT_VALUE;
+            continue;
+        }
+
+        int in_object = js->depth > 0 && js->stack[js->depth - 1] == '{';
+        if (js->state == EXPECT_COMMA_OR_END) {
+            if (c == ',') {
+                js->pos++;
+                js->state = in_object ? EXPECT_KEY : EXPECT_VALUE;
+                continue;
+            }
+            if (c != (in_object ? '}' : ']')) {
+                json_fail(js, js->offset, "se esperaba ',' o '%c'", in_object ? '}' : ']');
+                return JSON_ERROR;
+            }
+        }
+
+        // Fin de contenedor
+        if (c == '}' || c == ']') {
+            int closes_object = c == '}';
+            int ok = js->depth > 0 && closes_object == in_object &&
+                     (js->state == EXPECT_COMMA_OR_END ||
+                      js->state == (closes_object ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END));
+            if (!ok) {
+                json_fail(js, js->offset, "'%c' inesperado", c);
+                return JSON_ERROR;
+            }
+            js->pos++;
+            js->depth--;
+            value_done(js);
+            return closes_object ? JSON_OBJECT_END : JSON_ARRAY_END;
+        }
+
+        // Claves
+        if (js->state == EXPECT_KEY || js->state == EXPECT_KEY_OR_END) {
+            if (c != '"') {
+                json_fail(js, js->offset, "se esperaba una clave entre comillas");
+                return JSON_ERROR;
+            }
+            js->pos++;
+            if (read_string(js) != 0) return JSON_ERROR;
+            js->state = EXPECT_COLON;
+            return JSON_KEY;
+        }
+
+        // Valores
+        switch (c) {
+        case '{':
+        case '[':
+            if (js->depth == JSON_STREAM_MAX_DEPTH) {
+                json_fail(js, js->offset, "anidamiento demasiado profundo");
+                return JSON_ERROR;
+            }
+            js->pos++;
+            js->stack[js->depth++] = (char)c;
+            js->state = c == '{' ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+            return c == '{' ? JSON_OBJECT_START : JSON_ARRAY_START;
+        case '"':
+            js->pos++;
+            if (read_string(js) != 0) return JSON_ERROR;
+            value_done(js);
+            return JSON_STRING;
+        case 't':
+            if (read_literal(js, "true") != 0) return JSON_ERROR;
+            value_done(js);
+            return JSON_TRUE;
+        case 'f':
+            if (read_literal(js, "false") != 0) return JSON_ERROR;
+            value_done(js);
+            return JSON_FALSE;
+        case 'n':
+            if (read_literal(js, "null") != 0) return JSON_ERROR;
+            value_done(js);
+            return JSON_NULL;
+        default:
+            if (c == '-' || is_digit(c)) {
+                if (read_number(js) != 0) return JSON_ERROR;
+                value_done(js);
+                return JSON_NUMBER;
+            }
+            json_fail(js, js->offset, "carácter inesperado '%c'", c);
+            return JSON_ERROR;
+        }
+    }
+}
+
+int json_skip(JsonStream *js, JsonEvent ev) {
+    if (ev == JSON_ERROR) return -1;
+    if (ev != JSON_OBJECT_START && ev != JSON_ARRAY_START) return 0;
+    int depth = 1;
+    while (depth > 0) {
+        JsonEvent e = json_next(js);
+        if (e == JSON_ERROR || e == JSON_EOF) return -1;
+        if (e == JSON_OBJECT_START || e == JSON_ARRAY_START) depth++;
+        if (e == JSON_OBJECT_END || e == JSON_ARRAY_END) depth--;
+    }
+    return 0;
+}
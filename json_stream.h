@@ -0,0 +1,73 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define JSON_STREAM_BUFFER    (64 * 1024)
+#define JSON_STREAM_MAX_DEPTH 64
+
+/*
+ * Lector JSON por eventos: recorre el archivo en bloques de
+ * JSON_STREAM_BUFFER bytes y entrega un evento por token sin armar un
+ * árbol. Valida la gramática (comas, dos puntos, anidamiento) y recuerda
+ * el byte donde empieza cada token para reportar errores con offset.
+ */
+typedef enum {
+    JSON_EOF,
+    JSON_ERROR,
+    JSON_OBJECT_START,
+    JSON_OBJECT_END,
+    JSON_ARRAY_START,
+    JSON_ARRAY_END,
+    JSON_KEY,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL
+} JsonEvent;
+
+typedef struct {
+    FILE *f;
+    const char *name;
+    char buf[JSON_STREAM_BUFFER];
+    size_t len, pos;
+    long long base;              // offset del archivo donde empieza buf
+    unsigned long long hash;     // hash_bytes de todo lo leído hasta ahora
+
+    // Valor del último evento
+    char *text;                  // JSON_KEY / JSON_STRING, sin escapes y terminado en '\0'
+    size_t text_len, text_cap;
+    double number;               // JSON_NUMBER
+    long long offset;            // byte donde empieza el token
+
+    // Gramática
+    char stack[JSON_STREAM_MAX_DEPTH];   // '{' o '[' por nivel
+    int depth;
+    int state;
+
+    int failed;
+    char error[256];
+} JsonStream;
+
+// Abre el archivo. Retorna 0 o -1 (con el error en js->error).
+int json_stream_open(JsonStream *js, const char *path);
+void json_stream_close(JsonStream *js);
+
+// Próximo evento; JSON_ERROR deja el mensaje en js->error
+JsonEvent json_next(JsonStream *js);
+
+// Saltea el valor que empezó con ev (objetos y arreglos completos). Retorna 0 o -1.
+int json_skip(JsonStream *js, JsonEvent ev);
+
+/*
+ * Registra un error en offset (solo el primero cuenta) con el formato
+ * "<archivo>:<offset>: mensaje". Retorna -1 para poder hacer return.
+ */
+int json_fail(JsonStream *js, long long offset, const char *fmt, ...);
+
+// Nombre legible de un evento, para mensajes de error
+const char *json_event_name(JsonEvent ev);
+
+#endif // JSON_STREAM_H
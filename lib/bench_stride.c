@@ -0,0 +1,180 @@
+/*==============================================================================
+  bench_stride.c
+
+  Compara la equidad de Lottery y Stride en ventanas cortas.
+  - Crea N hilos de la misma política que solo anotan quién corrió y hacen
+    my_thread_yield (cada yield es un quantum; no se usa el temporizador).
+  - Parte la traza en ventanas de N, 10N y 100N quanta y mide en cada una
+    el desvío del hilo más alejado de su parte ideal (W * tickets / total).
+  - Cada corrida va en su propio proceso: el último hilo manda el
+    resultado por un pipe y termina el proceso.
+  Uso: bench_stride [hilos] [quanta]
+==============================================================================*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "mypthread.h"
+
+#define NUM_WINDOWS 3
+
+typedef struct {
+    int ok;
+    double ns_per_quantum;            // yield + elección + cambio de contexto
+    int window[NUM_WINDOWS];          // largo de cada ventana, en quanta
+    double mean_error[NUM_WINDOWS];   // desvío máximo por ventana, promedio
+    double worst_error[NUM_WINDOWS];  // el peor de todas las ventanas
+} FairnessResult;
+
+/* Estado de la corrida (en el proceso hijo) */
+static int num_threads;
+static int quanta;
+static int *tickets;
+static int *ids;
+static int *trace;                    // hilo que usó cada quantum
+static int done = 0;
+static long long start_ns;
+static int result_fd;
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void measure_windows(FairnessResult *r) {
+    int total = 0;
+    for (int i = 0; i < num_threads; i++) total += tickets[i];
+    int *count = malloc(sizeof(int) * num_threads);
+
+    for (int w = 0; w < NUM_WINDOWS; w++) {
+        int len = r->window[w];
+        int windows = quanta / len;
+        double sum = 0, worst = 0;
+        for (int k = 0; k < windows; k++) {
+            memset(count, 0, sizeof(int) * num_threads);
+            for (int q = k * len; q < (k + 1) * len; q++) count[trace[q]]++;
+
+            double err = 0;
+            for (int i = 0; i < num_threads; i++) {
+                double d = count[i] - (double)len * tickets[i] / total;
+                if (d < 0) d = -d;
+                if (d > err) err = d;
+            }
+            sum += err;
+            if (err > worst) worst = err;
+        }
+        r->mean_error[w] = windows > 0 ? sum / windows : 0;
+        r->worst_error[w] = worst;
+    }
+    free(count);
+}
+
+/* Lo llama el hilo que usó el último quantum */
+static void finish_run(void) {
+    FairnessResult r;
+    memset(&r, 0, sizeof(r));
+    r.ns_per_quantum = (double)(now_ns() - start_ns) / quanta;
+    r.window[0] = num_threads;
+    r.window[1] = num_threads * 10;
+    r.window[2] = num_threads * 100;
+    measure_windows(&r);
+    r.ok = 1;
+    ssize_t n = write(result_fd, &r, sizeof(r));
+    _exit(n == (ssize_t)sizeof(r) ? 0 : 1);
+}
+
+static void worker(void) {
+    for (;;) {
+        trace[done++] = *(int *)current_thread->arg;
+        if (done == quanta) finish_run();
+        my_thread_yield();
+    }
+}
+
+static void run_policy(int sched, int mixed) {
+    rr_init();
+    lottery_init();
+    stride_init();
+    rt_init();
+    srand(1);
+
+    tickets = malloc(sizeof(int) * num_threads);
+    ids = malloc(sizeof(int) * num_threads);
+    trace = malloc(sizeof(int) * quanta);
+    if (!tickets || !ids || !trace) _exit(1);
+
+    for (int i = 0; i < num_threads; i++) {
+        my_thread_t *t;
+        tickets[i] = mixed ? 1 + i % 4 : 5;
+        ids[i] = i;
+        if (my_thread_create(&t, worker, sched, tickets[i]) != 0) _exit(1);
+        t->arg = &ids[i];
+    }
+
+    start_ns = now_ns();
+    current_thread = sched == SCHED_STRIDE ? stride_pick_next() : lottery_pick_next();
+    setcontext(&current_thread->context);
+    _exit(1);
+}
+
+static int measure(int sched, int mixed, FairnessResult *out) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        result_fd = fds[1];
+        run_policy(sched, mixed);
+    }
+    close(fds[1]);
+    ssize_t n = read(fds[0], out, sizeof(*out));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return n == (ssize_t)sizeof(*out) && out->ok ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    num_threads = argc > 1 ? atoi(argv[1]) : 8;
+    quanta = argc > 2 ? atoi(argv[2]) : 100000;
+    if (num_threads <= 0) num_threads = 1;
+    if (quanta < num_threads * 100) quanta = num_threads * 100;
+
+    printf("%d hilos, %d quanta por corrida; desvío = |quanta usados - parte ideal| "
+           "del hilo más alejado\n", num_threads, quanta);
+    printf("%-8s %-8s %10s", "política", "tickets", "ns/quantum");
+    for (int w = 0; w < NUM_WINDOWS; w++) {
+        char head[32];
+        snprintf(head, sizeof(head), "W=%d prom/peor", num_threads * (w == 0 ? 1 : w == 1 ? 10 : 100));
+        printf(" | %18s", head);
+    }
+    printf("\n");
+
+    static const int policies[] = {SCHED_LOTTERY, SCHED_STRIDE};
+    static const char *names[] = {"lottery", "stride"};
+    for (int mixed = 0; mixed <= 1; mixed++) {
+        for (int p = 0; p < 2; p++) {
+            FairnessResult r;
+            if (measure(policies[p], mixed, &r) != 0) {
+                printf("%-8s %-8s falló\n", names[p], mixed ? "1..4" : "iguales");
+                continue;
+            }
+            printf("%-8s %-8s %10.1f", names[p], mixed ? "1..4" : "iguales", r.ns_per_quantum);
+            for (int w = 0; w < NUM_WINDOWS; w++) {
+                printf(" | %8.2f %9.2f", r.mean_error[w], r.worst_error[w]);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*==============================================================================
+  check_stride.c
+
+  Pruebas de comportamiento del scheduler Stride.
+  - Heap: agrega, quita y cobra quanta a hilos armados a mano (sin contexto)
+    y comprueba que stride_head sea siempre el listo de menor pass y que
+    heap_index sea coherente.
+  - Corrida real: hilos Stride que anotan quién corrió y hacen
+    my_thread_yield. La traza se repite igual entre corridas, cada hilo
+    se aleja menos de STRIDE_BOUND quanta de su parte ideal en cualquier
+    prefijo, y un hilo que llega a mitad de corrida recibe su parte desde
+    que llega (no la que "se perdió"). Cada corrida va en su propio
+    proceso, como en bench_stride.
+  Sale con 1 si alguna comprobación falla.
+==============================================================================*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "mypthread.h"
+
+#define NUM_THREADS  6
+#define QUANTA       6000
+#define STRIDE_BOUND 2.0
+
+static int checks, failures;
+
+#define CHECK(cond, ...)                                              \
+    do {                                                              \
+        checks++;                                                     \
+        if (!(cond)) {                                                \
+            failures++;                                               \
+            fprintf(stderr, "FALLO %s:%d: ", __FILE__, __LINE__);     \
+            fprintf(stderr, __VA_ARGS__);                             \
+            fprintf(stderr, "\n");                                    \
+        }                                                             \
+    } while (0)
+
+/* ----------------------- Heap sin contextos ----------------------- */
+
+static int heap_consistent(my_thread_t *fake, int n, const int *ready) {
+    my_thread_t *min = NULL;
+    int slots[64] = {0};
+    for (int i = 0; i < n; i++) {
+        if (!ready[i]) {
+            if (fake[i].heap_index != -1) return 0;
+            continue;
+        }
+        int k = fake[i].heap_index;
+        if (k < 0 || k >= n || slots[k]++) return 0;
+        if (!min || fake[i].pass < min->pass) min = &fake[i];
+    }
+    return min ? stride_head && stride_head->pass == min->pass : stride_head == NULL;
+}
+
+static void check_heap(void) {
+    enum { N = 50, OPS = 20000 };
+    my_thread_t fake[N];
+    int ready[N];
+    stride_init();
+    srand(50);
+    memset(fake, 0, sizeof(fake));
+    for (int i = 0; i < N; i++) {
+        fake[i].sched_type = SCHED_STRIDE;
+        fake[i].tickets = 1 + rand() % 20;
+        fake[i].stride = (1LL << 30) / fake[i].tickets;
+        fake[i].heap_index = -1;
+        stride_add(&fake[i]);
+        ready[i] = 1;
+    }
+    CHECK(heap_consistent(fake, N, ready), "heap inconsistente después de agregar");
+
+    int bad = 0, lowered = 0;
+    for (int op = 0; op < OPS; op++) {
+        int r = rand() % 10;
+        if (r < 7 && stride_head) {
+            /* Cobrar un quantum al elegido, como stride_yield_current */
+            my_thread_t *t = stride_pick_next();
+            stride_remove(t);
+            t->pass += t->stride;
+            stride_add(t);
+        } else if (r < 9) {
+            int i = rand() % N;
+            stride_remove(&fake[i]);
+            ready[i] = 0;
+        } else {
+            int i = rand() % N;
+            long long before = stride_head ? stride_pick_next()->pass : 0;
+            if (!ready[i]) {
+                stride_add(&fake[i]);
+                ready[i] = 1;
+                /* Un hilo que vuelve no arrastra crédito de cuando no estaba */
+                lowered += fake[i].pass < before;
+            }
+        }
+        bad += !heap_consistent(fake, N, ready);
+    }
+    CHECK(bad == 0, "heap inconsistente en %d de %d operaciones", bad, OPS);
+    CHECK(lowered == 0, "%d hilos volvieron con un pass menor al global", lowered);
+    for (int i = 0; i < N; i++) stride_remove(&fake[i]);
+    CHECK(stride_head == NULL, "el heap no quedó vacío");
+}
+
+/* ----------------------- Corrida real ----------------------- */
+
+static const int tickets[NUM_THREADS + 1] = {1, 2, 3, 4, 5, 7, 4};  // el último llega tarde
+static int ids[NUM_THREADS + 1];
+static int trace[QUANTA];
+static int done = 0;
+static int result_fd;
+
+static void worker(void);
+
+static void finish_run(void) {
+    ssize_t n = write(result_fd, trace, sizeof(trace));
+    _exit(n == (ssize_t)sizeof(trace) ? 0 : 1);
+}
+
+static void worker(void) {
+    for (;;) {
+        trace[done++] = *(int *)current_thread->arg;
+        if (done == QUANTA) finish_run();
+        if (done == QUANTA / 2) {
+            my_thread_t *late;
+            if (my_thread_create(&late, worker, SCHED_STRIDE, tickets[NUM_THREADS]) != 0) _exit(1);
+            late->arg = &ids[NUM_THREADS];
+        }
+        my_thread_yield();
+    }
+}
+
+static void run_stride(void) {
+    rr_init();
+    lottery_init();
+    stride_init();
+    rt_init();
+    for (int i = 0; i < NUM_THREADS; i++) {
+        my_thread_t *t;
+        ids[i] = i;
+        if (my_thread_create(&t, worker, SCHED_STRIDE, tickets[i]) != 0) _exit(1);
+        t->arg = &ids[i];
+    }
+    ids[NUM_THREADS] = NUM_THREADS;
+    current_thread = stride_pick_next();
+    setcontext(&current_thread->context);
+    _exit(1);
+}
+
+static int record_run(int *out) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        result_fd = fds[1];
+        run_stride();
+    }
+    close(fds[1]);
+    size_t got = 0;
+    ssize_t n;
+    while (got < sizeof(trace) && (n = read(fds[0], (char *)out + got, sizeof(trace) - got)) > 0) {
+        got += n;
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return got == sizeof(trace) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+/* Desvío máximo de un hilo respecto de su parte ideal en los prefijos de [begin, end) */
+static double worst_prefix_error(const int *run, int begin, int end, int threads) {
+    int total = 0, count[NUM_THREADS + 1] = {0};
+    for (int i = 0; i < threads; i++) total += tickets[i];
+    double worst = 0;
+    for (int q = begin; q < end; q++) {
+        count[run[q]]++;
+        for (int i = 0; i < threads; i++) {
+            double d = count[i] - (double)(q - begin + 1) * tickets[i] / total;
+            if (d < 0) d = -d;
+            if (d > worst) worst = d;
+        }
+    }
+    return worst;
+}
+
+static void check_run(void) {
+    static int first[QUANTA], second[QUANTA];
+    int ok = record_run(first) == 0 && record_run(second) == 0;
+    CHECK(ok, "la corrida con hilos Stride no terminó");
+    if (!ok) return;
+    CHECK(memcmp(first, second, sizeof(first)) == 0, "dos corridas iguales dieron trazas distintas");
+
+    double before = worst_prefix_error(first, 0, QUANTA / 2, NUM_THREADS);
+    double after = worst_prefix_error(first, QUANTA / 2, QUANTA, NUM_THREADS + 1);
+    CHECK(before < STRIDE_BOUND, "desvío de %.2f quanta con %d hilos", before, NUM_THREADS);
+    CHECK(after < STRIDE_BOUND, "desvío de %.2f quanta después de llegar el hilo tardío", after);
+}
+
+int main(void) {
+    check_heap();
+    check_run();
+    printf("%d comprobaciones, %d fallos\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -17,6 +17,7 @@ my_thread_t *main_thread    = NULL;
 my_thread_t *rr_head       = NULL;
 my_thread_t *lottery_head  = NULL;
 my_thread_t *rt_head       = NULL;
+my_thread_t *stride_head   = NULL;
 
 /* ====================== UTILIDADES COMUNES ====================== */
 /*
@@ -102,6 +103,10 @@ void rr_remove(my_thread_t *t) {
 
 void rr_yield_current(void) {
     my_thread_t *prev = current_thread;
+    /* El que cede pasa al final de la ronda; si no, el head nunca suelta la CPU */
+    if (rr_head && rr_head == prev) {
+        rr_head = rr_head->rr_next;
+    }
     my_thread_t *next = rr_pick_next();
     if (next && next != prev) {
         current_thread = next;
@@ -177,6 +182,135 @@ void lottery_yield_current(void) {
     }
 }
 
+/* ====================== STRIDE SCHEDULER ====================== */
+/*
+ * Reparto proporcional determinista: cada hilo avanza su pass en
+ * stride = STRIDE1 / tickets por quantum usado y siempre corre el de
+ * menor pass. Los hilos listos viven en un min-heap por pass, así que
+ * elegir es O(1) y cobrar el quantum, agregar o quitar es O(log n). A
+ * diferencia de Lottery, el desvío de cada hilo respecto de su parte
+ * ideal no crece con el largo de la ventana.
+ */
+#define STRIDE1 (1LL << 30)
+
+static my_thread_t **stride_heap = NULL;
+static int stride_count    = 0;     /* hilos en el heap (listos) */
+static int stride_capacity = 0;
+static int stride_threads  = 0;     /* hilos vivos en Stride, listos o bloqueados */
+static long long stride_global_pass = 0;  /* pass del último hilo elegido */
+
+static long long stride_of(int tickets) {
+    long long s = STRIDE1 / tickets;
+    return s > 0 ? s : 1;
+}
+
+/* Lugar para 'threads' hilos; se llama antes de crear o mover uno a Stride */
+static int stride_reserve(int threads) {
+    if (threads <= stride_capacity) return 0;
+    int cap = stride_capacity > 0 ? stride_capacity * 2 : 16;
+    while (cap < threads) cap *= 2;
+    my_thread_t **grown = realloc(stride_heap, sizeof(my_thread_t *) * cap);
+    if (!grown) return -1;
+    stride_heap     = grown;
+    stride_capacity = cap;
+    return 0;
+}
+
+static void stride_place(my_thread_t *t, int k) {
+    stride_heap[k] = t;
+    t->heap_index  = k;
+}
+
+static void stride_sift_up(int k) {
+    my_thread_t *t = stride_heap[k];
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (stride_heap[parent]->pass <= t->pass) break;
+        stride_place(stride_heap[parent], k);
+        k = parent;
+    }
+    stride_place(t, k);
+}
+
+static void stride_sift_down(int k) {
+    my_thread_t *t = stride_heap[k];
+    for (;;) {
+        int child = 2 * k + 1;
+        if (child >= stride_count) break;
+        if (child + 1 < stride_count &&
+            stride_heap[child + 1]->pass < stride_heap[child]->pass) {
+            child++;
+        }
+        if (t->pass <= stride_heap[child]->pass) break;
+        stride_place(stride_heap[child], k);
+        k = child;
+    }
+    stride_place(t, k);
+}
+
+void stride_init(void) {
+    free(stride_heap);
+    stride_heap        = NULL;
+    stride_count       = 0;
+    stride_capacity    = 0;
+    stride_threads     = 0;
+    stride_global_pass = 0;
+    stride_head        = NULL;
+}
+
+void stride_add(my_thread_t *t) {
+    if (!t || t->heap_index >= 0) return;
+    /* No falla: create y chsched reservan lugar para todos los hilos de Stride */
+    if (stride_reserve(stride_count + 1) != 0) return;
+
+    /* Un hilo nuevo o que vuelve de bloquearse no trae crédito acumulado */
+    if (t->pass < stride_global_pass) {
+        t->pass = stride_global_pass;
+    }
+    stride_place(t, stride_count++);
+    stride_sift_up(t->heap_index);
+    stride_head = stride_heap[0];
+}
+
+void stride_remove(my_thread_t *t) {
+    if (!t || t->heap_index < 0) return;
+
+    int k = t->heap_index;
+    t->heap_index = -1;
+    my_thread_t *last = stride_heap[--stride_count];
+    if (last != t) {
+        /* El último ocupa el hueco y se reacomoda hacia donde toque */
+        stride_place(last, k);
+        stride_sift_up(k);
+        stride_sift_down(last->heap_index);
+    }
+    stride_head = stride_count > 0 ? stride_heap[0] : NULL;
+}
+
+my_thread_t *stride_pick_next(void) {
+    if (stride_head) {
+        stride_global_pass = stride_head->pass;
+    }
+    return stride_head;
+}
+
+void stride_yield_current(void) {
+    my_thread_t *prev = current_thread;
+
+    /* Cobrar el quantum que acaba de usar */
+    if (prev->heap_index >= 0) {
+        prev->pass += prev->stride;
+        stride_sift_down(prev->heap_index);
+        stride_head = stride_heap[0];
+    }
+
+    my_thread_t *next = stride_pick_next();
+    if (next && next != prev) {
+        current_thread = next;
+        swapcontext(&prev->context, &next->context);
+    }
+}
+
 /* ====================== REAL-TIME SCHEDULER ====================== */
 void rt_init(void) {
     rt_head = NULL;
@@ -237,7 +371,11 @@ int my_thread_create(my_thread_t **thread,
     if (!thread || !start_routine) return -1;
     if (sched_type != SCHED_RR &&
         sched_type != SCHED_LOTTERY &&
-        sched_type != SCHED_RT) {
+        sched_type != SCHED_RT &&
+        sched_type != SCHED_STRIDE) {
+        return -1;
+    }
+    if (sched_type == SCHED_STRIDE && stride_reserve(stride_threads + 1) != 0) {
         return -1;
     }
 
@@ -262,9 +400,16 @@ int my_thread_create(my_thread_t **thread,
 
     /* Scheduler y campos auxiliares */
     (*thread)->sched_type = sched_type;
+    (*thread)->stride     = 0;
+    (*thread)->pass       = 0;
+    (*thread)->heap_index = -1;
     if (sched_type == SCHED_LOTTERY) {
         (*thread)->tickets     = (attr > 0 ? attr : 1);
         (*thread)->rt_priority = 0;
+    } else if (sched_type == SCHED_STRIDE) {
+        (*thread)->tickets     = (attr > 0 ? attr : 1);
+        (*thread)->rt_priority = 0;
+        (*thread)->stride      = stride_of((*thread)->tickets);
     } else if (sched_type == SCHED_RT) {
         (*thread)->rt_priority = (attr >= 0 ? attr : 0);
         (*thread)->tickets     = 0;
@@ -289,6 +434,9 @@ int my_thread_create(my_thread_t **thread,
         rr_add(*thread);
     } else if (sched_type == SCHED_LOTTERY) {
         lottery_add(*thread);
+    } else if (sched_type == SCHED_STRIDE) {
+        stride_threads++;
+        stride_add(*thread);
     } else {
         rt_add(*thread);
     }
@@ -303,13 +451,19 @@ int my_thread_chsched(my_thread_t *target,
     if (!target) return -1;
     if (new_sched != SCHED_RR &&
         new_sched != SCHED_LOTTERY &&
-        new_sched != SCHED_RT) {
+        new_sched != SCHED_RT &&
+        new_sched != SCHED_STRIDE) {
         return -1;
     }
     if (target == current_thread) {
         /* No permitimos cambiar el scheduler del hilo actual */
         return -1;
     }
+    /* Reservar el lugar en el heap antes de tocar nada, para fallar sin efectos */
+    if (new_sched == SCHED_STRIDE && target->sched_type != SCHED_STRIDE &&
+        stride_reserve(stride_threads + 1) != 0) {
+        return -1;
+    }
 
     /* 1) Remover de la lista actual */
     int old_sched = target->sched_type;
@@ -317,15 +471,24 @@ int my_thread_chsched(my_thread_t *target,
         rr_remove(target);
     } else if (old_sched == SCHED_LOTTERY) {
         lottery_remove(target);
+    } else if (old_sched == SCHED_STRIDE) {
+        stride_remove(target);
+        stride_threads--;
     } else {
         rt_remove(target);
     }
 
     /* 2) Ajustar campos según new_sched */
     target->sched_type = new_sched;
+    target->stride     = 0;
     if (new_sched == SCHED_LOTTERY) {
         target->tickets     = (new_attr > 0 ? new_attr : 1);
         target->rt_priority = 0;
+    } else if (new_sched == SCHED_STRIDE) {
+        /* Conserva su pass: stride_add solo lo sube al pass global */
+        target->tickets     = (new_attr > 0 ? new_attr : 1);
+        target->rt_priority = 0;
+        target->stride      = stride_of(target->tickets);
     } else if (new_sched == SCHED_RT) {
         target->rt_priority = (new_attr >= 0 ? new_attr : 0);
         target->tickets     = 0;
@@ -339,6 +502,9 @@ int my_thread_chsched(my_thread_t *target,
         rr_add(target);
     } else if (new_sched == SCHED_LOTTERY) {
         lottery_add(target);
+    } else if (new_sched == SCHED_STRIDE) {
+        stride_threads++;
+        stride_add(target);
     } else {
         rt_add(target);
     }
@@ -360,6 +526,9 @@ void my_thread_yield(void)
         case SCHED_RT:
             rt_yield_current();
             break;
+        case SCHED_STRIDE:
+            stride_yield_current();
+            break;
         default:
             rr_yield_current();
             break;
@@ -389,16 +558,20 @@ int my_thread_join(my_thread_t *target)
         rr_remove(current_thread);
     } else if (me_sched == SCHED_LOTTERY) {
         lottery_remove(current_thread);
+    } else if (me_sched == SCHED_STRIDE) {
+        stride_remove(current_thread);
     } else {
         rt_remove(current_thread);
     }
 
-    /* Elegir siguiente hilo listo: RR > Lottery > RT */
+    /* Elegir siguiente hilo listo: RR > Lottery > Stride > RT */
     my_thread_t *next = NULL;
     if (rr_head) {
         next = rr_pick_next();
     } else if (lottery_head) {
         next = lottery_pick_next();
+    } else if (stride_head) {
+        next = stride_pick_next();
     } else if (rt_head) {
         next = rt_pick_next();
     }
@@ -433,6 +606,9 @@ void my_thread_end(void)
         rr_remove(current_thread);
     } else if (me_sched == SCHED_LOTTERY) {
         lottery_remove(current_thread);
+    } else if (me_sched == SCHED_STRIDE) {
+        stride_remove(current_thread);
+        stride_threads--;
     } else {
         rt_remove(current_thread);
     }
@@ -447,6 +623,8 @@ void my_thread_end(void)
             rr_add(w);
         } else if (w->sched_type == SCHED_LOTTERY) {
             lottery_add(w);
+        } else if (w->sched_type == SCHED_STRIDE) {
+            stride_add(w);
         } else {
             rt_add(w);
         }
@@ -459,12 +637,14 @@ void my_thread_end(void)
         /* current_thread ya no es válido después de liberar */
     }
 
-    /* 4) Despachar siguiente hilo listo: RR > Lottery > RT */
+    /* 4) Despachar siguiente hilo listo: RR > Lottery > Stride > RT */
     my_thread_t *next = NULL;
     if (rr_head) {
         next = rr_pick_next();
     } else if (lottery_head) {
         next = lottery_pick_next();
+    } else if (stride_head) {
+        next = stride_pick_next();
     } else if (rt_head) {
         next = rt_pick_next();
     }
@@ -560,16 +740,20 @@ int my_mutex_lock(my_mutex_t *mutex) {
         rr_remove(current_thread);
     } else if (me_sched == SCHED_LOTTERY) {
         lottery_remove(current_thread);
+    } else if (me_sched == SCHED_STRIDE) {
+        stride_remove(current_thread);
     } else {
         rt_remove(current_thread);
     }
 
-    /* Eligir siguiente hilo listo: RR > Lottery > RT */
+    /* Eligir siguiente hilo listo: RR > Lottery > Stride > RT */
     my_thread_t *next = NULL;
     if (rr_head) {
         next = rr_pick_next();
     } else if (lottery_head) {
         next = lottery_pick_next();
+    } else if (stride_head) {
+        next = stride_pick_next();
     } else if (rt_head) {
         next = rt_pick_next();
     }
@@ -620,6 +804,8 @@ int my_mutex_unlock(my_mutex_t *mutex) {
             rr_add(w);
         } else if (w->sched_type == SCHED_LOTTERY) {
             lottery_add(w);
+        } else if (w->sched_type == SCHED_STRIDE) {
+            stride_add(w);
         } else {
             rt_add(w);
         }
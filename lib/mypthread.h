@@ -3,12 +3,19 @@
 
 #include <ucontext.h>
 
-#define STACK_SIZE 8192
+/*
+ * Pila de cada hilo. printf con flotantes (resumen de --stats, reportes
+ * al salir con exit desde el último hilo) y el handler de SIGALRM corren
+ * sobre ella; con 8 KB se desbordaba sobre el heap. Solo se tocan las
+ * páginas que se usan.
+ */
+#define STACK_SIZE (64 * 1024)
 
 /* --- Tipos de scheduler disponibles --- */
 #define SCHED_RR       0    // Round‐Robin
 #define SCHED_LOTTERY  1    // Lottery Scheduling
 #define SCHED_RT       2    // Real‐Time Scheduling
+#define SCHED_STRIDE   3    // Stride Scheduling
 
 typedef struct my_thread {
     ucontext_t context;
@@ -18,8 +25,11 @@ typedef struct my_thread {
     struct my_thread *waiting_list;   // hilos que esperan este
 
     int sched_type;
-    int tickets;          // solo para Lottery
+    int tickets;          // para Lottery y Stride
     int rt_priority;      // solo para RT
+    long long stride;     // solo para Stride: STRIDE1 / tickets
+    long long pass;       // solo para Stride: avanza stride por quantum usado
+    int heap_index;       // posición en el heap de Stride (-1 = fuera)
 
     struct my_thread *rr_next, *rr_prev;
     struct my_thread *lottery_next, *lottery_prev;
@@ -35,6 +45,7 @@ extern my_thread_t *main_thread;
 extern my_thread_t *rr_head;
 extern my_thread_t *lottery_head;
 extern my_thread_t *rt_head;
+extern my_thread_t *stride_head;      // el de menor pass (tope del heap)
 
 /* =============== Interfaz de hilos =============== */
 int my_thread_create(my_thread_t **thread,
@@ -110,6 +121,13 @@ my_thread_t *lottery_pick_next(void);
 void lottery_yield_current(void);
 void lottery_remove(my_thread_t *t);
 
+/* =============== Funciones Internas de Stride =============== */
+void stride_init(void);
+void stride_add(my_thread_t *t);
+my_thread_t *stride_pick_next(void);
+void stride_yield_current(void);
+void stride_remove(my_thread_t *t);
+
 /* =============== Funciones Internas de Real‐Time =============== */
 void rt_init(void);
 void rt_add(my_thread_t *t);
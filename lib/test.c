@@ -2,9 +2,10 @@
   test.c
 
   Programa de prueba ampliado para la biblioteca “mypthreads”.
-  - Crea hilos Round-Robin, Lottery y Real-Time; prueba join, detach y cambio de scheduler.
+  - Crea hilos Round-Robin, Lottery, Stride y Real-Time; prueba join, detach y cambio de scheduler.
   - Agrega pruebas de mutex: lock, unlock, trylock y comportamiento con varios hilos.
 ==============================================================================*/
+#define _DEFAULT_SOURCE          // usleep() ya no está en POSIX 2008
 #define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
@@ -57,6 +58,18 @@ void lot_func(void) {
     my_thread_end();
 }
 
+/* 2b) Hilo Stride: como Lottery, pero con reparto determinista */
+void stride_func(void) {
+    for (int i = 0; i < 5; i++) {
+        printf("[STR]  iteration %d (tickets=%d, pass=%lld)\n",
+               i, current_thread->tickets, current_thread->pass);
+        usleep(100000);
+        my_thread_yield();
+    }
+    printf("[STR]  ending\n");
+    my_thread_end();
+}
+
 /* 3) Hilo Real-Time de prioridad alta: imprime 5 iteraciones */
 void rt_high_func(void) {
     for (int i = 0; i < 5; i++) {
@@ -174,6 +187,7 @@ int main(void) {
     /* 1) Inicializar las listas vacías y semilla de rand */
     rr_init();
     lottery_init();
+    stride_init();
     rt_init();
     srand((unsigned) time(NULL));
 
@@ -220,6 +234,14 @@ int main(void) {
         exit(1);
     }
 
+    /* 2.4b) Dos hilos Stride (4 y 2 tickets): el primero corre el doble */
+    my_thread_t *stride_a, *stride_b;
+    if (my_thread_create(&stride_a, stride_func, SCHED_STRIDE, 4) != 0 ||
+        my_thread_create(&stride_b, stride_func, SCHED_STRIDE, 2) != 0) {
+        fprintf(stderr, "Error creando hilos Stride\n");
+        exit(1);
+    }
+
     /* 2.5) Hilos de ejemplo Real-Time: uno “alto” (p=5) y uno “bajo” (p=1) */
     my_thread_t *rt_h, *rt_l;
     if (my_thread_create(&rt_h, rt_high_func, SCHED_RT, 5) != 0) {
@@ -252,13 +274,16 @@ int main(void) {
     /* 3) Iniciar temporizador para preempción cada 100 ms */
     init_timer();
 
-    /* 4) Entregar el primer hilo listo: RR → Lottery → RT */
+    /* 4) Entregar el primer hilo listo: RR → Lottery → Stride → RT */
     if (rr_head) {
         current_thread = rr_head;
         setcontext(&rr_head->context);
     } else if (lottery_head) {
         current_thread = lottery_head;
         setcontext(&lottery_head->context);
+    } else if (stride_head) {
+        current_thread = stride_pick_next();
+        setcontext(&current_thread->context);
     } else if (rt_head) {
         current_thread = rt_head;
         setcontext(&rt_head->context);
@@ -1,29 +1,124 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "anim_stats.h"
 #include "config_parser.h"
+#include "animator.h"
+#include "animator_md.h"
 #include "animator_mt.h"
+#include "hot_reload.h"
+#include "scene.h"
 
 // Si luego usás mypthreads, incluí: #include "mypthread.h"
 
-int main() {
-    AnimationConfig *config = load_config("config.json");
+/*
+ * Al salir (también cuando mt termina con exit desde un hilo): memoria
+ * pico del proceso según /proc/self/status. VmHWM se reinicia en exec, a
+ * diferencia de ru_maxrss, así que bench_anim la usa para medir al motor
+ * y no al proceso que lo lanzó.
+ */
+static void report_peak_memory(void) {
+    FILE *f = fopen("/proc/self/status", "r");
+    if (!f) return;
+    char line[256];
+    long kb;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) {
+            fprintf(stderr, "[MEM] memoria pico %ld KB\n", kb);
+            break;
+        }
+    }
+    fclose(f);
+}
+
+/*
+ * Uso: test_anim [config.json] [--engine=seq|mt|md] [--load-threads=N] [--watch]
+ *                 [--stats[=archivo.csv|archivo.json]]
+ *   seq → animación secuencial (animator.c)
+ *   mt  → un hilo mypthread por figura (animator_mt.c)
+ *   md  → canvas repartido en displays, uno por proceso (animator_md.c)
+ * Sin --engine se usa md si la configuración define "displays", si no mt.
+ * --load-threads=N fija los hilos de la carga (0 = uno por procesador).
+ * --watch recarga las figuras al guardar el archivo, sin parar (seq y md).
+ * --stats mide cada frame (anim_stats.h): resumen móvil en stderr y
+ * volcado por frame al salir (por defecto anim_stats.csv).
+ */
+int main(int argc, char **argv) {
+    const char *path = "config.json";
+    const char *engine = NULL;
+    int watch = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--engine=", 9) == 0) {
+            engine = argv[i] + 9;
+        } else if (strncmp(argv[i], "--load-threads=", 15) == 0) {
+            config_set_load_threads(atoi(argv[i] + 15));
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            watch = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            anim_stats_enable(NULL);
+        } else if (strncmp(argv[i], "--stats=", 8) == 0) {
+            anim_stats_enable(argv[i] + 8);
+        } else {
+            path = argv[i];
+        }
+    }
+
+    atexit(report_peak_memory);
+    AnimationConfig *config = load_config(path);
     if (!config) {
         fprintf(stderr, "Error cargando la configuración\n");
         return 1;
     }
-
-    // Animación secuencial
-    // simulate_animation(config);
-
-    // ⚠️ Aquí iría el despiegue multi-hilo con mypthreads en la Etapa 3
-    // simulate_animation_multithread(config); ← futuro
+    if (!engine) engine = config->displays.rows > 0 ? "md" : "mt";
 
     printf("Configuración cargada correctamente:\n");
     printf("Canvas: %d x %d\n", config->canvas.width, config->canvas.height);
+    if (config->num_viewports > 0) {
+        printf("Mundo: %d x %d | %d viewports\n", config->world.width, config->world.height,
+               config->num_viewports);
+    }
     printf("Figuras: %d\n", config->num_figures);
+    printf("Sprites: %d distintos (%d bytes de atlas)\n",
+           config->scene->sprites.num_sprites, config->scene->atlas_size);
 
-    simulate_animation_multithread(config);
+    if (watch) {
+        // Los hilos por figura de mt no se pueden rehacer a mitad de la animación
+        if (strcmp(engine, "mt") == 0) {
+            fprintf(stderr, "--watch solo funciona con los motores seq y md\n");
+        } else {
+            config->reload = hot_reload_start(config, path);
+        }
+    }
+
+    // Los hilos de mt avanzan cada figura por su cuenta: no hay un tick común donde probar pares
+    if (config->collisions && strcmp(engine, "mt") == 0) {
+        fprintf(stderr, "\"collisions\" solo funciona con los motores seq y md\n");
+    }
+
+    // Cada hilo de mt pinta su figura directo en el canvas, en coordenadas del mundo
+    if (config->num_viewports > 0 && strcmp(engine, "mt") == 0) {
+        fprintf(stderr, "\"viewports\" solo funciona con los motores seq y md\n");
+    }
+
+    if (strcmp(engine, "seq") == 0) {
+        simulate_animation(config);
+    } else if (strcmp(engine, "md") == 0) {
+        if (config->displays.rows == 0) {
+            // Sin "displays" en la configuración: un único display a stdout
+            config->displays.rows = config->displays.cols = 1;
+            snprintf(config->displays.sink, sizeof(config->displays.sink), "/dev/stdout");
+        }
+        simulate_animation_multidisplay(config);
+    } else if (strcmp(engine, "mt") == 0) {
+        simulate_animation_multithread(config);
+    } else {
+        fprintf(stderr, "Motor desconocido: %s (seq, mt o md)\n", engine);
+        hot_reload_stop(config->reload);
+        free_config(config);
+        return 1;
+    }
 
+    hot_reload_stop(config->reload);
     free_config(config);
     return 0;
-}
\ No newline at end of file
+}
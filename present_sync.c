@@ -0,0 +1,150 @@
+#define _GNU_SOURCE
+
+#include "present_sync.h"
+#include <string.h>
+#include <sys/mman.h>
+#include "frame_clock.h"
+#include "shm_ring.h"
+
+int present_sync_init(PresentSync *ps, int count, int timeout_ms) {
+    memset(ps, 0, sizeof(*ps));
+    if (count < 1 || count > PRESENT_SYNC_MAX_DISPLAYS) return -1;
+    void *map = mmap(NULL, sizeof(PresentSyncShared), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) return -1;
+    ps->shared = map;
+    memset(ps->shared, 0, sizeof(PresentSyncShared));
+    ps->shared->count = count;
+    ps->timeout_ms = timeout_ms >= 0 ? timeout_ms : PRESENT_SYNC_DEFAULT_TIMEOUT_MS;
+    return 0;
+}
+
+void present_sync_free(PresentSync *ps) {
+    if (ps->shared) munmap(ps->shared, sizeof(PresentSyncShared));
+    ps->shared = NULL;
+}
+
+// Diferencia entre el primer y el último display que presentaron frame
+static void measure_skew(PresentSync *ps, uint64_t frame) {
+    PresentSyncShared *s = ps->shared;
+    long long first = 0, last = 0;
+    int n = 0;
+    for (uint32_t k = 0; k < s->count; k++) {
+        if (__atomic_load_n(&s->presented[k], __ATOMIC_ACQUIRE) != frame) continue;
+        long long t = __atomic_load_n(&s->present_ns[k], __ATOMIC_RELAXED);
+        if (n == 0 || t < first) first = t;
+        if (n == 0 || t > last) last = t;
+        n++;
+    }
+    if (n < 2) return;
+    long long skew = last - first;
+    ps->skew_samples++;
+    ps->skew_sum_ns += skew;
+    if (skew > ps->skew_max_ns) ps->skew_max_ns = skew;
+}
+
+// Displays al día (listos al menos para el frame anterior) que todavía no avisaron frame
+static int pending_displays(const PresentSyncShared *s, uint64_t prev, uint64_t frame,
+                            int *behind) {
+    int pending = 0;
+    *behind = 0;
+    for (uint32_t k = 0; k < s->count; k++) {
+        uint64_t ready = __atomic_load_n(&s->ready[k], __ATOMIC_ACQUIRE);
+        if (ready >= frame) continue;
+        if (ready < prev) {
+            (*behind)++;
+        } else {
+            pending++;
+        }
+    }
+    return pending;
+}
+
+void present_sync_release(PresentSync *ps, uint64_t frame) {
+    PresentSyncShared *s = ps->shared;
+    uint64_t prev = s->go;
+    long long start = frame_clock_now_ns();
+    long long deadline = start + (long long)ps->timeout_ms * 1000000LL;
+    int behind;
+
+    for (;;) {
+        uint32_t word = __atomic_load_n(&s->ready_futex, __ATOMIC_ACQUIRE);
+        int pending = pending_displays(s, prev, frame, &behind);
+        if (pending == 0) break;
+        long long left = deadline - frame_clock_now_ns();
+        if (left <= 0) {
+            ps->timeouts++;
+            behind += pending;
+            break;
+        }
+        shm_futex_wait(&s->ready_futex, word, (int)(left / 1000000LL) + 1);
+    }
+
+    long long waited = frame_clock_now_ns() - start;
+    ps->wait_sum_ns += waited;
+    if (waited > ps->wait_max_ns) ps->wait_max_ns = waited;
+    ps->late += behind;
+    ps->frames++;
+
+    // Los displays listos para frame ya presentaron el anterior
+    if (prev > 0) measure_skew(ps, prev);
+
+    __atomic_store_n(&s->go, frame, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&s->go_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&s->go_futex);
+}
+
+void present_sync_finish(PresentSync *ps) {
+    PresentSyncShared *s = ps->shared;
+    if (!s) return;
+    uint64_t last = s->go;
+
+    // Dar a los displays al día la oportunidad de presentar el último frame
+    long long deadline = frame_clock_now_ns() + (long long)ps->timeout_ms * 1000000LL;
+    while (last > 0 && frame_clock_now_ns() < deadline) {
+        int done = 1;
+        for (uint32_t k = 0; k < s->count; k++) {
+            if (__atomic_load_n(&s->ready[k], __ATOMIC_ACQUIRE) >= last &&
+                __atomic_load_n(&s->presented[k], __ATOMIC_ACQUIRE) < last) {
+                done = 0;
+            }
+        }
+        if (done) break;
+        uint32_t word = __atomic_load_n(&s->ready_futex, __ATOMIC_ACQUIRE);
+        shm_futex_wait(&s->ready_futex, word, 1);
+    }
+    if (last > 0) measure_skew(ps, last);
+
+    __atomic_store_n(&s->go, UINT64_MAX, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&s->go_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&s->go_futex);
+}
+
+void present_sync_report(const PresentSync *ps, FILE *out) {
+    fprintf(out, "[PRESENT SYNC] %ld frames | skew medio %.1f us, máximo %.1f us "
+            "(%ld mediciones) | %ld timeouts, %ld presentaciones atrasadas | "
+            "espera media %.1f us, máxima %.1f us\n",
+            ps->frames,
+            ps->skew_samples ? ps->skew_sum_ns / 1e3 / ps->skew_samples : 0.0,
+            ps->skew_max_ns / 1e3, ps->skew_samples, ps->timeouts, ps->late,
+            ps->frames ? ps->wait_sum_ns / 1e3 / ps->frames : 0.0, ps->wait_max_ns / 1e3);
+}
+
+void present_sync_ready(PresentSyncShared *s, int k, uint64_t frame) {
+    __atomic_store_n(&s->ready[k], frame, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&s->ready_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&s->ready_futex);
+
+    for (;;) {
+        uint32_t word = __atomic_load_n(&s->go_futex, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s->go, __ATOMIC_ACQUIRE) >= frame) return;
+        shm_futex_wait(&s->go_futex, word, -1);
+    }
+}
+
+void present_sync_presented(PresentSyncShared *s, int k, uint64_t frame) {
+    __atomic_store_n(&s->present_ns[k], frame_clock_now_ns(), __ATOMIC_RELAXED);
+    __atomic_store_n(&s->presented[k], frame, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&s->ready_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&s->ready_futex);
+}
@@ -0,0 +1,63 @@
+#ifndef PRESENT_SYNC_H
+#define PRESENT_SYNC_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define PRESENT_SYNC_MAX_DISPLAYS 64
+
+// Espera por defecto del coordinador por un display antes de presentar sin él
+#define PRESENT_SYNC_DEFAULT_TIMEOUT_MS 50
+
+/*
+ * Barrera de presentación entre procesos de display, en memoria
+ * compartida (mmap anónimo heredado por fork). Cada display prepara el
+ * frame N, avisa que está listo y espera la orden de presentar; el
+ * renderizador libera N cuando todos avisaron o se cumple el timeout. Un
+ * display que ya venía atrasado no se espera hasta que se ponga al día,
+ * así que un rezagado nunca frena al grupo más de un timeout.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t ready_futex;                          // cambia cuando un display avisa
+    uint32_t go_futex;                             // cambia con cada liberación
+    uint32_t pad;
+    uint64_t go;                                   // último frame liberado
+    uint64_t ready[PRESENT_SYNC_MAX_DISPLAYS];     // último frame listo por display
+    uint64_t presented[PRESENT_SYNC_MAX_DISPLAYS]; // último frame presentado
+    int64_t present_ns[PRESENT_SYNC_MAX_DISPLAYS]; // cuándo lo presentó (CLOCK_MONOTONIC)
+} PresentSyncShared;
+
+typedef struct {
+    PresentSyncShared *shared;
+    int timeout_ms;
+
+    // Estadísticas del coordinador
+    long frames, timeouts, late;                   // late: displays no esperados o vencidos
+    long skew_samples;
+    long long skew_sum_ns, skew_max_ns;
+    long long wait_sum_ns, wait_max_ns;
+} PresentSync;
+
+// Reserva la zona compartida; llamar antes de lanzar los displays. Retorna 0 o -1.
+int present_sync_init(PresentSync *ps, int count, int timeout_ms);
+void present_sync_free(PresentSync *ps);
+
+/*
+ * Coordinador: espera que los displays al día estén listos para frame
+ * (hasta el timeout), mide el skew del frame anterior y libera frame.
+ */
+void present_sync_release(PresentSync *ps, uint64_t frame);
+
+// Coordinador: mide el último frame y libera a todos los que esperan
+void present_sync_finish(PresentSync *ps);
+
+void present_sync_report(const PresentSync *ps, FILE *out);
+
+// Display k: frame listo; bloquea hasta que el coordinador lo libere
+void present_sync_ready(PresentSyncShared *s, int k, uint64_t frame);
+
+// Display k: frame ya escrito en su destino
+void present_sync_presented(PresentSyncShared *s, int k, uint64_t frame);
+
+#endif // PRESENT_SYNC_H
@@ -0,0 +1,239 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "recording.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "collision.h"
+#include "frame_clock.h"
+#include "frame_encoder.h"
+#include "render.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+#include "viewport.h"
+
+/*
+ * Con "collisions" el frame t depende de los anteriores (stop y bounce
+ * cambian cómo sigue cada figura), así que render_frame no alcanza: se
+ * recorre la animación como en animator.c, con el cursor de trayectorias,
+ * la rejilla y los choques de cada tick.
+ */
+typedef struct {
+    TrajectoryState traj;
+    SpatialGrid grid;
+    CollisionSystem *collisions;
+    int *visible;
+    int max_figures;
+} CollisionWalk;
+
+static void walk_free(CollisionWalk *w) {
+    collision_free(w->collisions);
+    trajectory_state_free(&w->traj);
+    grid_free(&w->grid);
+    free(w->visible);
+    memset(w, 0, sizeof(*w));
+}
+
+static int walk_init(CollisionWalk *w, const AnimationConfig *config) {
+    memset(w, 0, sizeof(*w));
+    w->max_figures = config->scene->num_figures > 0 ? config->scene->num_figures : 1;
+    w->visible = malloc(sizeof(int) * w->max_figures);
+    if (!w->visible ||
+        grid_init(&w->grid, config->world.width, config->world.height, GRID_CELL_SIZE,
+                  w->max_figures) != 0 ||
+        trajectory_state_init(&w->traj, config->trajectory, 0) != 0 ||
+        !(w->collisions = collision_create(config))) {
+        walk_free(w);
+        return -1;
+    }
+    return 0;
+}
+
+// Pinta en out (limpio) el tick t y deja el cursor en el siguiente
+static void walk_render(CollisionWalk *w, const AnimationConfig *config, int t, char *out) {
+    if (w->traj.t != t) collision_seek(w->collisions, config, &w->grid, &w->traj, t);
+    grid_build(&w->grid, config, &w->traj);
+    collision_detect(w->collisions, config, &w->grid, &w->traj);
+
+    int width = config->canvas.width, height = config->canvas.height;
+    FrameBuffer fb = {out, width, height, width, NULL};
+    memset(out, ' ', (size_t)width * height);
+    viewport_paint(config, &w->grid, &w->traj, (Rect){0, 0, width, height}, &fb, w->visible,
+                   w->max_figures, NULL);
+
+    trajectory_step(&w->traj);
+    collision_apply(w->collisions, &w->traj);
+}
+
+int recording_write(const AnimationConfig *config, const char *path, int keyframe_interval,
+                    RecordingHeader *header) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror("No se pudo crear la grabación");
+        return -1;
+    }
+
+    int width = config->canvas.width, height = config->canvas.height;
+    size_t frame_size = (size_t)width * height;
+    int num_frames = render_max_time(config) + 1;
+    if (config->scene->colored) {
+        fprintf(stderr, "La grabación (.mdar) es monocroma: se descarta el color de la escena\n");
+    }
+
+    RecordingHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RECORDING_MAGIC, sizeof(h.magic));
+    h.version = RECORDING_VERSION;
+    h.width = width;
+    h.height = height;
+    h.fps = config->fps > 0 ? config->fps : 0;
+    h.num_frames = num_frames;
+    h.keyframe_interval = keyframe_interval > 0 ? keyframe_interval : RECORDING_DEFAULT_KEYFRAME_INTERVAL;
+
+    RecordingIndexEntry *index = calloc(num_frames, sizeof(RecordingIndexEntry));
+    char *prev = malloc(frame_size);
+    char *cur = malloc(frame_size);
+    ByteBuffer enc;
+    bytebuf_init(&enc);
+    CollisionWalk walk;
+    int ok = index && prev && cur;
+    int walking = ok && config->collisions != COLLISION_NONE;
+    if (walking && walk_init(&walk, config) != 0) walking = ok = 0;
+    ok = ok && fwrite(&h, sizeof(h), 1, f) == 1;
+
+    uint64_t offset = sizeof(h);
+    for (int t = 0; ok && t < num_frames; t++) {
+        if (walking) walk_render(&walk, config, t, cur);
+        else render_frame(config, t, cur, NULL);
+
+        // Tamaño de la repintada completa, para medir la compresión
+        bytebuf_reset(&enc);
+        encode_full_frame(cur, width, height, &enc);
+        h.raw_bytes += enc.len;
+
+        int key = (t % h.keyframe_interval) == 0;
+        if (!key) {
+            bytebuf_reset(&enc);
+            encode_delta_frame(prev, cur, width, height, &enc);
+        }
+
+        index[t].offset = offset;
+        index[t].length = (uint32_t)enc.len;
+        index[t].flags = key ? RECORDING_KEYFRAME : 0;
+        ok = fwrite(enc.data, 1, enc.len, f) == enc.len;
+        offset += enc.len;
+
+        char *tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    h.data_bytes = offset - sizeof(h);
+
+    // El índice va alineado a 8 bytes para leerlo en el mapeo
+    static const char zeros[8] = {0};
+    size_t pad = (8 - offset % 8) % 8;
+    ok = ok && fwrite(zeros, 1, pad, f) == pad;
+    h.index_offset = offset + pad;
+    ok = ok && fwrite(index, sizeof(RecordingIndexEntry), num_frames, f) == (size_t)num_frames;
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+
+    if (walking) walk_free(&walk);
+    free(index);
+    free(prev);
+    free(cur);
+    bytebuf_free(&enc);
+    if (!ok) {
+        fprintf(stderr, "Error escribiendo la grabación %s\n", path);
+        return -1;
+    }
+    if (header) *header = h;
+    return 0;
+}
+
+int recording_open(Recording *rec, const char *path) {
+    memset(rec, 0, sizeof(*rec));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("No se pudo abrir la grabación");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RecordingHeader)) {
+        fprintf(stderr, "Grabación inválida: %s\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    rec->map = map;
+    rec->map_size = st.st_size;
+    rec->header = map;
+
+    // Rangos por resta: los offsets vienen del disco y una suma puede dar la vuelta
+    const RecordingHeader *h = rec->header;
+    if (memcmp(h->magic, RECORDING_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != RECORDING_VERSION || h->index_offset < sizeof(RecordingHeader) ||
+        h->index_offset > rec->map_size || h->index_offset % sizeof(uint64_t) != 0 ||
+        h->num_frames > (rec->map_size - h->index_offset) / sizeof(RecordingIndexEntry)) {
+        fprintf(stderr, "Grabación inválida o de otra versión: %s\n", path);
+        recording_close(rec);
+        return -1;
+    }
+    rec->index = (const RecordingIndexEntry *)((const char *)map + h->index_offset);
+    for (uint32_t n = 0; n < h->num_frames; n++) {
+        const RecordingIndexEntry *e = &rec->index[n];
+        if (e->offset < sizeof(RecordingHeader) || e->length > h->index_offset ||
+            e->offset > h->index_offset - e->length) {
+            fprintf(stderr, "Índice corrupto en el frame %u: %s\n", n, path);
+            recording_close(rec);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void recording_close(Recording *rec) {
+    if (rec->map) munmap(rec->map, rec->map_size);
+    memset(rec, 0, sizeof(*rec));
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+long long recording_play(const Recording *rec, int fd, int fps) {
+    if (fps < 0) fps = rec->header->fps;
+    FrameClock clock;
+    frame_clock_init(&clock, fps, FRAME_POLICY_CATCH_UP);
+
+    long long written = 0;
+    for (uint32_t n = 0; n < rec->header->num_frames; n++) {
+        if (n > 0) frame_clock_wait_for(&clock, n);
+        size_t len;
+        const char *data = recording_frame(rec, n, &len);
+        if (write_all(fd, data, len) != 0) return -1;
+        written += len;
+    }
+    return written;
+}
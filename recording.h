@@ -0,0 +1,80 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "anim_config.h"
+
+/*
+ * Formato de animación grabada (.mdar), little-endian:
+ *
+ *   RecordingHeader
+ *   datos de frames: bytes listos para escribir a la terminal
+ *   índice: num_frames * RecordingIndexEntry
+ *
+ * Los keyframes son la repintada completa (encode_full_frame); los demás
+ * frames son el delta contra el anterior (encode_delta_frame). El player
+ * solo mapea el archivo y escribe rangos: no parsea ni rasteriza.
+ */
+#define RECORDING_MAGIC   "MDAREC\r\n"
+#define RECORDING_VERSION 1
+#define RECORDING_KEYFRAME 0x1u
+
+#define RECORDING_DEFAULT_KEYFRAME_INTERVAL 100
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t fps;
+    uint32_t num_frames;
+    uint32_t keyframe_interval;
+    uint64_t index_offset;           // desde el inicio del archivo
+    uint64_t data_bytes;             // bytes de frames grabados
+    uint64_t raw_bytes;              // lo que ocuparían todos como repintada completa
+} RecordingHeader;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t flags;                  // RECORDING_KEYFRAME
+} RecordingIndexEntry;
+
+// Grabación abierta con mmap (solo lectura)
+typedef struct {
+    void *map;
+    size_t map_size;
+    const RecordingHeader *header;
+    const RecordingIndexEntry *index;
+} Recording;
+
+/*
+ * Rasteriza toda la animación y la guarda en path con un keyframe cada
+ * keyframe_interval frames (<= 0 usa el valor por defecto). Con
+ * "collisions" recorre los ticks en orden aplicando los choques, como el
+ * motor secuencial. El formato no lleva atributos: una escena con color
+ * se graba monocroma (con un aviso en stderr). Si header no es NULL, deja
+ * ahí el encabezado escrito. Retorna 0 o -1.
+ */
+int recording_write(const AnimationConfig *config, const char *path, int keyframe_interval,
+                    RecordingHeader *header);
+
+// Mapea y valida el archivo. Retorna 0 o -1.
+int recording_open(Recording *rec, const char *path);
+void recording_close(Recording *rec);
+
+// Bytes del frame n dentro del mapeo
+static inline const char *recording_frame(const Recording *rec, int n, size_t *len) {
+    *len = rec->index[n].length;
+    return (const char *)rec->map + rec->index[n].offset;
+}
+
+/*
+ * Escribe todos los frames en fd. fps < 0 usa el del archivo, 0 = sin
+ * pausa. Como los deltas dependen del frame anterior, nunca se saltan
+ * frames: si va atrasado se escriben seguidos hasta ponerse al día.
+ * Retorna los bytes escritos o -1.
+ */
+long long recording_play(const Recording *rec, int fd, int fps);
+
+#endif // RECORDING_H
@@ -0,0 +1,235 @@
+#include "render.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "collision.h"
+#include "trajectory.h"
+#include "viewport.h"
+
+#define SEEKER_DEFAULT_INTERVAL 64
+
+int render_blit_kernels = 1;
+
+/*
+ * Kernels de blit por ancho de sprite, generados con el preprocesador:
+ * BLIT_KERNEL(W) define el kernel de ancho W con la fila desenrollada
+ * celda por celda, así que los desplazamientos dentro de la fila y el
+ * paso entre filas del glifo (W + 1) son constantes. Copian el glifo
+ * entero, sin recorte; blit los usa solo cuando la figura cae completa
+ * dentro del buffer. Hay una versión con plano de atributos y otra sin él.
+ */
+typedef int (*BlitKernel)(const char *src, int rows, char *dst, unsigned char *dst_attr,
+                          int stride, unsigned char attr);
+
+#define UNROLL_1(M) M(0)
+#define UNROLL_2(M) UNROLL_1(M) M(1)
+#define UNROLL_3(M) UNROLL_2(M) M(2)
+#define UNROLL_4(M) UNROLL_3(M) M(3)
+#define UNROLL_5(M) UNROLL_4(M) M(4)
+#define UNROLL_6(M) UNROLL_5(M) M(5)
+#define UNROLL_7(M) UNROLL_6(M) M(6)
+#define UNROLL_8(M) UNROLL_7(M) M(7)
+#define UNROLL_9(M) UNROLL_8(M) M(8)
+#define UNROLL_10(M) UNROLL_9(M) M(9)
+#define UNROLL_11(M) UNROLL_10(M) M(10)
+#define UNROLL_12(M) UNROLL_11(M) M(11)
+#define UNROLL_13(M) UNROLL_12(M) M(12)
+#define UNROLL_14(M) UNROLL_13(M) M(13)
+#define UNROLL_15(M) UNROLL_14(M) M(14)
+#define UNROLL_16(M) UNROLL_15(M) M(15)
+
+// Anchos con kernel propio (más anchos caen al bucle genérico)
+#define BLIT_WIDTHS(X) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) \
+                       X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16)
+#define BLIT_MAX_KERNEL_WIDTH 16
+
+// Una celda del glifo; los espacios son transparentes
+#define BLIT_CELL(c) \
+    if (src[c] != ' ') { dst[c] = src[c]; painted++; }
+#define BLIT_CELL_ATTR(c) \
+    if (src[c] != ' ') { dst[c] = src[c]; dst_attr[c] = attr; painted++; }
+
+#define BLIT_KERNEL(W) \
+    static int blit_w##W(const char *src, int rows, char *dst, unsigned char *dst_attr, \
+                         int stride, unsigned char attr) { \
+        (void)dst_attr; \
+        (void)attr; \
+        int painted = 0; \
+        for (int r = 0; r < rows; r++, src += (W) + 1, dst += stride) { \
+            UNROLL_##W(BLIT_CELL) \
+        } \
+        return painted; \
+    } \
+    static int blit_attr_w##W(const char *src, int rows, char *dst, unsigned char *dst_attr, \
+                              int stride, unsigned char attr) { \
+        int painted = 0; \
+        for (int r = 0; r < rows; r++, src += (W) + 1, dst += stride, dst_attr += stride) { \
+            UNROLL_##W(BLIT_CELL_ATTR) \
+        } \
+        return painted; \
+    }
+
+BLIT_WIDTHS(BLIT_KERNEL)
+
+#define KERNEL_ENTRY(W) blit_w##W,
+#define KERNEL_ATTR_ENTRY(W) blit_attr_w##W,
+
+// Indexadas por ancho; la entrada 0 no se usa
+static const BlitKernel blit_kernels[BLIT_MAX_KERNEL_WIDTH + 1] = {NULL, BLIT_WIDTHS(KERNEL_ENTRY)};
+static const BlitKernel blit_attr_kernels[BLIT_MAX_KERNEL_WIDTH + 1] = {
+    NULL, BLIT_WIDTHS(KERNEL_ATTR_ENTRY)
+};
+
+/*
+ * Cuerpo común de render_blit y render_blit_counted. Retorna las celdas
+ * pintadas; con changed != NULL suma ahí las que cambiaron de valor. Al
+ * expandirse con changed == NULL y sin usar el retorno, no cuenta nada.
+ */
+static inline int blit(const Scene *scene, int i, int t, Position pos, FrameBuffer *fb,
+                       int *changed) {
+    const char *shape = scene_glyph(scene, i, scene_rotation_at(scene, i, t));
+    if (!shape) return 0;  // puede que no exista esa rotación
+
+    int rows = scene->rows[i], cols = scene->cols[i];
+    unsigned char attr = (unsigned char)scene->attr[i];
+
+    // Glifo completo dentro del buffer y con un ancho común: kernel de ancho fijo
+    if (!changed && render_blit_kernels && cols > 0 && cols <= BLIT_MAX_KERNEL_WIDTH &&
+        pos.x >= 0 && pos.y >= 0 && pos.x + cols <= fb->width && pos.y + rows <= fb->height) {
+        size_t at = (size_t)pos.y * fb->stride + pos.x;
+        if (fb->attrs) {
+            return blit_attr_kernels[cols](shape, rows, fb->cells + at, fb->attrs + at, fb->stride, attr);
+        }
+        return blit_kernels[cols](shape, rows, fb->cells + at, NULL, fb->stride, attr);
+    }
+
+    // Recorte una sola vez por figura en lugar de por celda
+    int r0 = pos.y < 0 ? -pos.y : 0;
+    int c0 = pos.x < 0 ? -pos.x : 0;
+    int r1 = fb->height - pos.y < rows ? fb->height - pos.y : rows;
+    int c1 = fb->width - pos.x < cols ? fb->width - pos.x : cols;
+
+    // El atributo acompaña a cada carácter pintado (solo si hay plano)
+    int painted = 0;
+    for (int r = r0; r < r1; r++) {
+        const char *row = shape + r * (cols + 1);
+        char *dst = fb->cells + (pos.y + r) * fb->stride;
+        unsigned char *dst_attr = fb->attrs ? fb->attrs + (pos.y + r) * fb->stride : NULL;
+        for (int c = c0; c < c1; c++) {
+            if (row[c] != ' ') {
+                if (changed) *changed += dst[pos.x + c] != row[c];
+                dst[pos.x + c] = row[c];
+                if (dst_attr) dst_attr[pos.x + c] = attr;
+                painted++;
+            }
+        }
+    }
+    return painted;
+}
+
+int render_blit(const Scene *scene, int i, int t, Position pos, FrameBuffer *fb) {
+    return blit(scene, i, t, pos, fb, NULL);
+}
+
+int render_blit_counted(const Scene *scene, int i, int t, Position pos, FrameBuffer *fb,
+                        int *changed) {
+    *changed = 0;
+    return blit(scene, i, t, pos, fb, changed);
+}
+
+void render_paint(const AnimationConfig *config, int t, char *out, unsigned char *attrs) {
+    FrameBuffer fb = {out, config->canvas.width, config->canvas.height, config->canvas.width, attrs};
+    viewport_paint_direct(config, t, &fb);  // cada cámara descarta lo que no ve
+}
+
+void render_frame(const AnimationConfig *config, int t, char *out, unsigned char *attrs) {
+    size_t cells = (size_t)config->canvas.width * config->canvas.height;
+    memset(out, ' ', cells);
+    if (attrs) memset(attrs, 0, cells);
+    render_paint(config, t, out, attrs);
+}
+
+int render_max_time(const AnimationConfig *config) {
+    const Scene *scene = config->scene;
+    int max_time = 0;
+    for (int i = 0; i < scene->num_figures; i++) {
+        if (scene->t_end[i] > max_time) max_time = scene->t_end[i];
+    }
+    return max_time;
+}
+
+int frame_seeker_init(FrameSeeker *s, const AnimationConfig *config, RenderMode mode, long budget_bytes) {
+    memset(s, 0, sizeof(*s));
+    if (config->collisions != COLLISION_NONE) {
+        fprintf(stderr, "El acceso aleatorio a frames no admite \"collisions\" (%s)\n",
+                collision_policy_name(config->collisions));
+        return -1;
+    }
+    s->config = config;
+    s->mode = mode;
+    s->max_time = render_max_time(config);
+    if (mode == RENDER_CLEAR) return 0;
+
+    int colored = config->scene->colored;
+    long frame_size = (long)config->canvas.width * config->canvas.height;
+    int frames = s->max_time + 1;
+    s->interval = SEEKER_DEFAULT_INTERVAL;
+    if (budget_bytes > 0) {
+        // El intervalo más corto cuyos snapshots caben en el presupuesto
+        long max_snaps = budget_bytes / (colored ? 2 * frame_size : frame_size);
+        if (max_snaps < 1) max_snaps = 1;
+        s->interval = (int)((frames + max_snaps - 1) / max_snaps);
+        if (s->interval < 1) s->interval = 1;
+    }
+    s->num_snapshots = (frames + s->interval - 1) / s->interval;
+    s->snapshots = malloc((size_t)s->num_snapshots * frame_size);
+    if (colored) s->snapshot_attrs = malloc((size_t)s->num_snapshots * frame_size);
+    char *canvas = malloc(frame_size);
+    unsigned char *attrs = colored ? calloc(frame_size, 1) : NULL;
+    if (!s->snapshots || (colored && (!s->snapshot_attrs || !attrs)) || !canvas) {
+        free(canvas);
+        free(attrs);
+        frame_seeker_free(s);
+        return -1;
+    }
+
+    // Un único recorrido: guardar el canvas antes de cada frame k * interval
+    memset(canvas, ' ', frame_size);
+    for (int t = 0; t <= s->max_time; t++) {
+        if (t % s->interval == 0) {
+            size_t at = (size_t)(t / s->interval) * frame_size;
+            memcpy(s->snapshots + at, canvas, frame_size);
+            if (attrs) memcpy(s->snapshot_attrs + at, attrs, frame_size);
+        }
+        render_paint(config, t, canvas, attrs);
+    }
+    free(canvas);
+    free(attrs);
+    return 0;
+}
+
+void frame_seeker_render(const FrameSeeker *s, int t, char *out, unsigned char *attrs) {
+    if (s->mode == RENDER_CLEAR) {
+        render_frame(s->config, t, out, attrs);
+        return;
+    }
+
+    if (t < 0) t = 0;
+    if (t > s->max_time) t = s->max_time;
+    long frame_size = (long)s->config->canvas.width * s->config->canvas.height;
+    size_t at = (size_t)(t / s->interval) * frame_size;
+    memcpy(out, s->snapshots + at, frame_size);
+    if (attrs) {
+        if (s->snapshot_attrs) memcpy(attrs, s->snapshot_attrs + at, frame_size);
+        else memset(attrs, 0, frame_size);
+    }
+    for (int f = t - t % s->interval; f <= t; f++) {
+        render_paint(s->config, f, out, attrs);
+    }
+}
+
+void frame_seeker_free(FrameSeeker *s) {
+    free(s->snapshots);
+    free(s->snapshot_attrs);
+    memset(s, 0, sizeof(*s));
+}
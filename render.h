@@ -0,0 +1,84 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "anim_config.h"
+#include "scene.h"
+
+// Región de caracteres donde se pinta (stride = bytes entre filas)
+typedef struct {
+    char *cells;
+    int width, height;
+    int stride;
+    unsigned char *attrs;    // plano de atributos con el mismo stride (NULL = monocromo)
+} FrameBuffer;
+
+/*
+ * Copia el glifo de la figura i que corresponde al tick t con la esquina
+ * superior izquierda en pos, recortando al buffer. Los espacios son
+ * transparentes. No hace nada si la rotación no existe. Retorna las
+ * celdas pintadas. Los glifos de hasta 16 columnas que caben enteros se
+ * copian con un kernel desenrollado para su ancho (render.c).
+ */
+int render_blit(const Scene *scene, int i, int t, Position pos, FrameBuffer *fb);
+
+// 0 = siempre el bucle genérico, sin kernels por ancho (para comparar en bench_blit)
+extern int render_blit_kernels;
+
+// Igual, para --stats: retorna las celdas pintadas y deja en *changed las que cambiaron
+int render_blit_counted(const Scene *scene, int i, int t, Position pos, FrameBuffer *fb,
+                        int *changed);
+
+/*
+ * Calcula el frame t directamente desde la escena: limpia out
+ * (width * height bytes, por filas) y pinta las figuras activas en orden.
+ * attrs es el plano de atributos de out (NULL = monocromo). Es pura y
+ * reentrante: no guarda estado entre llamadas, así que no aplica
+ * "collisions" (stop y bounce dependen de los ticks anteriores).
+ */
+void render_frame(const AnimationConfig *config, int t, char *out, unsigned char *attrs);
+
+// Pinta las figuras activas en t sobre out (y attrs, si no es NULL) sin limpiarlos
+void render_paint(const AnimationConfig *config, int t, char *out, unsigned char *attrs);
+
+typedef enum {
+    RENDER_CLEAR,            // cada frame parte de un canvas vacío (animator.c)
+    RENDER_ACCUMULATE        // el canvas conserva lo pintado antes (animator_mt.c)
+} RenderMode;
+
+/*
+ * Acceso aleatorio a frames. En RENDER_CLEAR cada frame sale directo de
+ * render_frame. En RENDER_ACCUMULATE se guarda un snapshot del canvas
+ * (y de su plano de atributos, si la escena tiene color) cada `interval`
+ * frames, así que buscar el frame t cuesta copiar un snapshot y repintar
+ * a lo sumo interval - 1 frames.
+ */
+typedef struct {
+    const AnimationConfig *config;
+    RenderMode mode;
+    int max_time;
+    int interval;
+    int num_snapshots;
+    char *snapshots;         // snapshot k = canvas antes de pintar el frame k * interval
+    unsigned char *snapshot_attrs;  // atributos de cada snapshot (NULL = escena monocroma)
+} FrameSeeker;
+
+// Último tick con alguna figura activa
+int render_max_time(const AnimationConfig *config);
+
+/*
+ * Prepara el buscador. En RENDER_ACCUMULATE recorre una vez la animación
+ * y usa como máximo budget_bytes para snapshots (0 = un snapshot cada
+ * 64 frames). Retorna 0 en éxito, -1 si falla o si la configuración
+ * define "collisions", que los frames sueltos no pueden reproducir.
+ */
+int frame_seeker_init(FrameSeeker *s, const AnimationConfig *config, RenderMode mode, long budget_bytes);
+
+/*
+ * Escribe en out el frame t, y sus atributos en attrs si no es NULL
+ * (reentrante: solo lee los snapshots).
+ */
+void frame_seeker_render(const FrameSeeker *s, int t, char *out, unsigned char *attrs);
+
+void frame_seeker_free(FrameSeeker *s);
+
+#endif // RENDER_H
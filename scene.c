@@ -0,0 +1,141 @@
+#include "scene.h"
+#include <stdlib.h>
+#include <string.h>
+
+Scene *scene_create(int num_figures) {
+    Scene *s = calloc(1, sizeof(Scene));
+    if (!s) return NULL;
+    s->num_figures = num_figures;
+
+    size_t n = num_figures > 0 ? num_figures : 1;
+    s->t_start = malloc(sizeof(int) * n);
+    s->t_end = malloc(sizeof(int) * n);
+    s->x0 = malloc(sizeof(int) * n);
+    s->y0 = malloc(sizeof(int) * n);
+    s->x1 = malloc(sizeof(int) * n);
+    s->y1 = malloc(sizeof(int) * n);
+    s->rows = malloc(sizeof(int) * n);
+    s->cols = malloc(sizeof(int) * n);
+    s->attr = malloc(sizeof(int) * n);
+    s->glyph = malloc(sizeof(int) * n * SCENE_NUM_ANGLES);
+    s->sprite = malloc(sizeof(int) * n * SCENE_NUM_ANGLES);
+    if (!s->t_start || !s->t_end || !s->x0 || !s->y0 || !s->x1 || !s->y1 ||
+        !s->rows || !s->cols || !s->attr || !s->glyph || !s->sprite ||
+        sprite_table_init(&s->sprites) != 0) {
+        scene_free(s);
+        return NULL;
+    }
+    for (size_t i = 0; i < n * SCENE_NUM_ANGLES; i++) {
+        s->glyph[i] = -1;
+        s->sprite[i] = -1;
+    }
+    return s;
+}
+
+void scene_free(Scene *s) {
+    if (!s) return;
+    free(s->t_start);
+    free(s->t_end);
+    free(s->x0);
+    free(s->y0);
+    free(s->x1);
+    free(s->y1);
+    free(s->rows);
+    free(s->cols);
+    free(s->attr);
+    free(s->glyph);
+    free(s->sprite);
+    free(s->atlas);
+    sprite_table_free(&s->sprites);
+    free(s);
+}
+
+static int resize_array(int **array, size_t n) {
+    int *p = realloc(*array, sizeof(int) * n);
+    if (!p) return -1;
+    *array = p;
+    return 0;
+}
+
+int scene_resize(Scene *s, int num_figures) {
+    size_t old = s->num_figures > 0 ? s->num_figures : 1;
+    size_t n = num_figures > 0 ? num_figures : 1;
+    if (resize_array(&s->t_start, n) != 0 || resize_array(&s->t_end, n) != 0 ||
+        resize_array(&s->x0, n) != 0 || resize_array(&s->y0, n) != 0 ||
+        resize_array(&s->x1, n) != 0 || resize_array(&s->y1, n) != 0 ||
+        resize_array(&s->rows, n) != 0 || resize_array(&s->cols, n) != 0 ||
+        resize_array(&s->attr, n) != 0 ||
+        resize_array(&s->glyph, n * SCENE_NUM_ANGLES) != 0 ||
+        resize_array(&s->sprite, n * SCENE_NUM_ANGLES) != 0) {
+        return -1;
+    }
+    for (size_t i = old * SCENE_NUM_ANGLES; i < n * SCENE_NUM_ANGLES; i++) {
+        s->glyph[i] = -1;
+        s->sprite[i] = -1;
+    }
+    s->num_figures = num_figures;
+    return 0;
+}
+
+int scene_atlas_alloc(Scene *s, int rows, int cols) {
+    if (rows <= 0 || cols < 0) return -1;
+    int size = rows * (cols + 1);
+    if (s->atlas_size + size > s->atlas_cap) {
+        int cap = s->atlas_cap ? s->atlas_cap : 4096;
+        while (cap < s->atlas_size + size) cap *= 2;
+        char *atlas = realloc(s->atlas, cap);
+        if (!atlas) return -1;
+        s->atlas = atlas;
+        s->atlas_cap = cap;
+    }
+    int off = s->atlas_size;
+    memset(s->atlas + off, '\0', size);
+    s->atlas_size += size;
+    return off;
+}
+
+int scene_intern_glyph(Scene *s, int i, int k, const char *data) {
+    return scene_intern_glyph_hashed(s, i, k, data, sprite_hash(data, s->rows[i], s->cols[i]));
+}
+
+int scene_intern_glyph_hashed(Scene *s, int i, int k, const char *data, unsigned hash) {
+    int rows = s->rows[i], cols = s->cols[i];
+    int id = sprite_find(&s->sprites, s->atlas, data, rows, cols, hash);
+    if (id >= 0) {
+        sprite_retain(&s->sprites, id);
+    } else {
+        int off = scene_atlas_alloc(s, rows, cols);
+        if (off < 0) return -1;
+        memcpy(s->atlas + off, data, rows * (cols + 1));
+        id = sprite_add(&s->sprites, hash, off, rows, cols);
+        if (id < 0) return -1;
+    }
+
+    int slot = i * SCENE_NUM_ANGLES + k;
+    if (s->sprite[slot] >= 0) sprite_release(&s->sprites, s->sprite[slot]);
+    s->sprite[slot] = id;
+    s->glyph[slot] = s->sprites.sprites[id].offset;
+    return 0;
+}
+
+void scene_release_figure(Scene *s, int i) {
+    for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+        int slot = i * SCENE_NUM_ANGLES + k;
+        if (s->sprite[slot] >= 0) sprite_release(&s->sprites, s->sprite[slot]);
+        s->sprite[slot] = -1;
+        s->glyph[slot] = -1;
+    }
+}
+
+void scene_set_figure(Scene *s, int i, const Figure *f) {
+    s->t_start[i] = f->t_start;
+    s->t_end[i] = f->t_end;
+    s->x0[i] = f->pos0.x;
+    s->y0[i] = f->pos0.y;
+    s->x1[i] = f->pos1.x;
+    s->y1[i] = f->pos1.y;
+    s->rows[i] = f->rows;
+    s->cols[i] = f->cols;
+    s->attr[i] = f->attr;
+    if (f->attr) s->colored = 1;
+}
@@ -0,0 +1,88 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stddef.h>
+#include "anim_config.h"
+#include "sprite_table.h"
+
+// Rotaciones soportadas: índice k ↔ ángulo k * 90
+#define SCENE_NUM_ANGLES 4
+
+/*
+ * Escena en formato SoA: los campos que se leen en cada tick viven en
+ * arreglos paralelos y todas las rotaciones se empaquetan en un único
+ * atlas. Cada glifo ocupa rows * (cols + 1) bytes: las filas terminan en
+ * '\0' para poder entregarlas como cadenas.
+ */
+typedef struct Scene {
+    int num_figures;
+
+    // Campos calientes por figura
+    int *t_start, *t_end;
+    int *x0, *y0, *x1, *y1;
+    int *rows, *cols;
+    int *attr;               // color y estilo (ATTR_* en frame_encoder.h)
+    int *glyph;              // glyph[i * SCENE_NUM_ANGLES + k]: offset en atlas (-1 = no existe)
+    int *sprite;             // sprite internado de cada glifo (-1 = no existe)
+
+    // Atlas de glifos: un bloque por sprite distinto
+    char *atlas;
+    int atlas_size, atlas_cap;
+    SpriteTable sprites;
+    int colored;             // alguna figura tiene attr != 0 (los motores pintan el plano de atributos)
+} Scene;
+
+Scene *scene_create(int num_figures);
+void scene_free(Scene *s);
+
+/*
+ * Cambia la cantidad de figuras conservando las primeras; las nuevas
+ * quedan sin glifos. Antes de achicar hay que soltar las figuras que
+ * sobran (scene_release_figure). Retorna 0 en éxito, -1 si falla.
+ */
+int scene_resize(Scene *s, int num_figures);
+
+/*
+ * Reserva espacio en el atlas para un glifo rows x cols (relleno con '\0').
+ * Retorna el offset, o -1 si no hay memoria. El puntero al atlas puede
+ * cambiar entre llamadas.
+ */
+int scene_atlas_alloc(Scene *s, int rows, int cols);
+
+/*
+ * Interna el glifo rows x cols de la figura i con rotación k: si ya hay
+ * un sprite idéntico se comparte, si no se copia al atlas. data debe
+ * tener el mismo formato que el atlas. Retorna 0 en éxito, -1 si falla.
+ */
+int scene_intern_glyph(Scene *s, int i, int k, const char *data);
+
+// Igual, con hash = sprite_hash(data, rows, cols) ya calculado (p. ej. en otro hilo)
+int scene_intern_glyph_hashed(Scene *s, int i, int k, const char *data, unsigned hash);
+
+// Suelta los sprites de la figura i (sus glifos quedan en -1)
+void scene_release_figure(Scene *s, int i);
+
+// Copia los campos escalares de una figura a los arreglos de la escena
+void scene_set_figure(Scene *s, int i, const Figure *f);
+
+// Índice de rotación de la figura i en el tick t (cambia cada 2 ticks)
+static inline int scene_rotation_at(const Scene *s, int i, int t) {
+    return ((t - s->t_start[i]) / 2) % SCENE_NUM_ANGLES;
+}
+
+// Glifo de la figura i con rotación k, o NULL si no existe
+static inline const char *scene_glyph(const Scene *s, int i, int k) {
+    int off = s->glyph[i * SCENE_NUM_ANGLES + k];
+    return off < 0 ? NULL : s->atlas + off;
+}
+
+/*
+ * Glifo de la figura i para un ángulo en grados (0, 90, 180 o 270), o
+ * NULL si no existe. La fila r empieza en glifo + r * (cols + 1).
+ */
+static inline const char *scene_figure_rotation(const Scene *s, int i, int angle) {
+    if (angle < 0 || angle % 90 != 0 || angle / 90 >= SCENE_NUM_ANGLES) return NULL;
+    return scene_glyph(s, i, angle / 90);
+}
+
+#endif // SCENE_H
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <string.h>
+#include "config_parser.h"
+#include "frame_clock.h"
+#include "scene.h"
+#include "scene_file.h"
+#include "trajectory.h"
+
+/*
+ * Compila una configuración JSON a escena binaria (.mdscene) y mide la
+ * carga de ambas formas; con --verify comprueba una escena ya compilada.
+ * Uso: scene_compile [config.json] [salida.mdscene]
+ *      scene_compile --verify escena.mdscene
+ */
+static int verify(const char *path) {
+    long long start = frame_clock_now_ns();
+    AnimationConfig *config = scene_file_load(path, 1);
+    if (!config) return 1;
+    printf("%s: correcta (%d figuras, %d sprites), verificada en %.2f ms\n", path,
+           config->num_figures, config->scene->sprites.num_sprites,
+           (frame_clock_now_ns() - start) / 1e6);
+    free_config(config);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "--verify") == 0) return verify(argv[2]);
+
+    const char *input = argc > 1 ? argv[1] : "config.json";
+    const char *output = argc > 2 ? argv[2] : "scene.mdscene";
+
+    long long start = frame_clock_now_ns();
+    AnimationConfig *config = load_config(input);
+    double parse_ms = (frame_clock_now_ns() - start) / 1e6;
+    if (!config) {
+        fprintf(stderr, "Error cargando la configuración\n");
+        return 1;
+    }
+    if (config->file) {
+        fprintf(stderr, "%s ya es una escena compilada\n", input);
+        free_config(config);
+        return 1;
+    }
+    if (scene_file_write(config, output) != 0) {
+        free_config(config);
+        return 1;
+    }
+    printf("Escena: %s\n", output);
+    printf("Figuras: %d | sprites: %d | keyframes: %d | atlas: %d bytes\n",
+           config->num_figures, config->scene->sprites.num_sprites,
+           config->trajectory->num_keys, config->scene->atlas_size);
+    free_config(config);
+
+    start = frame_clock_now_ns();
+    config = scene_file_load(output, 0);
+    double load_ms = (frame_clock_now_ns() - start) / 1e6;
+    if (!config) return 1;
+    printf("Carga: JSON %.2f ms | compilada %.3f ms (%.2f MB mapeados)\n", parse_ms, load_ms,
+           config->file->map_size / (1024.0 * 1024.0));
+    free_config(config);
+    return 0;
+}
@@ -0,0 +1,421 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "scene_file.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "anim_utils.h"
+#include "scene.h"
+#include "trajectory.h"
+
+typedef struct {
+    const void *data;
+    size_t size;
+} Chunk;
+
+static uint64_t align_up(uint64_t n) {
+    return (n + SCENE_FILE_ALIGN - 1) / SCENE_FILE_ALIGN * SCENE_FILE_ALIGN;
+}
+
+// Secciones en el orden del enum, apuntando a la escena y las trayectorias
+static void collect_chunks(const AnimationConfig *config, Chunk *chunks) {
+    const Scene *s = config->scene;
+    const Trajectory *tr = config->trajectory;
+    size_t nf = (size_t)s->num_figures * sizeof(int);
+    size_t ng = nf * SCENE_NUM_ANGLES;
+    size_t nk = (size_t)tr->num_keys * sizeof(int);
+
+    chunks[SCENE_SECTION_T_START] = (Chunk){s->t_start, nf};
+    chunks[SCENE_SECTION_T_END] = (Chunk){s->t_end, nf};
+    chunks[SCENE_SECTION_X0] = (Chunk){s->x0, nf};
+    chunks[SCENE_SECTION_Y0] = (Chunk){s->y0, nf};
+    chunks[SCENE_SECTION_X1] = (Chunk){s->x1, nf};
+    chunks[SCENE_SECTION_Y1] = (Chunk){s->y1, nf};
+    chunks[SCENE_SECTION_ROWS] = (Chunk){s->rows, nf};
+    chunks[SCENE_SECTION_COLS] = (Chunk){s->cols, nf};
+    chunks[SCENE_SECTION_ATTR] = (Chunk){s->attr, nf};
+    chunks[SCENE_SECTION_GLYPH] = (Chunk){s->glyph, ng};
+    chunks[SCENE_SECTION_SPRITE] = (Chunk){s->sprite, ng};
+    chunks[SCENE_SECTION_ATLAS] = (Chunk){s->atlas, (size_t)s->atlas_size};
+    chunks[SCENE_SECTION_SPRITES] = (Chunk){s->sprites.sprites, (size_t)s->sprites.num_sprites * sizeof(Sprite)};
+    chunks[SCENE_SECTION_KEY_START] = (Chunk){tr->key_start, nf};
+    chunks[SCENE_SECTION_KEY_COUNT] = (Chunk){tr->key_count, nf};
+    chunks[SCENE_SECTION_KEYS] = (Chunk){tr->keys, (size_t)tr->num_keys * sizeof(Keyframe)};
+    chunks[SCENE_SECTION_STEP_QX] = (Chunk){tr->step_qx, nk};
+    chunks[SCENE_SECTION_STEP_RX] = (Chunk){tr->step_rx, nk};
+    chunks[SCENE_SECTION_STEP_QY] = (Chunk){tr->step_qy, nk};
+    chunks[SCENE_SECTION_STEP_RY] = (Chunk){tr->step_ry, nk};
+    chunks[SCENE_SECTION_SIGN_X] = (Chunk){tr->sign_x, nk};
+    chunks[SCENE_SECTION_SIGN_Y] = (Chunk){tr->sign_y, nk};
+    chunks[SCENE_SECTION_SPAN] = (Chunk){tr->span, nk};
+    chunks[SCENE_SECTION_VIEWPORTS] = (Chunk){config->viewports, (size_t)config->num_viewports * sizeof(Viewport)};
+    chunks[SCENE_SECTION_PAN_KEYS] = (Chunk){config->pan_keys, (size_t)config->num_pan_keys * sizeof(Keyframe)};
+}
+
+static void pack_config(const AnimationConfig *config, SceneFileConfig *c) {
+    c->width = config->canvas.width;
+    c->height = config->canvas.height;
+    c->fps = config->fps;
+    c->frame_policy = config->frame_policy;
+    c->loops = config->loops;
+    c->workers = config->workers;
+    c->frame_cache_bytes = config->frame_cache_bytes;
+    c->frame_cache_compress = config->frame_cache_compress;
+    c->sink_policy = config->sink_policy;
+    c->sink_capacity = config->sink_capacity;
+    c->display_rows = config->displays.rows;
+    c->display_cols = config->displays.cols;
+    c->display_transport = config->displays.transport;
+    c->present_sync = config->displays.present_sync;
+    c->sync_timeout_ms = config->displays.sync_timeout_ms;
+    c->slow_id = config->displays.slow_id;
+    c->slow_delay_ms = config->displays.slow_delay_ms;
+    c->collisions = config->collisions;
+    c->world_width = config->world.width;
+    c->world_height = config->world.height;
+    c->num_viewports = config->num_viewports;
+    c->num_pan_keys = config->num_pan_keys;
+    memcpy(c->display_sink, config->displays.sink, sizeof(c->display_sink));
+}
+
+static void unpack_config(const SceneFileConfig *c, AnimationConfig *config) {
+    config->canvas.width = c->width;
+    config->canvas.height = c->height;
+    config->fps = c->fps;
+    config->frame_policy = c->frame_policy;
+    config->loops = c->loops;
+    config->workers = c->workers;
+    config->frame_cache_bytes = (long)c->frame_cache_bytes;
+    config->frame_cache_compress = c->frame_cache_compress;
+    config->sink_policy = c->sink_policy;
+    config->sink_capacity = c->sink_capacity;
+    config->displays.rows = c->display_rows;
+    config->displays.cols = c->display_cols;
+    config->displays.transport = c->display_transport;
+    config->displays.present_sync = c->present_sync;
+    config->displays.sync_timeout_ms = c->sync_timeout_ms;
+    config->displays.slow_id = c->slow_id;
+    config->displays.slow_delay_ms = c->slow_delay_ms;
+    config->collisions = c->collisions;
+    config->world.width = c->world_width;
+    config->world.height = c->world_height;
+    config->num_viewports = c->num_viewports;
+    config->num_pan_keys = c->num_pan_keys;
+    memcpy(config->displays.sink, c->display_sink, sizeof(config->displays.sink));
+    config->displays.sink[sizeof(config->displays.sink) - 1] = '\0';
+}
+
+static uint64_t header_checksum(const SceneFileHeader *h) {
+    return hash_bytes(h, offsetof(SceneFileHeader, header_checksum));
+}
+
+/*
+ * Se escribe en path.tmp y se renombra encima al final: quien tenga
+ * mapeado el archivo anterior (animador, displays, --watch) conserva sus
+ * páginas en lugar de recibir SIGBUS al truncarlo.
+ */
+int scene_file_write(const AnimationConfig *config, const char *path) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) {
+        fprintf(stderr, "Ruta demasiado larga: %s\n", path);
+        return -1;
+    }
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        perror("No se pudo crear la escena compilada");
+        return -1;
+    }
+
+    const Scene *s = config->scene;
+    SceneFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SCENE_FILE_MAGIC, sizeof(h.magic));
+    h.version = SCENE_FILE_VERSION;
+    h.header_size = sizeof(SceneFileHeader);
+    h.endian = SCENE_FILE_ENDIAN;
+    h.num_figures = s->num_figures;
+    h.num_sprites = s->sprites.num_sprites;
+    h.num_keys = config->trajectory->num_keys;
+    h.atlas_size = s->atlas_size;
+    h.source_hash = config->hash;
+    pack_config(config, &h.config);
+
+    Chunk chunks[SCENE_SECTION_COUNT];
+    collect_chunks(config, chunks);
+
+    // Encabezado provisorio; se reescribe al final con offsets y checksums
+    static const char zeros[SCENE_FILE_ALIGN] = {0};
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    uint64_t offset = sizeof(h);
+    unsigned long long sum = HASH_SEED;
+    for (int k = 0; ok && k < SCENE_SECTION_COUNT; k++) {
+        size_t pad = align_up(offset) - offset;
+        ok = fwrite(zeros, 1, pad, f) == pad;
+        sum = hash_bytes_update(sum, zeros, pad);
+        offset += pad;
+
+        h.sections[k].offset = offset;
+        h.sections[k].size = chunks[k].size;
+        if (chunks[k].size > 0) {
+            ok = ok && fwrite(chunks[k].data, 1, chunks[k].size, f) == chunks[k].size;
+            sum = hash_bytes_update(sum, chunks[k].data, chunks[k].size);
+        }
+        offset += chunks[k].size;
+    }
+
+    h.file_size = offset;
+    h.payload_checksum = sum;
+    h.header_checksum = header_checksum(&h);
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = ok && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = (fclose(f) == 0) && ok;
+    ok = ok && rename(tmp, path) == 0;
+    if (!ok) {
+        fprintf(stderr, "Error escribiendo la escena compilada: %s\n", path);
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+int scene_file_probe(const char *path) {
+    char magic[8];
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    int match = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+                memcmp(magic, SCENE_FILE_MAGIC, sizeof(magic)) == 0;
+    fclose(f);
+    return match;
+}
+
+// Tamaño que debe tener cada sección según los contadores del encabezado
+static uint64_t expected_size(const SceneFileHeader *h, int k) {
+    uint64_t nf = (uint64_t)h->num_figures * sizeof(int);
+    uint64_t nk = (uint64_t)h->num_keys * sizeof(int);
+    switch (k) {
+    case SCENE_SECTION_GLYPH:
+    case SCENE_SECTION_SPRITE: return nf * SCENE_NUM_ANGLES;
+    case SCENE_SECTION_ATLAS: return h->atlas_size;
+    case SCENE_SECTION_SPRITES: return (uint64_t)h->num_sprites * sizeof(Sprite);
+    case SCENE_SECTION_KEYS: return (uint64_t)h->num_keys * sizeof(Keyframe);
+    case SCENE_SECTION_STEP_QX: case SCENE_SECTION_STEP_RX:
+    case SCENE_SECTION_STEP_QY: case SCENE_SECTION_STEP_RY:
+    case SCENE_SECTION_SIGN_X: case SCENE_SECTION_SIGN_Y:
+    case SCENE_SECTION_SPAN: return nk;
+    case SCENE_SECTION_VIEWPORTS: return (uint64_t)h->config.num_viewports * sizeof(Viewport);
+    case SCENE_SECTION_PAN_KEYS: return (uint64_t)h->config.num_pan_keys * sizeof(Keyframe);
+    default: return nf;
+    }
+}
+
+// Encabezado y límites de las secciones: no toca más que la primera página
+static int check_header(const SceneFileHeader *h, size_t map_size) {
+    if (memcmp(h->magic, SCENE_FILE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != SCENE_FILE_VERSION || h->header_size != sizeof(SceneFileHeader) ||
+        h->endian != SCENE_FILE_ENDIAN || h->file_size != map_size ||
+        h->header_checksum != header_checksum(h) || h->atlas_size > INT32_MAX ||
+        h->config.num_viewports < 0 || h->config.num_pan_keys < 0) {
+        return -1;
+    }
+    for (int k = 0; k < SCENE_SECTION_COUNT; k++) {
+        const SceneFileSection *sec = &h->sections[k];
+        if (sec->offset % SCENE_FILE_ALIGN != 0 || sec->offset < sizeof(SceneFileHeader) ||
+            sec->offset > map_size || sec->size > map_size - sec->offset ||
+            sec->size != expected_size(h, k)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Offsets que se leen del disco y se usan como índices: glifos dentro del
+ * atlas, sprites, keyframes de cada figura y de cada pan. Corre en cada
+ * carga (O(figuras + keyframes)); un archivo corrupto no debe leer fuera
+ * del mapeo.
+ */
+static int check_ranges(const AnimationConfig *config) {
+    const Scene *s = config->scene;
+    const Trajectory *tr = config->trajectory;
+    for (int i = 0; i < s->num_figures; i++) {
+        if (s->rows[i] < 0 || s->cols[i] < 0) return -1;
+        long long size = (long long)s->rows[i] * (s->cols[i] + 1);
+        for (int k = 0; k < SCENE_NUM_ANGLES; k++) {
+            int off = s->glyph[i * SCENE_NUM_ANGLES + k];
+            int id = s->sprite[i * SCENE_NUM_ANGLES + k];
+            if (off < -1 || (off >= 0 && off + size > s->atlas_size)) return -1;
+            if (id < -1 || id >= s->sprites.num_sprites) return -1;
+        }
+        if (tr->key_start[i] < 0 || tr->key_count[i] < 1 ||
+            (long long)tr->key_start[i] + tr->key_count[i] > tr->num_keys) {
+            return -1;
+        }
+    }
+    for (int j = 0; j < tr->num_keys; j++) {
+        if (tr->span[j] < 1) return -1;  // divisor del DDA
+    }
+    for (int id = 0; id < s->sprites.num_sprites; id++) {
+        const Sprite *sp = &s->sprites.sprites[id];
+        if (sp->offset < 0 || sp->rows < 0 || sp->cols < 0 ||
+            sp->offset + (long long)sp->rows * (sp->cols + 1) > s->atlas_size) {
+            return -1;
+        }
+    }
+    for (int v = 0; v < config->num_viewports; v++) {
+        const Viewport *vp = &config->viewports[v];
+        if (vp->pan_start < 0 || vp->pan_count < 0 ||
+            (long long)vp->pan_start + vp->pan_count > config->num_pan_keys) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Recorrido completo del archivo (--verify): toca todas las páginas
+static int check_payload(const SceneFile *file) {
+    const SceneFileHeader *h = file->header;
+    const char *payload = (const char *)file->map + sizeof(SceneFileHeader);
+    return hash_bytes(payload, file->map_size - sizeof(SceneFileHeader)) == h->payload_checksum ? 0 : -1;
+}
+
+#define SECTION(h, map, k) ((void *)((char *)(map) + (h)->sections[k].offset))
+
+// Scene y Trajectory con sus arreglos apuntando dentro del mapeo
+static AnimationConfig *build_config(SceneFile *file) {
+    const SceneFileHeader *h = file->header;
+    void *map = file->map;
+    AnimationConfig *config = calloc(1, sizeof(AnimationConfig));
+    Scene *s = calloc(1, sizeof(Scene));
+    Trajectory *tr = calloc(1, sizeof(Trajectory));
+    if (!config || !s || !tr) {
+        free(config);
+        free(s);
+        free(tr);
+        return NULL;
+    }
+    unpack_config(&h->config, config);
+    config->hash = h->source_hash;
+    config->num_figures = h->num_figures;
+    config->file = file;
+    config->scene = s;
+    config->trajectory = tr;
+
+    s->num_figures = h->num_figures;
+    s->t_start = SECTION(h, map, SCENE_SECTION_T_START);
+    s->t_end = SECTION(h, map, SCENE_SECTION_T_END);
+    s->x0 = SECTION(h, map, SCENE_SECTION_X0);
+    s->y0 = SECTION(h, map, SCENE_SECTION_Y0);
+    s->x1 = SECTION(h, map, SCENE_SECTION_X1);
+    s->y1 = SECTION(h, map, SCENE_SECTION_Y1);
+    s->rows = SECTION(h, map, SCENE_SECTION_ROWS);
+    s->cols = SECTION(h, map, SCENE_SECTION_COLS);
+    s->attr = SECTION(h, map, SCENE_SECTION_ATTR);
+    for (int i = 0; i < s->num_figures && !s->colored; i++) s->colored = s->attr[i] != 0;
+    s->glyph = SECTION(h, map, SCENE_SECTION_GLYPH);
+    s->sprite = SECTION(h, map, SCENE_SECTION_SPRITE);
+    s->atlas = SECTION(h, map, SCENE_SECTION_ATLAS);
+    s->atlas_size = s->atlas_cap = h->atlas_size;
+    s->sprites.sprites = SECTION(h, map, SCENE_SECTION_SPRITES);
+    s->sprites.num_sprites = s->sprites.cap_sprites = h->num_sprites;
+    s->sprites.live_bytes = h->atlas_size;
+
+    tr->num_figures = h->num_figures;
+    tr->num_keys = h->num_keys;
+    tr->key_start = SECTION(h, map, SCENE_SECTION_KEY_START);
+    tr->key_count = SECTION(h, map, SCENE_SECTION_KEY_COUNT);
+    tr->keys = SECTION(h, map, SCENE_SECTION_KEYS);
+    tr->step_qx = SECTION(h, map, SCENE_SECTION_STEP_QX);
+    tr->step_rx = SECTION(h, map, SCENE_SECTION_STEP_RX);
+    tr->step_qy = SECTION(h, map, SCENE_SECTION_STEP_QY);
+    tr->step_ry = SECTION(h, map, SCENE_SECTION_STEP_RY);
+    tr->sign_x = SECTION(h, map, SCENE_SECTION_SIGN_X);
+    tr->sign_y = SECTION(h, map, SCENE_SECTION_SIGN_Y);
+    tr->span = SECTION(h, map, SCENE_SECTION_SPAN);
+
+    /*
+     * Las cámaras se copian fuera del mapeo: hot_reload intercambia la
+     * escena y el mapeo pero deja las cámaras de la configuración en
+     * curso, que deben sobrevivir al munmap y poder liberarse con free.
+     */
+    size_t vp_size = h->sections[SCENE_SECTION_VIEWPORTS].size;
+    size_t pan_size = h->sections[SCENE_SECTION_PAN_KEYS].size;
+    config->viewports = vp_size > 0 ? malloc(vp_size) : NULL;
+    config->pan_keys = pan_size > 0 ? malloc(pan_size) : NULL;
+    if ((vp_size > 0 && !config->viewports) || (pan_size > 0 && !config->pan_keys)) {
+        free(config->viewports);
+        free(config->pan_keys);
+        free(config);
+        free(s);
+        free(tr);
+        return NULL;
+    }
+    if (vp_size > 0) memcpy(config->viewports, SECTION(h, map, SCENE_SECTION_VIEWPORTS), vp_size);
+    if (pan_size > 0) memcpy(config->pan_keys, SECTION(h, map, SCENE_SECTION_PAN_KEYS), pan_size);
+    return config;
+}
+
+static void unmap(SceneFile *file) {
+    if (file->map) munmap(file->map, file->map_size);
+    free(file);
+}
+
+AnimationConfig *scene_file_load(const char *path, int verify) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("No se pudo abrir la escena compilada");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SceneFileHeader)) {
+        fprintf(stderr, "Escena compilada inválida: %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    // Solo lectura y compartido: los displays (y otros procesos) usan las mismas páginas
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+    SceneFile *file = calloc(1, sizeof(SceneFile));
+    if (!file) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+    file->map = map;
+    file->map_size = st.st_size;
+    file->header = map;
+
+    if (check_header(file->header, file->map_size) != 0) {
+        fprintf(stderr, "Escena compilada inválida o de otra versión: %s\n", path);
+        unmap(file);
+        return NULL;
+    }
+    AnimationConfig *config = build_config(file);
+    if (!config) {
+        unmap(file);
+        return NULL;
+    }
+    if (check_ranges(config) != 0 || (verify && check_payload(file) != 0)) {
+        fprintf(stderr, "Escena compilada corrupta: %s\n", path);
+        scene_file_unload(config);
+        return NULL;
+    }
+    return config;
+}
+
+void scene_file_unload(AnimationConfig *config) {
+    // Los arreglos viven en el mapeo: solo se sueltan las estructuras y las cámaras
+    free(config->viewports);
+    free(config->pan_keys);
+    free(config->scene);
+    free(config->trajectory);
+    unmap(config->file);
+    free(config);
+}
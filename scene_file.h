@@ -0,0 +1,103 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "anim_config.h"
+
+/*
+ * Escena compilada (.mdscene), en el orden de bytes de la máquina que la
+ * escribió (se verifica con SCENE_FILE_ENDIAN):
+ *
+ *   SceneFileHeader
+ *   secciones alineadas a SCENE_FILE_ALIGN: arreglos SoA de la escena,
+ *   atlas de glifos, sprites y tablas de trayectoria precalculadas
+ *
+ * Todo se referencia por offset desde el inicio del archivo, así que el
+ * mapeo se usa tal cual en cualquier dirección: cargar es validar el
+ * encabezado y apuntar Scene y Trajectory dentro del mapeo, sin parsear
+ * ni reservar nada por figura. Como el mapeo es MAP_SHARED de solo
+ * lectura, los procesos de display comparten las mismas páginas.
+ */
+#define SCENE_FILE_MAGIC   "MDSCENE\n"
+#define SCENE_FILE_VERSION 4
+#define SCENE_FILE_ENDIAN  0x01020304u
+#define SCENE_FILE_ALIGN   64
+
+enum {
+    // Scene
+    SCENE_SECTION_T_START, SCENE_SECTION_T_END,
+    SCENE_SECTION_X0, SCENE_SECTION_Y0, SCENE_SECTION_X1, SCENE_SECTION_Y1,
+    SCENE_SECTION_ROWS, SCENE_SECTION_COLS, SCENE_SECTION_ATTR,
+    SCENE_SECTION_GLYPH, SCENE_SECTION_SPRITE,
+    SCENE_SECTION_ATLAS, SCENE_SECTION_SPRITES,
+    // Trajectory
+    SCENE_SECTION_KEY_START, SCENE_SECTION_KEY_COUNT, SCENE_SECTION_KEYS,
+    SCENE_SECTION_STEP_QX, SCENE_SECTION_STEP_RX, SCENE_SECTION_STEP_QY, SCENE_SECTION_STEP_RY,
+    SCENE_SECTION_SIGN_X, SCENE_SECTION_SIGN_Y, SCENE_SECTION_SPAN,
+    // Cámaras (viewport.h)
+    SCENE_SECTION_VIEWPORTS, SCENE_SECTION_PAN_KEYS,
+    SCENE_SECTION_COUNT
+};
+
+typedef struct {
+    uint64_t offset;                 // desde el inicio del archivo
+    uint64_t size;                   // bytes útiles (sin el relleno de alineación)
+} SceneFileSection;
+
+// Campos escalares de AnimationConfig, con ancho fijo
+typedef struct {
+    int32_t width, height;
+    int32_t fps, frame_policy, loops, workers;
+    int64_t frame_cache_bytes;
+    int32_t frame_cache_compress;
+    int32_t sink_policy, sink_capacity;
+    int32_t display_rows, display_cols, display_transport;
+    int32_t present_sync, sync_timeout_ms, slow_id, slow_delay_ms;
+    int32_t collisions;
+    int32_t world_width, world_height;
+    int32_t num_viewports, num_pan_keys;
+    char display_sink[256];
+} SceneFileConfig;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;            // sizeof(SceneFileHeader) al escribir
+    uint32_t endian;                 // SCENE_FILE_ENDIAN
+    uint32_t num_figures, num_sprites, num_keys;
+    uint32_t atlas_size;
+    uint32_t reserved;
+    uint64_t file_size;
+    uint64_t source_hash;            // AnimationConfig.hash del JSON de origen
+    uint64_t payload_checksum;       // hash_bytes de todo lo que sigue al encabezado
+    SceneFileConfig config;
+    SceneFileSection sections[SCENE_SECTION_COUNT];
+    uint64_t header_checksum;        // hash_bytes del encabezado hasta este campo
+} SceneFileHeader;
+
+// Archivo mapeado; AnimationConfig.file lo mantiene vivo
+typedef struct SceneFile {
+    void *map;
+    size_t map_size;
+    const SceneFileHeader *header;
+} SceneFile;
+
+// Compila la configuración ya cargada en path (vía path.tmp + rename). Retorna 0 o -1.
+int scene_file_write(const AnimationConfig *config, const char *path);
+
+// 1 si path empieza con SCENE_FILE_MAGIC
+int scene_file_probe(const char *path);
+
+/*
+ * Mapea path y arma la configuración sobre el mapeo. Siempre valida el
+ * encabezado, los límites de cada sección y los offsets de glifos,
+ * sprites y keyframes; con verify != 0 además recorre todo el archivo
+ * para comprobar payload_checksum (toca todas las páginas). NULL si falla.
+ */
+AnimationConfig *scene_file_load(const char *path, int verify);
+
+// La llama free_config cuando config->file no es NULL
+void scene_file_unload(AnimationConfig *config);
+
+#endif // SCENE_FILE_H
@@ -0,0 +1,298 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Genera escenas sintéticas para medir cómo escalan los motores.
+ * Uso: scene_gen [salida.json] [--figures=N] [--sprite=FxC] [--canvas=AxA]
+ *                [--duration=T] [--lifetime=full|uniform|burst] [--overlap=D]
+ *                [--keyframes=K] [--shapes=S] [--fps=F] [--loops=L]
+ *                [--workers=W] [--colors=C] [--world=AxA] [--viewports=V] [--seed=S]
+ *   --sprite    filas x columnas de cada figura (5x5)
+ *   --canvas    ancho x alto del canvas (100x40)
+ *   --duration  ticks de la animación (100)
+ *   --lifetime  full    → todas viven toda la animación
+ *               uniform → inicio y fin al azar dentro de la duración
+ *               burst   → vidas cortas (1/8 de la duración) repartidas
+ *   --overlap   0 = posiciones en todo el canvas, 1 = todas en una zona
+ *               de 1/10 del canvas (más figuras por celda)
+ *   --keyframes keyframes por trayectoria (2 = pos0 → pos1)
+ *   --shapes    glifos distintos entre los que se reparten las figuras
+ *   --colors    colores ANSI entre los que se reparten las figuras (0 = sin color)
+ *   --world     ancho x alto del mundo donde se reparten las figuras (el canvas)
+ *   --viewports cámaras lado a lado en el canvas, cada una paneando entre dos
+ *               puntos al azar del mundo durante la animación (0 = sin cámaras)
+ * Sin salida escribe en stdout. La misma semilla da el mismo archivo.
+ */
+
+typedef enum {
+    LIFETIME_FULL,
+    LIFETIME_UNIFORM,
+    LIFETIME_BURST
+} Lifetime;
+
+typedef struct {
+    int figures;
+    int rows, cols;
+    int width, height;
+    int duration;
+    Lifetime lifetime;
+    double overlap;
+    int keyframes;
+    int shapes;
+    int fps, loops, workers;
+    int colors;
+    int world_width, world_height;   // 0 = el canvas
+    int viewports;
+    unsigned long long seed;
+} GenOptions;
+
+// splitmix64: suficiente para escenas reproducibles
+static unsigned long long next_random(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Entero uniforme en [lo, hi]
+static int random_range(unsigned long long *state, int lo, int hi) {
+    if (hi <= lo) return lo;
+    return lo + (int)(next_random(state) % (unsigned long long)(hi - lo + 1));
+}
+
+static int parse_pair(const char *s, int *a, int *b) {
+    return sscanf(s, "%dx%d", a, b) == 2 && *a > 0 && *b > 0 ? 0 : -1;
+}
+
+static int parse_options(int argc, char **argv, GenOptions *o, const char **output) {
+    *o = (GenOptions){
+        .figures = 100, .rows = 5, .cols = 5, .width = 100, .height = 40,
+        .duration = 100, .lifetime = LIFETIME_FULL, .overlap = 0.0,
+        .keyframes = 2, .shapes = 8, .fps = 0, .loops = 1, .workers = 0, .colors = 0,
+        .world_width = 0, .world_height = 0, .viewports = 0, .seed = 1
+    };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        int ok = 1;
+        if (strncmp(a, "--figures=", 10) == 0) {
+            o->figures = atoi(a + 10);
+            ok = o->figures >= 0;
+        } else if (strncmp(a, "--sprite=", 9) == 0) {
+            ok = parse_pair(a + 9, &o->rows, &o->cols) == 0;
+        } else if (strncmp(a, "--canvas=", 9) == 0) {
+            ok = parse_pair(a + 9, &o->width, &o->height) == 0;
+        } else if (strncmp(a, "--duration=", 11) == 0) {
+            o->duration = atoi(a + 11);
+            ok = o->duration > 0;
+        } else if (strncmp(a, "--lifetime=", 11) == 0) {
+            const char *v = a + 11;
+            if (strcmp(v, "full") == 0) o->lifetime = LIFETIME_FULL;
+            else if (strcmp(v, "uniform") == 0) o->lifetime = LIFETIME_UNIFORM;
+            else if (strcmp(v, "burst") == 0) o->lifetime = LIFETIME_BURST;
+            else ok = 0;
+        } else if (strncmp(a, "--overlap=", 10) == 0) {
+            o->overlap = atof(a + 10);
+            ok = o->overlap >= 0.0 && o->overlap <= 1.0;
+        } else if (strncmp(a, "--keyframes=", 12) == 0) {
+            o->keyframes = atoi(a + 12);
+            ok = o->keyframes >= 2;
+        } else if (strncmp(a, "--shapes=", 9) == 0) {
+            o->shapes = atoi(a + 9);
+            ok = o->shapes > 0;
+        } else if (strncmp(a, "--fps=", 6) == 0) {
+            o->fps = atoi(a + 6);
+        } else if (strncmp(a, "--loops=", 8) == 0) {
+            o->loops = atoi(a + 8);
+        } else if (strncmp(a, "--workers=", 10) == 0) {
+            o->workers = atoi(a + 10);
+        } else if (strncmp(a, "--colors=", 9) == 0) {
+            o->colors = atoi(a + 9);
+            ok = o->colors >= 0 && o->colors <= 16;
+        } else if (strncmp(a, "--world=", 8) == 0) {
+            ok = parse_pair(a + 8, &o->world_width, &o->world_height) == 0;
+        } else if (strncmp(a, "--viewports=", 12) == 0) {
+            o->viewports = atoi(a + 12);
+            ok = o->viewports >= 0;
+        } else if (strncmp(a, "--seed=", 7) == 0) {
+            o->seed = strtoull(a + 7, NULL, 10);
+        } else if (a[0] != '-') {
+            *output = a;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Opción inválida: %s\n", a);
+            return -1;
+        }
+    }
+    if (o->world_width == 0) {
+        o->world_width = o->width;
+        o->world_height = o->height;
+    }
+    if (o->viewports > o->width) o->viewports = o->width;
+    return 0;
+}
+
+/*
+ * Glifo s de la figura en las 4 rotaciones: un patrón al azar rotado.
+ * Con sprites no cuadrados, 90 y 270 se reflejan en lugar de rotar para
+ * conservar el tamaño filas x columnas.
+ */
+static void make_shape(const GenOptions *o, int s, char *rot[4]) {
+    unsigned long long state = o->seed * 1000003ULL + s;
+    int r = o->rows, c = o->cols;
+    for (int y = 0; y < r; y++) {
+        for (int x = 0; x < c; x++) {
+            rot[0][y * c + x] = (next_random(&state) % 3 != 0) ? "#*ox@%"[s % 6] : ' ';
+        }
+    }
+    for (int y = 0; y < r; y++) {
+        for (int x = 0; x < c; x++) {
+            char v = rot[0][y * c + x];
+            rot[2][(r - 1 - y) * c + (c - 1 - x)] = v;
+            if (r == c) {
+                rot[1][x * c + (c - 1 - y)] = v;
+                rot[3][(c - 1 - x) * c + y] = v;
+            } else {
+                rot[1][y * c + (c - 1 - x)] = v;
+                rot[3][(r - 1 - y) * c + x] = v;
+            }
+        }
+    }
+}
+
+static void write_rows(FILE *out, const char *g, int rows, int cols) {
+    fputc('[', out);
+    for (int y = 0; y < rows; y++) {
+        fprintf(out, "%s\"%.*s\"", y ? ", " : "", cols, g + y * cols);
+    }
+    fputc(']', out);
+}
+
+// Posición al azar dentro de la zona común del mundo (más chica cuanto mayor el overlap)
+static void random_position(const GenOptions *o, unsigned long long *state, int *x, int *y) {
+    double zone = 1.0 - 0.9 * o->overlap;
+    int zw = (int)(o->world_width * zone), zh = (int)(o->world_height * zone);
+    if (zw < 1) zw = 1;
+    if (zh < 1) zh = 1;
+    int x0 = (o->world_width - zw) / 2, y0 = (o->world_height - zh) / 2;
+    *x = x0 + random_range(state, 0, zw - 1) - o->cols / 2;
+    *y = y0 + random_range(state, 0, zh - 1) - o->rows / 2;
+}
+
+static void write_figure(FILE *out, const GenOptions *o, unsigned long long *state,
+                         char **shapes) {
+    int t_start = 0, t_end = o->duration;
+    if (o->lifetime == LIFETIME_UNIFORM) {
+        t_start = random_range(state, 0, o->duration - 1);
+        t_end = random_range(state, t_start + 1, o->duration);
+    } else if (o->lifetime == LIFETIME_BURST) {
+        int life = o->duration / 8 > 0 ? o->duration / 8 : 1;
+        t_start = random_range(state, 0, o->duration - life);
+        t_end = t_start + life;
+    }
+
+    int x0, y0, x1, y1;
+    random_position(o, state, &x0, &y0);
+    random_position(o, state, &x1, &y1);
+    fprintf(out, "{\"t_start\": %d, \"t_end\": %d, \"pos0\": {\"x\": %d, \"y\": %d}, "
+            "\"pos1\": {\"x\": %d, \"y\": %d}, \"rows\": %d, \"cols\": %d",
+            t_start, t_end, x0, y0, x1, y1, o->rows, o->cols);
+
+    if (o->keyframes > 2) {
+        // Keyframes intermedios a tiempos crecientes entre el inicio y el fin
+        fprintf(out, ", \"path\": [{\"t\": %d, \"x\": %d, \"y\": %d}", t_start, x0, y0);
+        int span = t_end - t_start;
+        for (int k = 1; k < o->keyframes - 1; k++) {
+            int x, y;
+            random_position(o, state, &x, &y);
+            fprintf(out, ", {\"t\": %d, \"x\": %d, \"y\": %d}",
+                    t_start + span * k / (o->keyframes - 1), x, y);
+        }
+        fprintf(out, ", {\"t\": %d, \"x\": %d, \"y\": %d}]", t_end, x1, y1);
+    }
+
+    if (o->colors > 0) {
+        static const char *colors[] = {
+            "red", "green", "yellow", "blue", "magenta", "cyan", "white", "black",
+            "bright_red", "bright_green", "bright_yellow", "bright_blue",
+            "bright_magenta", "bright_cyan", "bright_white", "bright_black"
+        };
+        fprintf(out, ", \"color\": \"%s\"", colors[random_range(state, 0, o->colors - 1)]);
+    }
+
+    int s = random_range(state, 0, o->shapes - 1);
+    static const char *angles[] = {"0", "90", "180", "270"};
+    fprintf(out, ", \"rotations\": {");
+    for (int k = 0; k < 4; k++) {
+        fprintf(out, "%s\"%s\": ", k ? ", " : "", angles[k]);
+        write_rows(out, shapes[s * 4 + k], o->rows, o->cols);
+    }
+    fprintf(out, "}}");
+}
+
+// Cámaras en franjas verticales del canvas; usan su propia semilla para no mover las figuras
+static void write_viewports(FILE *out, const GenOptions *o) {
+    unsigned long long state = o->seed ^ 0x5DEECE66DULL;
+    fprintf(out, ", \"world\": {\"width\": %d, \"height\": %d}", o->world_width, o->world_height);
+    if (o->viewports == 0) return;
+    fprintf(out, ",\n\"viewports\": [");
+    for (int v = 0; v < o->viewports; v++) {
+        int x = o->width * v / o->viewports;
+        int w = o->width * (v + 1) / o->viewports - x;
+        int max_x = o->world_width > w ? o->world_width - w : 0;
+        int max_y = o->world_height > o->height ? o->world_height - o->height : 0;
+        fprintf(out, "%s\n  {\"width\": %d, \"height\": %d, \"screen\": {\"x\": %d, \"y\": 0}, "
+                "\"pan\": [{\"t\": 0, \"x\": %d, \"y\": %d}, {\"t\": %d, \"x\": %d, \"y\": %d}]}",
+                v ? "," : "", w, o->height, x,
+                random_range(&state, 0, max_x), random_range(&state, 0, max_y),
+                o->duration, random_range(&state, 0, max_x), random_range(&state, 0, max_y));
+    }
+    fprintf(out, "]");
+}
+
+int main(int argc, char **argv) {
+    GenOptions o;
+    const char *output = NULL;
+    if (parse_options(argc, argv, &o, &output) != 0) return 1;
+
+    size_t glyph = (size_t)o.rows * o.cols;
+    char **shapes = malloc(sizeof(char *) * o.shapes * 4);
+    if (!shapes) return 1;
+    for (int s = 0; s < o.shapes; s++) {
+        for (int k = 0; k < 4; k++) shapes[s * 4 + k] = malloc(glyph);
+        make_shape(&o, s, &shapes[s * 4]);
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        return 1;
+    }
+    fprintf(out, "{\"num_figures\": %d, \"canvas\": {\"width\": %d, \"height\": %d}, "
+            "\"fps\": %d, \"loops\": %d",
+            o.figures, o.width, o.height, o.fps, o.loops);
+    if (o.workers > 0) fprintf(out, ", \"workers\": %d", o.workers);
+    if (o.viewports > 0 || o.world_width != o.width || o.world_height != o.height) {
+        write_viewports(out, &o);
+    }
+    fprintf(out, ",\n\"figures\": [\n");
+
+    unsigned long long state = o.seed;
+    for (int i = 0; i < o.figures; i++) {
+        write_figure(out, &o, &state, shapes);
+        fputs(i + 1 < o.figures ? ",\n" : "\n", out);
+    }
+    fprintf(out, "]}\n");
+
+    int failed = ferror(out);
+    if (out != stdout) failed |= fclose(out) != 0;
+    for (int s = 0; s < o.shapes * 4; s++) free(shapes[s]);
+    free(shapes);
+    if (failed) {
+        fprintf(stderr, "Error escribiendo la escena\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+
+#include "shm_ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void shm_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    struct timespec ts, *tsp = NULL;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        tsp = &ts;
+    }
+    syscall(SYS_futex, addr, FUTEX_WAIT, expected, tsp, NULL, 0);
+}
+
+void shm_futex_wake_all(uint32_t *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, 0x7fffffff, NULL, NULL, 0);
+}
+
+static int map_ring(ShmRing *ring, int fd, size_t size) {
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    ring->map = map;
+    ring->map_size = size;
+    ring->header = map;
+    return 0;
+}
+
+int shm_ring_create(ShmRing *ring, const char *name, int width, int height,
+                    int num_slots, int num_readers) {
+    memset(ring, 0, sizeof(*ring));
+    if (num_readers < 0 || num_readers > SHM_RING_MAX_READERS) return -1;
+    if (num_slots < 2) num_slots = SHM_RING_DEFAULT_SLOTS;
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+
+    // Slots alineados a 64 bytes para no compartir líneas de caché
+    uint64_t slot_size = sizeof(ShmRingSlot) + (uint64_t)width * height;
+    slot_size = (slot_size + 63) & ~(uint64_t)63;
+    size_t size = sizeof(ShmRingHeader) + (size_t)slot_size * num_slots;
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        return -1;
+    }
+    if (ftruncate(fd, size) != 0 || map_ring(ring, fd, size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+    close(fd);
+    ring->owner = 1;
+
+    ShmRingHeader *h = ring->header;
+    memset(h, 0, sizeof(*h));
+    h->width = width;
+    h->height = height;
+    h->num_slots = num_slots;
+    h->num_readers = num_readers;
+    h->slot_size = slot_size;
+    h->version = SHM_RING_VERSION;
+    ring->next_seq = 1;
+    __atomic_store_n(&h->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int shm_ring_attach(ShmRing *ring, const char *name) {
+    memset(ring, 0, sizeof(*ring));
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmRingHeader) ||
+        map_ring(ring, fd, st.st_size) != 0) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    if (__atomic_load_n(&ring->header->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC ||
+        ring->header->version != SHM_RING_VERSION) {
+        fprintf(stderr, "Anillo %s inválido\n", name);
+        shm_ring_close(ring);
+        return -1;
+    }
+    return 0;
+}
+
+void shm_ring_close(ShmRing *ring) {
+    if (ring->map) munmap(ring->map, ring->map_size);
+    if (ring->owner) shm_unlink(ring->name);
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Seq más viejo que todavía no soltó algún lector
+static uint64_t min_consumed(const ShmRingHeader *h) {
+    uint64_t min = UINT64_MAX;
+    for (uint32_t r = 0; r < h->num_readers; r++) {
+        uint64_t c = __atomic_load_n(&h->consumed[r], __ATOMIC_ACQUIRE);
+        if (c < min) min = c;
+    }
+    return min;
+}
+
+char *shm_ring_begin_write(ShmRing *ring, int t, int timeout_ms) {
+    ShmRingHeader *h = ring->header;
+    uint64_t seq = ring->next_seq;
+    ShmRingSlot *slot = shm_ring_slot(ring, seq);
+
+    // El slot tenía el frame seq - num_slots: esperar a que todos lo suelten
+    if (seq > h->num_slots && h->num_readers > 0) {
+        uint64_t needed = seq - h->num_slots;
+        long long deadline = now_ns() + (long long)timeout_ms * 1000000LL;
+        int waited = 0;
+        for (;;) {
+            uint32_t word = __atomic_load_n(&h->consume_futex, __ATOMIC_ACQUIRE);
+            if (min_consumed(h) >= needed) break;
+            long long left = deadline - now_ns();
+            if (left <= 0) {
+                ring->overwrite_timeouts++;
+                break;
+            }
+            waited = 1;
+            shm_futex_wait(&h->consume_futex, word, (int)(left / 1000000LL) + 1);
+        }
+        ring->overwrite_waits += waited;
+    }
+
+    // seq = 0 mientras se escribe: los lectores que lo vean sabrán que cambió
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    slot->t = t;
+    return shm_ring_cells(slot);
+}
+
+void shm_ring_publish(ShmRing *ring) {
+    ShmRingHeader *h = ring->header;
+    uint64_t seq = ring->next_seq++;
+    ShmRingSlot *slot = shm_ring_slot(ring, seq);
+    slot->publish_ns = now_ns();
+    __atomic_store_n(&slot->seq, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&h->published, seq, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&h->publish_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&h->publish_futex);
+}
+
+void shm_ring_finish(ShmRing *ring) {
+    ShmRingHeader *h = ring->header;
+    __atomic_store_n(&h->closed, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&h->publish_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&h->publish_futex);
+}
+
+uint64_t shm_ring_wait(ShmRing *ring, uint64_t last, int timeout_ms) {
+    ShmRingHeader *h = ring->header;
+    long long deadline = now_ns() + (long long)timeout_ms * 1000000LL;
+    for (;;) {
+        uint32_t word = __atomic_load_n(&h->publish_futex, __ATOMIC_ACQUIRE);
+        uint64_t seq = __atomic_load_n(&h->published, __ATOMIC_ACQUIRE);
+        if (seq > last) return seq;
+        if (__atomic_load_n(&h->closed, __ATOMIC_ACQUIRE)) return 0;
+
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            long long left = deadline - now_ns();
+            if (left <= 0) return 0;
+            wait_ms = (int)(left / 1000000LL) + 1;
+        }
+        shm_futex_wait(&h->publish_futex, word, wait_ms);
+    }
+}
+
+void shm_ring_release(ShmRing *ring, int reader, uint64_t seq) {
+    ShmRingHeader *h = ring->header;
+    if (reader < 0 || (uint32_t)reader >= h->num_readers) return;
+    __atomic_store_n(&h->consumed[reader], seq, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&h->consume_futex, 1, __ATOMIC_RELEASE);
+    shm_futex_wake_all(&h->consume_futex);
+}
+
+int shm_ring_still_valid(const ShmRing *ring, uint64_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&shm_ring_slot(ring, seq)->seq, __ATOMIC_ACQUIRE) == seq;
+}
@@ -0,0 +1,102 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHM_RING_MAGIC       0x4D44524Eu   // "MDRN"
+#define SHM_RING_VERSION     1
+#define SHM_RING_MAX_READERS 64
+#define SHM_RING_DEFAULT_SLOTS 4
+
+/*
+ * Anillo de frames en memoria compartida (shm_open + mmap). El
+ * renderizador pinta directamente en el slot seq % num_slots y publica
+ * con un contador de secuencia (store release); los lectores esperan con
+ * futex, leen su región en el slot sin copiarlo y anotan el último seq
+ * consumido. Antes de reutilizar un slot, el productor espera a que
+ * todos los lectores hayan soltado el frame que lo ocupaba (con timeout:
+ * un lector colgado no frena al resto; el lector detecta la sobrescritura
+ * comparando el seq del slot antes y después de leer).
+ */
+typedef struct {
+    uint32_t magic, version;
+    uint32_t width, height;
+    uint32_t num_slots;
+    uint32_t num_readers;
+    uint64_t slot_size;                       // bytes por slot, con su encabezado
+    uint64_t published;                       // último seq publicado (0 = ninguno)
+    uint32_t publish_futex;                   // cambia en cada publicación
+    uint32_t consume_futex;                   // cambia cuando un lector suelta un frame
+    uint32_t closed;                          // el productor terminó
+    uint32_t pad;
+    uint64_t consumed[SHM_RING_MAX_READERS];  // último seq soltado por cada lector
+} ShmRingHeader;
+
+typedef struct {
+    uint64_t seq;                             // frame que contiene (0 = vacío)
+    int64_t publish_ns;                       // CLOCK_MONOTONIC al publicar
+    int32_t t;                                // tick de la animación
+    uint32_t pad;
+    // siguen width * height celdas
+} ShmRingSlot;
+
+typedef struct {
+    char name[64];
+    int owner;                                // 1 = lo creó este proceso (hace shm_unlink)
+    void *map;
+    size_t map_size;
+    ShmRingHeader *header;
+    uint64_t next_seq;                        // productor: próximo seq a publicar
+    long overwrite_waits, overwrite_timeouts; // productor: esperas por lectores lentos
+} ShmRing;
+
+// Crea el anillo. Retorna 0 o -1.
+int shm_ring_create(ShmRing *ring, const char *name, int width, int height,
+                    int num_slots, int num_readers);
+
+// Abre un anillo existente desde otro proceso. Retorna 0 o -1.
+int shm_ring_attach(ShmRing *ring, const char *name);
+
+void shm_ring_close(ShmRing *ring);
+
+static inline ShmRingSlot *shm_ring_slot(const ShmRing *ring, uint64_t seq) {
+    const ShmRingHeader *h = ring->header;
+    return (ShmRingSlot *)((char *)ring->map + sizeof(ShmRingHeader) +
+                           (size_t)(seq % h->num_slots) * h->slot_size);
+}
+
+static inline char *shm_ring_cells(ShmRingSlot *slot) {
+    return (char *)(slot + 1);
+}
+
+/*
+ * Productor: reserva el slot del próximo frame y retorna sus celdas para
+ * pintar en ellas. Espera como mucho timeout_ms a los lectores atrasados.
+ */
+char *shm_ring_begin_write(ShmRing *ring, int t, int timeout_ms);
+
+// Productor: publica el frame reservado y despierta a los lectores
+void shm_ring_publish(ShmRing *ring);
+
+// Productor: marca el fin de la animación y despierta a los lectores
+void shm_ring_finish(ShmRing *ring);
+
+/*
+ * Lector: espera un seq mayor que last (hasta timeout_ms, -1 = sin
+ * límite) y retorna el más reciente; 0 si se cumplió el timeout o si
+ * el productor terminó sin frames nuevos.
+ */
+uint64_t shm_ring_wait(ShmRing *ring, uint64_t last, int timeout_ms);
+
+// Lector: suelta el frame seq para que el productor pueda reutilizar su slot
+void shm_ring_release(ShmRing *ring, int reader, uint64_t seq);
+
+// Lector: 1 si el slot sigue conteniendo seq (la lectura fue consistente)
+int shm_ring_still_valid(const ShmRing *ring, uint64_t seq);
+
+// Espera/despertar sobre una palabra en memoria compartida entre procesos (futex)
+void shm_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms);
+void shm_futex_wake_all(uint32_t *addr);
+
+#endif // SHM_RING_H
@@ -0,0 +1,225 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "sink_queue.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "frame_clock.h"
+
+SinkPolicy sink_policy_from_string(const char *name) {
+    if (name && strcmp(name, "drop_oldest") == 0) return SINK_POLICY_DROP_OLDEST;
+    if (name && strcmp(name, "block") == 0) return SINK_POLICY_BLOCK;
+    return SINK_POLICY_COALESCE;
+}
+
+static const char *policy_name(SinkPolicy policy) {
+    switch (policy) {
+    case SINK_POLICY_DROP_OLDEST: return "drop_oldest";
+    case SINK_POLICY_BLOCK: return "block";
+    default: return "coalesce";
+    }
+}
+
+int sink_queue_init(SinkQueue *q, int fd, int width, int height, int capacity,
+                    SinkPolicy policy, SinkEncoder encode, int keyframe_interval) {
+    memset(q, 0, sizeof(*q));
+    if (capacity < 1) capacity = SINK_DEFAULT_CAPACITY;
+    size_t size = (size_t)width * height;
+    q->fd = fd;
+    q->width = width;
+    q->height = height;
+    q->policy = policy;
+    q->encode = encode;
+    q->keyframe_interval = keyframe_interval;
+    q->capacity = capacity;
+    q->frames = malloc(size * capacity + 1);
+    q->attrs = malloc(size * capacity + 1);
+    q->colored = malloc(capacity);
+    q->queued_ns = malloc(sizeof(long long) * capacity);
+    q->sent = malloc(size + 1);
+    q->sent_attrs = malloc(size + 1);
+    bytebuf_init(&q->pending);
+    if (!q->frames || !q->attrs || !q->colored || !q->queued_ns || !q->sent || !q->sent_attrs) {
+        sink_queue_free(q);
+        return -1;
+    }
+
+    q->fd_flags = fcntl(fd, F_GETFL);
+    if (q->fd_flags < 0 || fcntl(fd, F_SETFL, q->fd_flags | O_NONBLOCK) < 0) {
+        sink_queue_free(q);
+        return -1;
+    }
+    q->nonblocking = 1;
+    return 0;
+}
+
+static int slot_index(const SinkQueue *q, int k) {
+    return (q->head + k) % q->capacity;
+}
+
+static char *slot(const SinkQueue *q, int k) {
+    return q->frames + (size_t)slot_index(q, k) * q->width * q->height;
+}
+
+static unsigned char *slot_attrs(const SinkQueue *q, int k) {
+    return q->attrs + (size_t)slot_index(q, k) * q->width * q->height;
+}
+
+// Copia el frame al lugar k de la cola; sin atributos el plano queda en cero
+static void copy_frame(SinkQueue *q, int k, const char *cells, const unsigned char *attrs,
+                       int stride) {
+    char *dst = slot(q, k);
+    unsigned char *dst_attrs = slot_attrs(q, k);
+    for (int y = 0; y < q->height; y++) {
+        memcpy(dst + (size_t)y * q->width, cells + (size_t)y * stride, q->width);
+        if (attrs) memcpy(dst_attrs + (size_t)y * q->width, attrs + (size_t)y * stride, q->width);
+    }
+    if (!attrs) memset(dst_attrs, 0, (size_t)q->width * q->height);
+    q->colored[slot_index(q, k)] = attrs != NULL;
+}
+
+// Espera a que el destino acepte bytes. Retorna 0, o -1 si venció el plazo.
+static int wait_writable(int fd, int timeout_ms) {
+    struct pollfd p = {fd, POLLOUT, 0};
+    for (;;) {
+        int r = poll(&p, 1, timeout_ms);
+        if (r < 0 && errno == EINTR) continue;
+        return r > 0 ? 0 : -1;
+    }
+}
+
+int sink_queue_push(SinkQueue *q, const char *cells, const unsigned char *attrs, int stride) {
+    if (q->failed) return -1;
+    q->pushed++;
+
+    if (q->policy == SINK_POLICY_COALESCE && q->count > 0) {
+        // El destino está atrasado: el frame en espera pasa a ser el nuevo
+        copy_frame(q, q->count - 1, cells, attrs, stride);
+        q->coalesced++;
+        return 0;
+    }
+    if (q->count == q->capacity) {
+        if (q->policy == SINK_POLICY_BLOCK) {
+            q->blocked++;
+            while (q->count == q->capacity) {
+                if (sink_queue_pump(q) < 0) return -1;
+                if (q->count == q->capacity) wait_writable(q->fd, -1);
+            }
+        } else {
+            q->head = (q->head + 1) % q->capacity;
+            q->count--;
+            q->dropped++;
+        }
+    }
+    copy_frame(q, q->count, cells, attrs, stride);
+    q->queued_ns[(q->head + q->count) % q->capacity] = frame_clock_now_ns();
+    q->count++;
+    return 0;
+}
+
+int sink_queue_pump(SinkQueue *q) {
+    if (q->failed) return -1;
+    for (;;) {
+        while (q->pending_off < q->pending.len) {
+            long long start = frame_clock_now_ns();
+            ssize_t n = write(q->fd, q->pending.data + q->pending_off,
+                              q->pending.len - q->pending_off);
+            q->write_ns += frame_clock_now_ns() - start;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+                q->failed = 1;
+                return -1;
+            }
+            q->pending_off += n;
+        }
+        if (q->pending.len > 0) {
+            // Frame entregado: lag desde que se encoló
+            long long lag = frame_clock_now_ns() - q->pending_ns;
+            q->lag_sum_ns += lag;
+            if (lag > q->lag_max_ns) q->lag_max_ns = lag;
+            q->bytes += q->pending.len;
+            q->sent_frames++;
+            bytebuf_reset(&q->pending);
+            q->pending_off = 0;
+        }
+        if (q->count == 0) return 0;
+
+        const char *cur = slot(q, 0);
+        const unsigned char *cur_attrs = slot_attrs(q, 0);
+        int keyframe = !q->has_sent ||
+                       (q->keyframe_interval > 0 && q->sent_frames % q->keyframe_interval == 0);
+        long long start = frame_clock_now_ns();
+        if (q->encode(keyframe ? NULL : q->sent, q->sent_attrs, cur,
+                      q->colored[q->head] ? cur_attrs : NULL, q->width, q->height,
+                      (unsigned long)q->sent_frames + 1, &q->pending) != 0) {
+            q->failed = 1;
+            return -1;
+        }
+        q->encode_ns += frame_clock_now_ns() - start;
+        memcpy(q->sent, cur, (size_t)q->width * q->height);
+        memcpy(q->sent_attrs, cur_attrs, (size_t)q->width * q->height);
+        q->has_sent = 1;
+        q->pending_ns = q->queued_ns[q->head];
+        q->head = (q->head + 1) % q->capacity;
+        q->count--;
+    }
+}
+
+int sink_queue_flush(SinkQueue *q, int timeout_ms) {
+    long long deadline = frame_clock_now_ns() + (long long)timeout_ms * 1000000LL;
+    int r;
+    while ((r = sink_queue_pump(q)) == 1) {
+        long long left = deadline - frame_clock_now_ns();
+        if (left <= 0 || wait_writable(q->fd, (int)(left / 1000000LL) + 1) != 0) break;
+    }
+    if (r == 0) return 0;
+    // El destino no respondió a tiempo: lo encolado se pierde
+    q->dropped += q->count;
+    q->count = 0;
+    return -1;
+}
+
+void sink_queue_free(SinkQueue *q) {
+    if (q->nonblocking) fcntl(q->fd, F_SETFL, q->fd_flags);
+    q->nonblocking = 0;
+    free(q->frames);
+    free(q->attrs);
+    free(q->colored);
+    free(q->queued_ns);
+    free(q->sent);
+    free(q->sent_attrs);
+    bytebuf_free(&q->pending);
+    q->frames = q->sent = NULL;
+    q->attrs = q->sent_attrs = q->colored = NULL;
+    q->queued_ns = NULL;
+    q->count = 0;
+}
+
+void sink_queue_report(const SinkQueue *q, const char *name, FILE *out) {
+    fprintf(out, "[SINK %s] %s | %ld encolados, %ld enviados, %ld descartados, %ld fusionados, "
+            "%ld esperas | lag medio %.2f ms, máximo %.2f ms | %lld bytes%s\n",
+            name, policy_name(q->policy), q->pushed, q->sent_frames, q->dropped, q->coalesced,
+            q->blocked, q->sent_frames ? q->lag_sum_ns / 1e6 / q->sent_frames : 0.0,
+            q->lag_max_ns / 1e6, q->bytes, q->failed ? " | desconectado" : "");
+}
+
+int sink_encode_full(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                     const unsigned char *cur_attrs, int width, int height,
+                     unsigned long seq, ByteBuffer *out) {
+    (void)prev;
+    (void)prev_attrs;
+    (void)seq;
+    return encode_full_frame_attr(cur, cur_attrs, width, height, out);
+}
+
+int sink_encode_delta(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                      const unsigned char *cur_attrs, int width, int height,
+                      unsigned long seq, ByteBuffer *out) {
+    (void)seq;
+    if (!prev) return encode_full_frame_attr(cur, cur_attrs, width, height, out);
+    return encode_delta_frame_attr(prev, prev_attrs, cur, cur_attrs, width, height, out);
+}
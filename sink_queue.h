@@ -0,0 +1,109 @@
+#ifndef SINK_QUEUE_H
+#define SINK_QUEUE_H
+
+#include <stdio.h>
+#include "frame_encoder.h"
+
+/*
+ * Cola acotada de frames por destino (terminal, pipe o socket de un
+ * display). El productor encola una copia del canvas y sigue; el envío
+ * escribe sin bloquear lo que el destino acepta y codifica cada frame
+ * recién al sacarlo de la cola, contra el último que realmente salió, así
+ * que descartar o fusionar frames nunca deja un delta inválido.
+ *
+ * Cuando el destino se atrasa decide la política:
+ *   DROP_OLDEST → con la cola llena se descarta el frame más viejo
+ *   COALESCE    → si hay algo esperando, el frame nuevo lo reemplaza
+ *                 (el destino salta directo al estado más reciente)
+ *   BLOCK       → con la cola llena el productor espera al destino
+ */
+typedef enum {
+    SINK_POLICY_DROP_OLDEST,
+    SINK_POLICY_COALESCE,
+    SINK_POLICY_BLOCK
+} SinkPolicy;
+
+#define SINK_DEFAULT_CAPACITY 8
+
+// Espera máxima por un destino atrasado al terminar la animación
+#define SINK_FLUSH_TIMEOUT_MS 2000
+
+/*
+ * Codifica cur para el destino. prev es el último frame enviado, o NULL
+ * cuando corresponde un frame completo; seq numera los frames enviados
+ * desde 1. cur_attrs es el plano de atributos de cur (NULL = monocromo)
+ * y prev_attrs el de prev (en cero si prev era monocromo). Retorna 0 o -1.
+ */
+typedef int (*SinkEncoder)(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                           const unsigned char *cur_attrs, int width, int height,
+                           unsigned long seq, ByteBuffer *out);
+
+typedef struct {
+    int fd;
+    int fd_flags;                 // flags originales, se restauran al liberar
+    int nonblocking;              // 1 = este módulo puso O_NONBLOCK
+    int width, height;
+    SinkPolicy policy;
+    SinkEncoder encode;
+    int keyframe_interval;        // frame completo cada tantos envíos (0 = solo el primero)
+
+    int capacity;
+    char *frames;                 // capacity copias de width * height celdas
+    unsigned char *attrs;         // plano de atributos de cada copia
+    unsigned char *colored;       // 1 si la copia trae atributos
+    long long *queued_ns;         // instante en que se encoló cada una
+    int head, count;
+
+    char *sent;                   // último frame que salió (base del delta)
+    unsigned char *sent_attrs;
+    int has_sent;
+    ByteBuffer pending;           // frame codificado que se está escribiendo
+    size_t pending_off;
+    long long pending_ns;
+    int failed;                   // el destino se cerró o dio error
+
+    long pushed, sent_frames, dropped, coalesced, blocked;
+    long long bytes, lag_sum_ns, lag_max_ns;
+    long long encode_ns, write_ns;     // tiempo acumulado codificando y en write (--stats)
+} SinkQueue;
+
+// Acepta "drop_oldest", "coalesce" (por defecto) y "block"
+SinkPolicy sink_policy_from_string(const char *name);
+
+// Pone fd en modo no bloqueante. Retorna 0 o -1.
+int sink_queue_init(SinkQueue *q, int fd, int width, int height, int capacity,
+                    SinkPolicy policy, SinkEncoder encode, int keyframe_interval);
+
+/*
+ * Encola una copia de cells y de su plano de atributos attrs (filas
+ * separadas por stride bytes; attrs NULL = monocromo) según la política.
+ * Solo BLOCK puede esperar. Retorna 0 o -1 si el destino falló.
+ */
+int sink_queue_push(SinkQueue *q, const char *cells, const unsigned char *attrs, int stride);
+
+/*
+ * Escribe lo que el destino acepte sin bloquear. Retorna 1 si quedan
+ * frames pendientes, 0 si la cola quedó vacía y -1 si el destino falló.
+ */
+int sink_queue_pump(SinkQueue *q);
+
+/*
+ * Vacía la cola esperando al destino hasta timeout_ms; lo que no alcance
+ * a salir cuenta como descartado. Retorna 0 o -1.
+ */
+int sink_queue_flush(SinkQueue *q, int timeout_ms);
+
+// Restaura los flags del descriptor (no lo cierra) y libera la cola
+void sink_queue_free(SinkQueue *q);
+
+void sink_queue_report(const SinkQueue *q, const char *name, FILE *out);
+
+// Codificadores listos: repintada completa siempre, o delta ANSI sobre prev
+int sink_encode_full(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                     const unsigned char *cur_attrs, int width, int height,
+                     unsigned long seq, ByteBuffer *out);
+int sink_encode_delta(const char *prev, const unsigned char *prev_attrs, const char *cur,
+                      const unsigned char *cur_attrs, int width, int height,
+                      unsigned long seq, ByteBuffer *out);
+
+#endif // SINK_QUEUE_H
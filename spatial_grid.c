@@ -0,0 +1,162 @@
+#include "spatial_grid.h"
+#include <stdlib.h>
+#include <string.h>
+#include "scene.h"
+
+int rect_intersects(Rect a, Rect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+int grid_init(SpatialGrid *g, int width, int height, int cell_size, int max_figures) {
+    if (!g || width <= 0 || height <= 0 || max_figures < 0) return -1;
+    memset(g, 0, sizeof(*g));
+    g->cell_size = cell_size > 0 ? cell_size : GRID_CELL_SIZE;
+    g->width = width;
+    g->height = height;
+    for (;;) {
+        g->cols = (width + g->cell_size - 1) / g->cell_size;
+        g->rows = (height + g->cell_size - 1) / g->cell_size;
+        if ((long long)g->cols * g->rows <= GRID_MAX_CELLS) break;
+        g->cell_size *= 2;
+    }
+    g->max_figures = max_figures;
+
+    g->cell_head = malloc(sizeof(int) * g->cols * g->rows);
+    g->bounds = malloc(sizeof(Rect) * (max_figures > 0 ? max_figures : 1));
+    g->stamp = calloc(max_figures > 0 ? max_figures : 1, sizeof(unsigned));
+    g->cap_nodes = max_figures > 0 ? max_figures * 4 : 4;
+    g->node_next = malloc(sizeof(int) * g->cap_nodes);
+    g->node_figure = malloc(sizeof(int) * g->cap_nodes);
+    g->node_cell = malloc(sizeof(int) * g->cap_nodes);
+    if (!g->cell_head || !g->bounds || !g->stamp || !g->node_next || !g->node_figure ||
+        !g->node_cell) {
+        grid_free(g);
+        return -1;
+    }
+    for (int i = 0; i < g->cols * g->rows; i++) g->cell_head[i] = -1;
+    return 0;
+}
+
+int grid_reserve(SpatialGrid *g, int max_figures) {
+    if (max_figures <= g->max_figures) return 0;
+    Rect *bounds = realloc(g->bounds, sizeof(Rect) * max_figures);
+    if (!bounds) return -1;
+    g->bounds = bounds;
+    unsigned *stamp = realloc(g->stamp, sizeof(unsigned) * max_figures);
+    if (!stamp) return -1;
+    memset(stamp + g->max_figures, 0, sizeof(unsigned) * (max_figures - g->max_figures));
+    g->stamp = stamp;
+    g->max_figures = max_figures;
+    return 0;
+}
+
+void grid_clear(SpatialGrid *g) {
+    for (int n = 0; n < g->num_nodes; n++) g->cell_head[g->node_cell[n]] = -1;
+    g->num_nodes = 0;
+    g->num_inserted = 0;
+}
+
+static int grow_nodes(SpatialGrid *g) {
+    int cap = g->cap_nodes * 2;
+    int *next = realloc(g->node_next, sizeof(int) * cap);
+    if (!next) return -1;
+    g->node_next = next;
+    int *fig = realloc(g->node_figure, sizeof(int) * cap);
+    if (!fig) return -1;
+    g->node_figure = fig;
+    int *cell = realloc(g->node_cell, sizeof(int) * cap);
+    if (!cell) return -1;
+    g->node_cell = cell;
+    g->cap_nodes = cap;
+    return 0;
+}
+
+int grid_insert(SpatialGrid *g, int id, Rect r) {
+    if (id < 0 || id >= g->max_figures) return -1;
+    Rect area = {0, 0, g->width, g->height};
+    if (r.w <= 0 || r.h <= 0 || !rect_intersects(r, area)) return 0;  // fuera del mundo
+
+    g->bounds[id] = r;
+    g->num_inserted++;
+
+    int cx0 = (r.x < 0 ? 0 : r.x) / g->cell_size;
+    int cy0 = (r.y < 0 ? 0 : r.y) / g->cell_size;
+    int cx1 = (r.x + r.w - 1 >= g->width ? g->width - 1 : r.x + r.w - 1) / g->cell_size;
+    int cy1 = (r.y + r.h - 1 >= g->height ? g->height - 1 : r.y + r.h - 1) / g->cell_size;
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            if (g->num_nodes == g->cap_nodes && grow_nodes(g) != 0) return -1;
+            int n = g->num_nodes++;
+            int cell = cy * g->cols + cx;
+            g->node_figure[n] = id;
+            g->node_cell[n] = cell;
+            g->node_next[n] = g->cell_head[cell];
+            g->cell_head[cell] = n;
+        }
+    }
+    return 0;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+int grid_query(SpatialGrid *g, Rect r, int *out, int max_out) {
+    Rect area = {0, 0, g->width, g->height};
+    if (r.w <= 0 || r.h <= 0 || !rect_intersects(r, area)) return 0;
+
+    // Nueva marca; si da la vuelta, limpiar las marcas viejas
+    if (++g->query_id == 0) {
+        memset(g->stamp, 0, sizeof(unsigned) * g->max_figures);
+        g->query_id = 1;
+    }
+
+    int cx0 = (r.x < 0 ? 0 : r.x) / g->cell_size;
+    int cy0 = (r.y < 0 ? 0 : r.y) / g->cell_size;
+    int cx1 = (r.x + r.w - 1 >= g->width ? g->width - 1 : r.x + r.w - 1) / g->cell_size;
+    int cy1 = (r.y + r.h - 1 >= g->height ? g->height - 1 : r.y + r.h - 1) / g->cell_size;
+
+    int count = 0;
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            for (int n = g->cell_head[cy * g->cols + cx]; n != -1; n = g->node_next[n]) {
+                int id = g->node_figure[n];
+                if (g->stamp[id] == g->query_id) continue;
+                g->stamp[id] = g->query_id;
+                if (count < max_out && rect_intersects(g->bounds[id], r)) {
+                    out[count++] = id;
+                }
+            }
+        }
+    }
+
+    // El orden de pintado depende del índice de la figura
+    qsort(out, count, sizeof(int), cmp_int);
+    return count;
+}
+
+void grid_build(SpatialGrid *g, const AnimationConfig *config, const TrajectoryState *st) {
+    const Scene *s = config->scene;
+    int t = st->t;
+    grid_clear(g);
+    for (int i = 0; i < s->num_figures && i < g->max_figures; i++) {
+        if (t < s->t_start[i] || t > s->t_end[i]) continue;
+
+        Rect r = {st->x[i], st->y[i], s->cols[i], s->rows[i]};
+        grid_insert(g, i, r);
+    }
+}
+
+void grid_free(SpatialGrid *g) {
+    if (!g) return;
+    free(g->cell_head);
+    free(g->node_next);
+    free(g->node_figure);
+    free(g->node_cell);
+    free(g->bounds);
+    free(g->stamp);
+    memset(g, 0, sizeof(*g));
+}
@@ -0,0 +1,72 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "anim_config.h"
+#include "trajectory.h"
+
+// Tamaño por defecto (en celdas del canvas) de cada casilla de la rejilla
+#define GRID_CELL_SIZE 8
+
+// Casillas como máximo: en mundos enormes la casilla se agranda hasta caber
+#define GRID_MAX_CELLS (1 << 20)
+
+typedef struct {
+    int x, y, w, h;
+} Rect;
+
+/*
+ * Rejilla uniforme sobre el mundo. Cada casilla guarda una lista enlazada
+ * (por índices) de las figuras cuyo bounding box la toca. Se reconstruye en
+ * cada tick a partir de las posiciones interpoladas; una consulta solo
+ * recorre las casillas que cubre el rectángulo pedido, y vaciarla solo
+ * toca las casillas ocupadas, así que un mundo grande y vacío no cuesta.
+ */
+typedef struct {
+    int cell_size;
+    int cols, rows;          // casillas de la rejilla
+    int width, height;       // área cubierta (el mundo)
+
+    int *cell_head;          // primer nodo de cada casilla (-1 = vacía)
+    int *node_next;          // siguiente nodo de la misma casilla
+    int *node_figure;        // figura a la que apunta cada nodo
+    int *node_cell;          // casilla de cada nodo (para vaciar solo las ocupadas)
+    int num_nodes, cap_nodes;
+    int num_inserted;        // figuras insertadas desde el último clear
+
+    int max_figures;
+    Rect *bounds;            // bounding box de cada figura insertada
+    unsigned *stamp;         // marca por figura para no repetirla en una consulta
+    unsigned query_id;
+} SpatialGrid;
+
+/*
+ * Reserva la rejilla para un área width x height, con casillas de
+ * cell_size (o más, si no caben en GRID_MAX_CELLS). Retorna 0 en éxito,
+ * -1 si falla.
+ */
+int grid_init(SpatialGrid *g, int width, int height, int cell_size, int max_figures);
+
+// Admite hasta max_figures figuras (si la escena creció). Retorna 0 o -1.
+int grid_reserve(SpatialGrid *g, int max_figures);
+
+// Vacía la rejilla sin liberar memoria
+void grid_clear(SpatialGrid *g);
+
+// Inserta la figura id con el rectángulo r (recortado al área). Retorna 0 o -1.
+int grid_insert(SpatialGrid *g, int id, Rect r);
+
+/*
+ * Escribe en out (en orden ascendente de id, sin repetir) las figuras cuyo
+ * bounding box intersecta r. Retorna cuántas se escribieron (máx. max_out).
+ */
+int grid_query(SpatialGrid *g, Rect r, int *out, int max_out);
+
+// Reconstruye la rejilla con las figuras activas en el tick del cursor st
+void grid_build(SpatialGrid *g, const AnimationConfig *config, const TrajectoryState *st);
+
+void grid_free(SpatialGrid *g);
+
+// Retorna 1 si los rectángulos se intersectan
+int rect_intersects(Rect a, Rect b);
+
+#endif // SPATIAL_GRID_H
@@ -0,0 +1,105 @@
+#include "sprite_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int block_size(int rows, int cols) {
+    return rows * (cols + 1);
+}
+
+unsigned sprite_hash(const char *data, int rows, int cols) {
+    unsigned h = 2166136261u;
+    int dims[2] = {rows, cols};
+    const unsigned char *p = (const unsigned char *)dims;
+    for (size_t i = 0; i < sizeof(dims); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    int size = block_size(rows, cols);
+    for (int i = 0; i < size; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int sprite_table_init(SpriteTable *t) {
+    memset(t, 0, sizeof(*t));
+    t->num_buckets = 64;
+    t->buckets = malloc(sizeof(int) * t->num_buckets);
+    if (!t->buckets) return -1;
+    for (int i = 0; i < t->num_buckets; i++) t->buckets[i] = -1;
+    return 0;
+}
+
+void sprite_table_free(SpriteTable *t) {
+    if (!t) return;
+    free(t->sprites);
+    free(t->buckets);
+    memset(t, 0, sizeof(*t));
+}
+
+int sprite_find(const SpriteTable *t, const char *atlas, const char *data,
+                int rows, int cols, unsigned hash) {
+    unsigned mask = t->num_buckets - 1;
+    for (unsigned b = hash & mask; t->buckets[b] != -1; b = (b + 1) & mask) {
+        const Sprite *sp = &t->sprites[t->buckets[b]];
+        if (sp->hash == hash && sp->rows == rows && sp->cols == cols &&
+            memcmp(atlas + sp->offset, data, block_size(rows, cols)) == 0) {
+            return t->buckets[b];
+        }
+    }
+    return -1;
+}
+
+static void insert_bucket(SpriteTable *t, int id) {
+    unsigned mask = t->num_buckets - 1;
+    unsigned b = t->sprites[id].hash & mask;
+    while (t->buckets[b] != -1) b = (b + 1) & mask;
+    t->buckets[b] = id;
+}
+
+static int grow_buckets(SpriteTable *t) {
+    int n = t->num_buckets * 2;
+    int *buckets = malloc(sizeof(int) * n);
+    if (!buckets) return -1;
+    for (int i = 0; i < n; i++) buckets[i] = -1;
+    free(t->buckets);
+    t->buckets = buckets;
+    t->num_buckets = n;
+    for (int id = 0; id < t->num_sprites; id++) insert_bucket(t, id);
+    return 0;
+}
+
+int sprite_add(SpriteTable *t, unsigned hash, int offset, int rows, int cols) {
+    if (t->num_sprites == t->cap_sprites) {
+        int cap = t->cap_sprites ? t->cap_sprites * 2 : 64;
+        Sprite *sprites = realloc(t->sprites, sizeof(Sprite) * cap);
+        if (!sprites) return -1;
+        t->sprites = sprites;
+        t->cap_sprites = cap;
+    }
+    // Factor de carga máximo 1/2 para que el sondeo lineal sea corto
+    if ((t->num_sprites + 1) * 2 > t->num_buckets && grow_buckets(t) != 0) return -1;
+
+    int id = t->num_sprites++;
+    Sprite *sp = &t->sprites[id];
+    sp->hash = hash;
+    sp->offset = offset;
+    sp->rows = rows;
+    sp->cols = cols;
+    sp->refcount = 1;
+    t->live_bytes += block_size(rows, cols);
+    insert_bucket(t, id);
+    return id;
+}
+
+void sprite_retain(SpriteTable *t, int id) {
+    Sprite *sp = &t->sprites[id];
+    if (sp->refcount++ == 0) t->live_bytes += block_size(sp->rows, sp->cols);
+}
+
+void sprite_release(SpriteTable *t, int id) {
+    Sprite *sp = &t->sprites[id];
+    if (sp->refcount <= 0) return;
+    if (--sp->refcount == 0) t->live_bytes -= block_size(sp->rows, sp->cols);
+}
@@ -0,0 +1,41 @@
+#ifndef SPRITE_TABLE_H
+#define SPRITE_TABLE_H
+
+/*
+ * Tabla de sprites internados por contenido. Cada sprite es un bloque
+ * rows * (cols + 1) bytes guardado una sola vez en un buffer externo
+ * (el atlas de la escena); la tabla solo conoce su offset. Los bloques
+ * idénticos comparten entrada y se cuentan con refcount.
+ */
+typedef struct {
+    unsigned hash;
+    int offset;              // posición del bloque en el atlas
+    int rows, cols;
+    int refcount;            // 0 = sin usuarios (se reactiva si vuelve a aparecer)
+} Sprite;
+
+typedef struct {
+    Sprite *sprites;
+    int num_sprites, cap_sprites;
+    int *buckets;            // índice de sprite por casilla (-1 = libre)
+    int num_buckets;         // potencia de 2
+    int live_bytes;          // bytes de sprites con refcount > 0
+} SpriteTable;
+
+// FNV-1a sobre las dimensiones y el contenido del bloque
+unsigned sprite_hash(const char *data, int rows, int cols);
+
+int sprite_table_init(SpriteTable *t);
+void sprite_table_free(SpriteTable *t);
+
+// Busca un bloque idéntico a data; retorna su id o -1
+int sprite_find(const SpriteTable *t, const char *atlas, const char *data,
+                int rows, int cols, unsigned hash);
+
+// Registra un bloque ya copiado al atlas (refcount = 1). Retorna el id o -1.
+int sprite_add(SpriteTable *t, unsigned hash, int offset, int rows, int cols);
+
+void sprite_retain(SpriteTable *t, int id);
+void sprite_release(SpriteTable *t, int id);
+
+#endif // SPRITE_TABLE_H
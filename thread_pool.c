@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct ThreadPool {
+    pthread_t threads[THREAD_POOL_MAX_THREADS];
+    int num_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t work;             // hay trozos para tomar o hay que salir
+    pthread_cond_t done;             // el trabajo terminó
+
+    // Trabajo en curso (protegido por lock)
+    ThreadPoolTask fn;
+    void *ctx;
+    int n, chunk;
+    int next;                        // primer índice sin tomar
+    int finished;                    // índices ya procesados
+    int active;
+    int stop;
+};
+
+// Toma y procesa trozos hasta que no queden; se llama con lock tomado
+static void drain(ThreadPool *pool) {
+    while (pool->active && pool->next < pool->n) {
+        int begin = pool->next;
+        int end = begin + pool->chunk < pool->n ? begin + pool->chunk : pool->n;
+        pool->next = end;
+        ThreadPoolTask fn = pool->fn;
+        void *ctx = pool->ctx;
+
+        pthread_mutex_unlock(&pool->lock);
+        fn(ctx, begin, end);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->finished += end - begin;
+        if (pool->finished == pool->n) {
+            pool->active = 0;
+            pthread_cond_broadcast(&pool->done);
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    ThreadPool *pool = arg;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        if (pool->active && pool->next < pool->n) {
+            drain(pool);
+        } else {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool *thread_pool_create(int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > THREAD_POOL_MAX_THREADS) threads = THREAD_POOL_MAX_THREADS;
+    if (threads <= 1) return NULL;
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (int k = 0; k < threads; k++) {
+        if (pthread_create(&pool->threads[k], NULL, worker_main, pool) != 0) break;
+        pool->num_threads++;
+    }
+    if (pool->num_threads == 0) {
+        thread_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) {
+    if (!pool) return;
+    thread_pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int k = 0; k < pool->num_threads; k++) pthread_join(pool->threads[k], NULL);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int thread_pool_size(const ThreadPool *pool) {
+    return pool ? pool->num_threads : 1;
+}
+
+void thread_pool_start(ThreadPool *pool, ThreadPoolTask fn, void *ctx, int n, int chunk) {
+    if (n <= 0) return;
+    if (chunk <= 0) chunk = 1;
+    if (!pool) {
+        fn(ctx, 0, n);
+        return;
+    }
+    thread_pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->n = n;
+    pool->chunk = chunk;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->active = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_wait(ThreadPool *pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask fn, void *ctx, int n, int chunk) {
+    thread_pool_start(pool, fn, ctx, n, chunk);
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    drain(pool);
+    while (pool->active) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
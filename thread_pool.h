@@ -0,0 +1,33 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/*
+ * Pool de hilos POSIX para el preprocesamiento de la carga. Corre un
+ * trabajo a la vez: el rango [0, n) se reparte en trozos de chunk índices
+ * que los hilos toman en orden. El resultado no puede depender de qué
+ * hilo procesa cada trozo; lo que necesite orden se hace después en el
+ * hilo que llama. Con un pool NULL o de un solo hilo todo corre en línea.
+ */
+#define THREAD_POOL_MAX_THREADS 64
+
+typedef void (*ThreadPoolTask)(void *ctx, int begin, int end);
+
+typedef struct ThreadPool ThreadPool;
+
+// threads <= 0 usa los procesadores en línea. NULL si no hace falta pool (1 hilo) o falla.
+ThreadPool *thread_pool_create(int threads);
+void thread_pool_destroy(ThreadPool *pool);
+
+// Hilos que procesan trabajos (1 para un pool NULL)
+int thread_pool_size(const ThreadPool *pool);
+
+// Lanza el trabajo sin esperarlo; el hilo que llama sigue con lo suyo
+void thread_pool_start(ThreadPool *pool, ThreadPoolTask fn, void *ctx, int n, int chunk);
+
+// Espera que termine el trabajo lanzado (no hace nada si no hay ninguno)
+void thread_pool_wait(ThreadPool *pool);
+
+// start + wait, con el hilo que llama tomando trozos también
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask fn, void *ctx, int n, int chunk);
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,292 @@
+#include "trajectory.h"
+#include <stdlib.h>
+#include <string.h>
+#include "anim_utils.h"
+
+static int iabs(int v) { return v < 0 ? -v : v; }
+
+Trajectory *trajectory_alloc(const AnimationConfig *config) {
+    Trajectory *tr = calloc(1, sizeof(Trajectory));
+    if (!tr) return NULL;
+    int nf = config->num_figures;
+    tr->num_figures = nf;
+
+    size_t nfs = nf > 0 ? nf : 1;
+    tr->key_start = malloc(sizeof(int) * nfs);
+    tr->key_count = malloc(sizeof(int) * nfs);
+    if (!tr->key_start || !tr->key_count) {
+        trajectory_free(tr);
+        return NULL;
+    }
+
+    int total = 0;
+    for (int i = 0; i < nf; i++) {
+        const Figure *f = &config->figures[i];
+        tr->key_start[i] = total;
+        tr->key_count[i] = (f->path && f->num_keyframes > 0) ? f->num_keyframes : 2;
+        total += tr->key_count[i];
+    }
+    tr->num_keys = total;
+
+    size_t nk = total > 0 ? total : 1;
+    tr->keys = malloc(sizeof(Keyframe) * nk);
+    tr->step_qx = malloc(sizeof(int) * nk);
+    tr->step_rx = malloc(sizeof(int) * nk);
+    tr->step_qy = malloc(sizeof(int) * nk);
+    tr->step_ry = malloc(sizeof(int) * nk);
+    tr->sign_x = malloc(sizeof(int) * nk);
+    tr->sign_y = malloc(sizeof(int) * nk);
+    tr->span = malloc(sizeof(int) * nk);
+    if (!tr->keys || !tr->step_qx || !tr->step_rx || !tr->step_qy || !tr->step_ry ||
+        !tr->sign_x || !tr->sign_y || !tr->span) {
+        trajectory_free(tr);
+        return NULL;
+    }
+    return tr;
+}
+
+void trajectory_fill(Trajectory *tr, const AnimationConfig *config, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const Figure *f = &config->figures[i];
+        int k = tr->key_start[i];
+        if (f->path && f->num_keyframes > 0) {
+            // Inserción estable por tiempo: el orden del archivo decide empates
+            for (int j = 0; j < f->num_keyframes; j++) {
+                Keyframe kf = f->path[j];
+                int p = k + j;
+                while (p > k && tr->keys[p - 1].t > kf.t) {
+                    tr->keys[p] = tr->keys[p - 1];
+                    p--;
+                }
+                tr->keys[p] = kf;
+            }
+        } else {
+            tr->keys[k].t = f->t_start;
+            tr->keys[k].pos = f->pos0;
+            tr->keys[k + 1].t = f->t_end;
+            tr->keys[k + 1].pos = f->pos1;
+        }
+
+        int last = k + tr->key_count[i] - 1;
+        for (int j = k; j <= last; j++) {
+            int n = (j < last) ? tr->keys[j + 1].t - tr->keys[j].t : 0;
+            if (n <= 0) {
+                // Segmento vacío (o último keyframe): nunca avanza
+                tr->span[j] = 1;
+                tr->step_qx[j] = tr->step_rx[j] = 0;
+                tr->step_qy[j] = tr->step_ry[j] = 0;
+                tr->sign_x[j] = tr->sign_y[j] = 1;
+                continue;
+            }
+            int dx = tr->keys[j + 1].pos.x - tr->keys[j].pos.x;
+            int dy = tr->keys[j + 1].pos.y - tr->keys[j].pos.y;
+            tr->span[j] = n;
+            tr->sign_x[j] = dx < 0 ? -1 : 1;
+            tr->sign_y[j] = dy < 0 ? -1 : 1;
+            tr->step_qx[j] = iabs(dx) / n;
+            tr->step_rx[j] = iabs(dx) % n;
+            tr->step_qy[j] = iabs(dy) / n;
+            tr->step_ry[j] = iabs(dy) % n;
+        }
+    }
+}
+
+Trajectory *trajectory_build(const AnimationConfig *config) {
+    Trajectory *tr = trajectory_alloc(config);
+    if (tr) trajectory_fill(tr, config, 0, config->num_figures);
+    return tr;
+}
+
+void trajectory_free(Trajectory *tr) {
+    if (!tr) return;
+    free(tr->key_start);
+    free(tr->key_count);
+    free(tr->keys);
+    free(tr->step_qx);
+    free(tr->step_rx);
+    free(tr->step_qy);
+    free(tr->step_ry);
+    free(tr->sign_x);
+    free(tr->sign_y);
+    free(tr->span);
+    free(tr);
+}
+
+/*
+ * Último keyframe j de la figura con keys[j].t <= t. Se asume que
+ * keys[first].t <= t < keys[last].t.
+ */
+static int find_segment(const Trajectory *tr, int i, int t) {
+    int lo = tr->key_start[i];
+    int hi = lo + tr->key_count[i] - 1;
+    while (hi - lo > 1) {
+        int mid = lo + (hi - lo) / 2;
+        if (tr->keys[mid].t <= t) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+Position trajectory_position_at(const Trajectory *tr, int i, int t) {
+    const Keyframe *first = &tr->keys[tr->key_start[i]];
+    const Keyframe *last = first + tr->key_count[i] - 1;
+    if (t <= first->t) return first->pos;
+    if (t >= last->t) return last->pos;
+
+    int j = find_segment(tr, i, t);
+    return interpolate_position(tr->keys[j].pos, tr->keys[j + 1].pos, t, tr->keys[j].t, tr->keys[j + 1].t);
+}
+
+/*
+ * Ventana de restos donde el float de interpolate_position puede no
+ * coincidir con el cociente exacto de |d| * k / n. alpha y el producto
+ * redondean cada uno con error relativo <= 2^-24, así que el float se
+ * aleja de |d| * k / n menos de |d| * 2^-23; eso cruza un entero solo si
+ * el resto r cumple r < n * |d| * 2^-23 o n - r < n * |d| * 2^-23. Se usa
+ * el doble como margen. Fuera del rango exacto del float, siempre.
+ */
+static int float_window(long long ad, long long n) {
+    if (ad >= (1 << 24) || n >= (1 << 24)) return (int)n + 1;
+    return (int)((ad * n) >> 22) + 1;
+}
+
+// Posición de interpolate_position en los ticks cuyo resto cae en la ventana
+static void float_fix(TrajectoryState *st, int i) {
+    int k = st->t - st->t0[i], n = st->n[i];
+    if (k <= 0 || k >= n) return;  // extremos del segmento: el cociente es exacto
+    float alpha = (float)k / n;
+    if (st->rx[i] < st->wx[i] || n - st->rx[i] < st->wx[i]) {
+        int ad = st->dqx[i] * n + st->drx[i];
+        st->x[i] = st->base_x[i] + st->sx[i] * (int)(ad * alpha);
+    }
+    if (st->ry[i] < st->wy[i] || n - st->ry[i] < st->wy[i]) {
+        int ad = st->dqy[i] * n + st->dry[i];
+        st->y[i] = st->base_y[i] + st->sy[i] * (int)(ad * alpha);
+    }
+}
+
+/*
+ * Carga en el cursor el segmento de la figura i que corresponde al tick t
+ * y calcula directamente el cociente y resto acumulados.
+ */
+static void load_segment(TrajectoryState *st, int i, int t) {
+    const Trajectory *tr = st->table;
+    int first = tr->key_start[i];
+    int last = first + tr->key_count[i] - 1;
+    int j;
+    long long k = 0;
+
+    if (t <= tr->keys[first].t) {
+        j = first;                           // esperando el primer keyframe
+    } else if (t >= tr->keys[last].t) {
+        j = last;                            // trayectoria terminada
+    } else {
+        j = find_segment(tr, i, t);
+        k = t - tr->keys[j].t;
+    }
+
+    st->seg[i] = j;
+    st->t0[i] = tr->keys[j].t;
+    st->t1[i] = (j < last) ? tr->keys[j + 1].t : tr->keys[j].t;
+    st->base_x[i] = tr->keys[j].pos.x;
+    st->base_y[i] = tr->keys[j].pos.y;
+    st->dqx[i] = tr->step_qx[j];
+    st->drx[i] = tr->step_rx[j];
+    st->dqy[i] = tr->step_qy[j];
+    st->dry[i] = tr->step_ry[j];
+    st->sx[i] = tr->sign_x[j];
+    st->sy[i] = tr->sign_y[j];
+    st->n[i] = tr->span[j];
+
+    long long n = st->n[i];
+    long long ax = (long long)st->dqx[i] * n + st->drx[i];
+    long long ay = (long long)st->dqy[i] * n + st->dry[i];
+    st->qx[i] = (int)(ax * k / n);
+    st->rx[i] = (int)(ax * k % n);
+    st->qy[i] = (int)(ay * k / n);
+    st->ry[i] = (int)(ay * k % n);
+    st->wx[i] = float_window(ax, n);
+    st->wy[i] = float_window(ay, n);
+    st->x[i] = st->base_x[i] + st->sx[i] * st->qx[i];
+    st->y[i] = st->base_y[i] + st->sy[i] * st->qy[i];
+    float_fix(st, i);
+}
+
+int trajectory_state_init(TrajectoryState *st, const Trajectory *tr, int t) {
+    memset(st, 0, sizeof(*st));
+    st->table = tr;
+    size_t n = tr->num_figures > 0 ? tr->num_figures : 1;
+    int **fields[] = {
+        &st->x, &st->y, &st->seg, &st->t0, &st->t1, &st->base_x, &st->base_y,
+        &st->qx, &st->rx, &st->qy, &st->ry, &st->dqx, &st->drx, &st->dqy, &st->dry,
+        &st->sx, &st->sy, &st->n, &st->wx, &st->wy
+    };
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        *fields[f] = malloc(sizeof(int) * n);
+        if (!*fields[f]) {
+            trajectory_state_free(st);
+            return -1;
+        }
+    }
+    trajectory_seek(st, t);
+    return 0;
+}
+
+void trajectory_state_free(TrajectoryState *st) {
+    if (!st) return;
+    free(st->x);      free(st->y);      free(st->seg);
+    free(st->t0);     free(st->t1);
+    free(st->base_x); free(st->base_y);
+    free(st->qx);     free(st->rx);     free(st->qy);  free(st->ry);
+    free(st->dqx);    free(st->drx);    free(st->dqy); free(st->dry);
+    free(st->sx);     free(st->sy);     free(st->n);
+    free(st->wx);     free(st->wy);
+    memset(st, 0, sizeof(*st));
+}
+
+void trajectory_seek(TrajectoryState *st, int t) {
+    st->t = t;
+    for (int i = 0; i < st->table->num_figures; i++) {
+        load_segment(st, i, t);
+    }
+}
+
+void trajectory_seek_figure(TrajectoryState *st, int i) {
+    load_segment(st, i, st->t);
+}
+
+void trajectory_step(TrajectoryState *st) {
+    int t = st->t;
+    int nf = st->table->num_figures;
+
+    // Paso DDA de todas las figuras: sin saltos, apto para vectorizar
+    for (int i = 0; i < nf; i++) {
+        int m = (t >= st->t0[i]) & (t < st->t1[i]);
+
+        st->rx[i] += m * st->drx[i];
+        int cx = st->rx[i] >= st->n[i];
+        st->qx[i] += m * st->dqx[i] + cx;
+        st->rx[i] -= cx * st->n[i];
+
+        st->ry[i] += m * st->dry[i];
+        int cy = st->ry[i] >= st->n[i];
+        st->qy[i] += m * st->dqy[i] + cy;
+        st->ry[i] -= cy * st->n[i];
+
+        st->x[i] = st->base_x[i] + st->sx[i] * st->qx[i];
+        st->y[i] = st->base_y[i] + st->sy[i] * st->qy[i];
+    }
+    st->t = t + 1;
+
+    // Cambio de segmento y restos en la ventana del float (poco frecuentes)
+    const Trajectory *tr = st->table;
+    for (int i = 0; i < nf; i++) {
+        int last = tr->key_start[i] + tr->key_count[i] - 1;
+        if (st->t >= st->t1[i] && st->seg[i] < last) {
+            load_segment(st, i, st->t);
+        } else if (st->rx[i] < st->wx[i] || st->n[i] - st->rx[i] < st->wx[i] ||
+                   st->ry[i] < st->wy[i] || st->n[i] - st->ry[i] < st->wy[i]) {
+            float_fix(st, i);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "anim_config.h"
+
+/*
+ * Tabla de trayectorias precalculada al cargar la configuración.
+ * Cada figura tiene uno o más keyframes (t, x, y) guardados de forma
+ * contigua; entre dos keyframes el movimiento es lineal y se avanza con
+ * un DDA entero: por tick se suma |d| / n al cociente y |d| % n al resto,
+ * con acarreo cuando el resto llega a n. El cociente es trunc(d * k / n);
+ * la posición es la de interpolate_position (alpha en float, truncado),
+ * que solo puede diferir de él en uno cuando el resto queda cerca de 0 o
+ * de n. En esos ticks se recalcula con el float.
+ */
+typedef struct Trajectory {
+    int num_figures;
+    int *key_start;          // primer keyframe de cada figura en keys[]
+    int *key_count;          // cantidad de keyframes de cada figura
+    Keyframe *keys;          // todos los keyframes, contiguos
+    int num_keys;
+
+    // Pasos precalculados del segmento que empieza en cada keyframe
+    int *step_qx, *step_rx;  // |dx| / n, |dx| % n
+    int *step_qy, *step_ry;
+    int *sign_x, *sign_y;    // signo de dx, dy
+    int *span;               // n = duración del segmento (>= 1)
+} Trajectory;
+
+/*
+ * Cursor SoA que avanza todas las figuras un tick por llamada.
+ * Los campos del segmento activo se copian aquí para que el paso
+ * sea un único bucle sin saltos sobre arreglos paralelos.
+ */
+typedef struct {
+    const Trajectory *table;
+    int t;                   // tick en el que están las posiciones
+    int *x, *y;              // posición actual de cada figura
+    int *seg;                // keyframe donde empieza el segmento activo
+    int *t0, *t1;            // ventana [t0, t1) en la que el segmento avanza
+    int *base_x, *base_y;    // posición al inicio del segmento
+    int *qx, *rx, *qy, *ry;  // cociente y resto acumulados
+    int *dqx, *drx, *dqy, *dry;
+    int *sx, *sy;
+    int *n;
+    int *wx, *wy;            // restos a menos de w de 0 o de n: posición con el float
+} TrajectoryState;
+
+// Construye la tabla a partir de las figuras (path o pos0/pos1). NULL si falla.
+Trajectory *trajectory_build(const AnimationConfig *config);
+void trajectory_free(Trajectory *tr);
+
+/*
+ * trajectory_build en dos pasos, para repartir las figuras entre hilos:
+ * alloc reserva la tabla y fija key_start/key_count; fill calcula los
+ * keyframes y pasos de las figuras [begin, end), que no se pisan.
+ */
+Trajectory *trajectory_alloc(const AnimationConfig *config);
+void trajectory_fill(Trajectory *tr, const AnimationConfig *config, int begin, int end);
+
+// Posición de la figura i en el tick t, sin estado (búsqueda binaria del segmento)
+Position trajectory_position_at(const Trajectory *tr, int i, int t);
+
+// Reserva el cursor y lo deja en el tick t. Retorna 0 en éxito, -1 si falla.
+int trajectory_state_init(TrajectoryState *st, const Trajectory *tr, int t);
+void trajectory_state_free(TrajectoryState *st);
+
+// Reposiciona todas las figuras en el tick t
+void trajectory_seek(TrajectoryState *st, int t);
+
+// Recarga solo la figura i en el tick del cursor (p. ej. si cambió su trayectoria)
+void trajectory_seek_figure(TrajectoryState *st, int i);
+
+// Avanza todas las figuras del tick t al t + 1
+void trajectory_step(TrajectoryState *st);
+
+#endif // TRAJECTORY_H
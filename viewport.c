@@ -0,0 +1,150 @@
+#include "viewport.h"
+#include <string.h>
+#include "anim_utils.h"
+
+// Cámaras que viewport_grid_build prueba por figura; con más arma la rejilla entera
+#define VIEWPORT_MAX_CULL 16
+
+int viewport_count(const AnimationConfig *config) {
+    return config->num_viewports > 0 ? config->num_viewports : 1;
+}
+
+// Origen de la cámara en el tick t: lineal entre keyframes, quieta fuera de ellos
+static Position pan_origin(const AnimationConfig *config, const Viewport *vp, int t) {
+    if (vp->pan_count == 0) return (Position){vp->x, vp->y};
+    const Keyframe *keys = config->pan_keys + vp->pan_start;
+    int k = 1;
+    while (k < vp->pan_count && keys[k].t <= t) k++;
+    if (k == vp->pan_count) return keys[k - 1].pos;
+    return interpolate_position(keys[k - 1].pos, keys[k].pos, t, keys[k - 1].t, keys[k].t);
+}
+
+void viewport_at(const AnimationConfig *config, int v, int t, Rect *screen, Rect *world) {
+    if (config->num_viewports == 0) {
+        *screen = (Rect){0, 0, config->canvas.width, config->canvas.height};
+        *world = *screen;
+        return;
+    }
+    const Viewport *vp = &config->viewports[v];
+    Position o = pan_origin(config, vp, t);
+    *screen = (Rect){vp->screen_x, vp->screen_y, vp->width, vp->height};
+    *world = (Rect){o.x, o.y, vp->width, vp->height};
+}
+
+void viewport_grid_build(const AnimationConfig *config, SpatialGrid *grid, const TrajectoryState *st) {
+    // La cámara implícita cubre toda la rejilla; con muchas no conviene probarlas por figura
+    int n = config->num_viewports;
+    if (n == 0 || n > VIEWPORT_MAX_CULL) {
+        grid_build(grid, config, st);
+        return;
+    }
+    const Scene *s = config->scene;
+    Rect seen[VIEWPORT_MAX_CULL];
+    for (int v = 0; v < n; v++) {
+        Rect screen;
+        viewport_at(config, v, st->t, &screen, &seen[v]);
+    }
+
+    grid_clear(grid);
+    for (int i = 0; i < s->num_figures && i < grid->max_figures; i++) {
+        if (st->t < s->t_start[i] || st->t > s->t_end[i]) continue;
+
+        Rect r = {st->x[i], st->y[i], s->cols[i], s->rows[i]};
+        for (int v = 0; v < n; v++) {
+            if (rect_intersects(r, seen[v])) {
+                grid_insert(grid, i, r);
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * Sub-buffer de fb (que cubre region) donde dibuja la cámara v, y el
+ * rectángulo del mundo que cae en él. Retorna 0 si la cámara no toca
+ * region. Las cámaras después de la primera limpian su parte: tapan lo
+ * que pintaron las anteriores.
+ */
+static int viewport_begin(const AnimationConfig *config, int v, int t, Rect region,
+                          const FrameBuffer *fb, FrameBuffer *sub, Rect *seen) {
+    Rect screen, world;
+    viewport_at(config, v, t, &screen, &world);
+    int x0 = screen.x > region.x ? screen.x : region.x;
+    int y0 = screen.y > region.y ? screen.y : region.y;
+    int x1 = screen.x + screen.w < region.x + region.w ? screen.x + screen.w : region.x + region.w;
+    int y1 = screen.y + screen.h < region.y + region.h ? screen.y + screen.h : region.y + region.h;
+    if (x1 <= x0 || y1 <= y0) return 0;
+
+    size_t offset = (size_t)(y0 - region.y) * fb->stride + (x0 - region.x);
+    *sub = (FrameBuffer){fb->cells + offset, x1 - x0, y1 - y0, fb->stride,
+                         fb->attrs ? fb->attrs + offset : NULL};
+    *seen = (Rect){world.x + x0 - screen.x, world.y + y0 - screen.y, x1 - x0, y1 - y0};
+    if (v > 0) {
+        for (int r = 0; r < sub->height; r++) {
+            memset(sub->cells + (size_t)r * sub->stride, ' ', sub->width);
+            if (sub->attrs) memset(sub->attrs + (size_t)r * sub->stride, 0, sub->width);
+        }
+    }
+    return 1;
+}
+
+int viewport_paint(const AnimationConfig *config, SpatialGrid *grid, const TrajectoryState *st,
+                   Rect region, FrameBuffer *fb, int *visible, int max_visible, long *painted) {
+    const Scene *scene = config->scene;
+    int drawn = 0;
+    for (int v = 0; v < viewport_count(config); v++) {
+        FrameBuffer sub;
+        Rect seen;
+        if (!viewport_begin(config, v, st->t, region, fb, &sub, &seen)) continue;
+
+        // Solo las figuras que la rejilla ubica dentro de lo que ve la cámara
+        int n = grid_query(grid, seen, visible, max_visible);
+        for (int k = 0; k < n; k++) {
+            int i = visible[k];
+            Position pos = {st->x[i] - seen.x, st->y[i] - seen.y};
+            int cells = render_blit(scene, i, st->t, pos, &sub);
+            if (painted) *painted += cells;
+        }
+        drawn += n;
+    }
+    return drawn;
+}
+
+void viewport_paint_direct(const AnimationConfig *config, int t, FrameBuffer *fb) {
+    const Scene *scene = config->scene;
+    Rect all = {0, 0, fb->width, fb->height};
+    for (int v = 0; v < viewport_count(config); v++) {
+        FrameBuffer sub;
+        Rect seen;
+        if (!viewport_begin(config, v, t, all, fb, &sub, &seen)) continue;
+
+        for (int i = 0; i < scene->num_figures; i++) {
+            if (t < scene->t_start[i] || t > scene->t_end[i]) continue;
+
+            Position pos = trajectory_position_at(config->trajectory, i, t);
+            Rect bounds = {pos.x, pos.y, scene->cols[i], scene->rows[i]};
+            if (!rect_intersects(bounds, seen)) continue;  // fuera de la cámara
+            pos.x -= seen.x;
+            pos.y -= seen.y;
+            render_blit(scene, i, t, pos, &sub);
+        }
+    }
+}
+
+void viewport_normalize(AnimationConfig *config) {
+    if (config->world.width <= 0 || config->world.height <= 0) config->world = config->canvas;
+    for (int v = 0; v < config->num_viewports; v++) {
+        Viewport *vp = &config->viewports[v];
+        if (vp->width <= 0) vp->width = config->canvas.width - vp->screen_x;
+        if (vp->height <= 0) vp->height = config->canvas.height - vp->screen_y;
+
+        // Inserción estable: los pans tienen pocos keyframes
+        Keyframe *keys = config->pan_keys + vp->pan_start;
+        for (int k = 1; k < vp->pan_count; k++) {
+            Keyframe key = keys[k];
+            int j = k;
+            for (; j > 0 && keys[j - 1].t > key.t; j--) keys[j] = keys[j - 1];
+            keys[j] = key;
+        }
+    }
+}
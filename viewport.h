@@ -0,0 +1,57 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+#include "anim_config.h"
+#include "render.h"
+#include "spatial_grid.h"
+#include "trajectory.h"
+
+/*
+ * Cámaras sobre el mundo. Las figuras viven en coordenadas del mundo
+ * (config->world) y cada viewport copia al canvas el rectángulo que ve
+ * en el tick. Sin "viewports" hay una sola cámara implícita quieta en el
+ * origen y del tamaño del canvas, que reproduce el dibujo de siempre.
+ *
+ * Lo visible se pide a la rejilla espacial (armada sobre el mundo), así
+ * que una figura que no toca ninguna cámara no se rasteriza: el costo de
+ * pintar sigue a lo visible y no al tamaño del mundo. Los viewports se
+ * pintan en orden y uno posterior tapa a los anteriores donde se pisan.
+ */
+
+// Cantidad de cámaras (al menos 1, la implícita)
+int viewport_count(const AnimationConfig *config);
+
+/*
+ * Región del canvas (screen) y rectángulo del mundo (world, del mismo
+ * tamaño) que muestra la cámara v en el tick t.
+ */
+void viewport_at(const AnimationConfig *config, int v, int t, Rect *screen, Rect *world);
+
+/*
+ * grid_build con solo las figuras que alguna cámara ve en el tick de st:
+ * las demás ni entran a la rejilla. Vale cuando nadie más la consulta
+ * (sin "collisions", que necesita a todas).
+ */
+void viewport_grid_build(const AnimationConfig *config, SpatialGrid *grid, const TrajectoryState *st);
+
+/*
+ * Pinta en fb, que cubre la región region del canvas, lo que ven las
+ * cámaras en el tick del cursor st. fb ya debe estar limpio; visible es
+ * el arreglo de trabajo para las consultas (max_visible figuras). Con
+ * painted != NULL (--stats) suma ahí las celdas pintadas. Retorna cuántas
+ * figuras se rasterizaron.
+ */
+int viewport_paint(const AnimationConfig *config, SpatialGrid *grid, const TrajectoryState *st,
+                   Rect region, FrameBuffer *fb, int *visible, int max_visible, long *painted);
+
+// Igual sin rejilla (render_paint): prueba cada figura activa en t contra cada cámara
+void viewport_paint_direct(const AnimationConfig *config, int t, FrameBuffer *fb);
+
+/*
+ * Al cargar: el mundo sin tamaño es el canvas, los viewports sin tamaño
+ * llegan hasta el borde del canvas y los keyframes de cada pan se ordenan
+ * por t.
+ */
+void viewport_normalize(AnimationConfig *config);
+
+#endif // VIEWPORT_H